@@ -75,6 +75,35 @@ typedef struct {
     unsigned char data[64];
 } secp256k1_pubkey;
 
+/** Opaque data structure that holds a public key together with precomputed
+ *  tables that speed up verifying many signatures for it.
+ *
+ *  It is created with secp256k1_pubkey_prepared_create and must be destroyed
+ *  with secp256k1_pubkey_prepared_destroy. A prepared public key can be used
+ *  by multiple threads simultaneously.
+ */
+typedef struct secp256k1_pubkey_prepared_struct secp256k1_pubkey_prepared;
+
+/** Opaque data structure that holds precomputed signing nonces together with
+ *  their nonce points, so that signing with them needs no point
+ *  multiplication.
+ *
+ *  It is created with secp256k1_sign_pool_create and must be destroyed with
+ *  secp256k1_sign_pool_destroy. A pool must not be used by multiple threads
+ *  simultaneously.
+ */
+typedef struct secp256k1_sign_pool_struct secp256k1_sign_pool;
+
+/** Opaque data structure that holds a secret key together with the state
+ *  derived from it that signing needs, so that it is not recomputed for every
+ *  signature.
+ *
+ *  It is created with secp256k1_signer_create and must be destroyed with
+ *  secp256k1_signer_destroy, which erases the secret key. A signer is not
+ *  modified by signing and can be used by multiple threads simultaneously.
+ */
+typedef struct secp256k1_signer_struct secp256k1_signer;
+
 /** Opaque data structured that holds a parsed ECDSA signature.
  *
  *  The exact representation of data inside is implementation defined and not
@@ -88,6 +117,19 @@ typedef struct {
     unsigned char data[64];
 } secp256k1_ecdsa_signature;
 
+/** Opaque data structure that holds the SHA256 state after hashing the prefix
+ *  SHA256(tag)||SHA256(tag) of a BIP-340 tagged hash.
+ *
+ *  It contains no secret data and does not need to be destroyed. The exact
+ *  representation of data inside is implementation defined and not guaranteed
+ *  to be portable between different platforms or versions. It is however
+ *  guaranteed to be 32 bytes in size, and can be safely copied/moved.
+ *  Initialize it with secp256k1_tagged_hasher_create.
+ */
+typedef struct {
+    unsigned char data[32];
+} secp256k1_tagged_hasher;
+
 /** A pointer to a function to deterministically generate a nonce.
  *
  * Returns: 1 if a nonce was successfully generated. 0 will cause signing to fail.
@@ -113,6 +155,28 @@ typedef int (*secp256k1_nonce_function)(
     unsigned int attempt
 );
 
+/** A pointer to a function that returns the terms of a multi-scalar
+ *  multiplication, as used by secp256k1_ecmult_multi.
+ *
+ * Returns: 1 if the term was successfully written. 0 will cause
+ *          secp256k1_ecmult_multi to fail.
+ * Out:     scalar32:  pointer to a 32-byte array to be filled with the big-endian
+ *                     scalar of the term (must be less than the group order).
+ *          pubkey:    pointer to a public key object to be filled with the point
+ *                     of the term.
+ * In:      idx:       the index of the term, between 0 and n-1.
+ *          data:      arbitrary data pointer that is passed through.
+ *
+ * The function may be called more than once for the same index and must return
+ * the same term every time.
+ */
+typedef int (*secp256k1_ecmult_multi_pubkey_callback)(
+    unsigned char *scalar32,
+    secp256k1_pubkey *pubkey,
+    size_t idx,
+    void *data
+);
+
 # if !defined(SECP256K1_GNUC_PREREQ)
 #  if defined(__GNUC__)&&defined(__GNUC_MINOR__)
 #   define SECP256K1_GNUC_PREREQ(_maj,_min) \
@@ -198,6 +262,10 @@ typedef int (*secp256k1_nonce_function)(
 #define SECP256K1_FLAGS_BIT_CONTEXT_VERIFY (1 << 8)
 #define SECP256K1_FLAGS_BIT_CONTEXT_SIGN (1 << 9)
 #define SECP256K1_FLAGS_BIT_CONTEXT_DECLASSIFY (1 << 10)
+#define SECP256K1_FLAGS_MASK_CONTEXT_ECMULT_GEN (3 << 11)
+#define SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_2 (1 << 11)
+#define SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_22 (2 << 11)
+#define SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_86 (3 << 11)
 #define SECP256K1_FLAGS_BIT_COMPRESSION (1 << 8)
 
 /** Context flags to pass to secp256k1_context_create, secp256k1_context_preallocated_size, and
@@ -208,6 +276,12 @@ typedef int (*secp256k1_nonce_function)(
 #define SECP256K1_CONTEXT_VERIFY (SECP256K1_FLAGS_TYPE_CONTEXT | SECP256K1_FLAGS_BIT_CONTEXT_VERIFY)
 #define SECP256K1_CONTEXT_SIGN (SECP256K1_FLAGS_TYPE_CONTEXT | SECP256K1_FLAGS_BIT_CONTEXT_SIGN)
 
+/** Context flags to select the size of the precomputed table for signing and
+ *  public key generation (see secp256k1_context_create). */
+#define SECP256K1_CONTEXT_ECMULT_GEN_KB_2 (SECP256K1_FLAGS_TYPE_CONTEXT | SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_2)
+#define SECP256K1_CONTEXT_ECMULT_GEN_KB_22 (SECP256K1_FLAGS_TYPE_CONTEXT | SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_22)
+#define SECP256K1_CONTEXT_ECMULT_GEN_KB_86 (SECP256K1_FLAGS_TYPE_CONTEXT | SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_86)
+
 /* Testing flag. Do not use. */
 #define SECP256K1_CONTEXT_DECLASSIFY (SECP256K1_FLAGS_TYPE_CONTEXT | SECP256K1_FLAGS_BIT_CONTEXT_DECLASSIFY)
 
@@ -266,13 +340,19 @@ SECP256K1_API void secp256k1_selftest(void);
  *  secp256k1_preallocated.h.
  *
  *  Returns: pointer to a newly created context object.
- *  In:      flags: Always set to SECP256K1_CONTEXT_NONE (see below).
+ *  In:      flags: Set to SECP256K1_CONTEXT_NONE or one of the
+ *                  SECP256K1_CONTEXT_ECMULT_GEN_KB_* flags (see below).
  *
- *  The only valid non-deprecated flag in recent library versions is
- *  SECP256K1_CONTEXT_NONE, which will create a context sufficient for all functionality
- *  offered by the library. All other (deprecated) flags will be treated as equivalent
- *  to the SECP256K1_CONTEXT_NONE flag. Though the flags parameter primarily exists for
- *  historical reasons, future versions of the library may introduce new flags.
+ *  SECP256K1_CONTEXT_NONE creates a context sufficient for all functionality
+ *  offered by the library. All deprecated flags will be treated as equivalent
+ *  to the SECP256K1_CONTEXT_NONE flag.
+ *
+ *  SECP256K1_CONTEXT_ECMULT_GEN_KB_2, _22 and _86 select the size in KiB of the
+ *  precomputed table used for signing and public key generation, independently
+ *  of the size built into the library (see the --with-ecmult-gen-kb configure
+ *  option). Larger tables are faster. If the selected size is not the built-in
+ *  one, the table is computed when the context is created (taking a few
+ *  milliseconds for the largest one) and stored in the context's memory.
  *
  *  If the context is intended to be used for API functions that perform computations
  *  involving secret keys, e.g., signing and public key generation, then it is highly
@@ -392,6 +472,53 @@ SECP256K1_API void secp256k1_context_set_error_callback(
     const void *data
 ) SECP256K1_ARG_NONNULL(1);
 
+/** Use different precomputed tables of multiples of the generator.
+ *
+ *  By default, the tables built into the library are used, whose sizes are
+ *  fixed at build time (see the --with-ecmult-window and --with-ecmult-gen-kb
+ *  configure options). This function makes the context use the tables in a
+ *  table file written by `precompute_ecmult WINDOW FILE [BLOCKS TEETH]`
+ *  instead, e.g., G tables for verification with a larger window: a window of
+ *  w takes 2^(w-1) * 64 bytes, e.g., 128 MiB for w = 22. Tables that the file
+ *  does not contain are reset to the ones the context was created with. A comb
+ *  table for signing can have any valid BLOCKS and TEETH.
+ *
+ *  The file is not copied, so that it can be mapped read-only into memory and
+ *  shared by many processes. It must remain valid and unmodified for as long as
+ *  the context and any of its clones use it, and must be aligned like memory
+ *  returned by malloc. Only the header of the file is checked (against its
+ *  hash and the configuration of this build); the tables themselves are not
+ *  read. Use secp256k1_ecmult_tables_check to check them in full, e.g., once
+ *  after writing the file.
+ *
+ *  Returns: 1 if the tables are now in use, 0 if the header was rejected (in
+ *           which case the context is unchanged).
+ *  Args:       ctx: pointer to a context object (not secp256k1_context_static).
+ *  In:      tables: pointer to the contents of a table file written for the
+ *                   same platform and build configuration, or NULL to restore
+ *                   the tables the context was created with.
+ *       tables_len: length of tables in bytes.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_context_set_ecmult_tables(
+    secp256k1_context *ctx,
+    const unsigned char *tables,
+    size_t tables_len
+) SECP256K1_ARG_NONNULL(1);
+
+/** Check a table file in full.
+ *
+ *  Returns: 1 if secp256k1_context_set_ecmult_tables would accept the file and
+ *           its tables match the hash in its header, 0 otherwise.
+ *  Args:       ctx: pointer to a context object.
+ *  In:      tables: pointer to the contents of a table file.
+ *       tables_len: length of tables in bytes.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecmult_tables_check(
+    const secp256k1_context *ctx,
+    const unsigned char *tables,
+    size_t tables_len
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
 /** Create a secp256k1 scratch space object.
  *
  *  Returns: a newly created scratch space.
@@ -415,6 +542,171 @@ SECP256K1_API void secp256k1_scratch_space_destroy(
     secp256k1_scratch_space *scratch
 ) SECP256K1_ARG_NONNULL(1);
 
+/** A pointer to a function that performs one task of a computation split
+ *  into independent tasks.
+ *
+ *  In:  idx:  the index of the task.
+ *       data: opaque pointer provided by the library.
+ */
+typedef void (*secp256k1_task_function)(
+    size_t idx,
+    void *data
+);
+
+/** A pointer to a function that runs tasks, possibly in parallel.
+ *
+ *  The function must call task(i, task_data) exactly once for every i in
+ *  [0, n_tasks) and may only return once all these calls have returned. The
+ *  calls can be made from any thread and in any order. The tasks write to
+ *  disjoint memory and do not access the context, so they can safely run
+ *  concurrently.
+ *
+ *  In:          task: the function to call for every task.
+ *          task_data: the pointer to pass to every call of task.
+ *            n_tasks: the number of tasks.
+ *      executor_data: the opaque pointer passed to
+ *                     secp256k1_scratch_space_set_executor.
+ */
+typedef void (*secp256k1_executor)(
+    secp256k1_task_function task,
+    void *task_data,
+    size_t n_tasks,
+    void *executor_data
+);
+
+/** Set an executor for multi-scalar multiplications that use a scratch space.
+ *
+ *  Large multi-scalar multiplications using Pippenger's algorithm split their
+ *  points into up to n_tasks disjoint ranges, which are processed by separate
+ *  tasks through the executor. The library does not create any threads
+ *  itself; the executor is expected to hand the tasks to a thread pool. Every
+ *  task needs its own buckets in the scratch space, so a larger n_tasks
+ *  reduces the number of points that fit into a scratch space of a given size.
+ *
+ *  Args:           ctx: pointer to a context object.
+ *              scratch: pointer to a scratch space.
+ *  In:        executor: pointer to an executor function (can be NULL, in which
+ *                       case all computations run on the calling thread).
+ *        executor_data: the opaque pointer to pass to executor.
+ *              n_tasks: the maximum number of tasks per computation, usually
+ *                       the number of threads available to the executor. A
+ *                       value of 0 or 1 disables the executor.
+ */
+SECP256K1_API void secp256k1_scratch_space_set_executor(
+    const secp256k1_context *ctx,
+    secp256k1_scratch_space *scratch,
+    secp256k1_executor executor,
+    void *executor_data,
+    size_t n_tasks
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+/** The largest bucket window used by Pippenger's algorithm. */
+#define SECP256K1_ECMULT_MULTI_MAX_BUCKET_WINDOW 12
+
+/** Parameters that select the algorithm for multi-scalar multiplications that
+ *  use a scratch space.
+ *
+ *  The best values depend on the host. They can be measured with
+ *  secp256k1_ecmult_multi_calibrate and stored by the caller for later use.
+ *
+ *  Members:
+ *      pippenger_threshold: the minimum number of points (per batch, not
+ *                           counting the generator) for which Pippenger's
+ *                           algorithm is used instead of Strauss' algorithm.
+ *     bucket_window_max_points: bucket_window_max_points[i] is the maximum
+ *                           number of points for which Pippenger's algorithm
+ *                           uses a bucket window of i+1. The entries must be
+ *                           non-decreasing. Larger inputs use a bucket window
+ *                           of SECP256K1_ECMULT_MULTI_MAX_BUCKET_WINDOW.
+ */
+typedef struct {
+    size_t pippenger_threshold;
+    size_t bucket_window_max_points[SECP256K1_ECMULT_MULTI_MAX_BUCKET_WINDOW - 1];
+} secp256k1_ecmult_multi_tuning;
+
+/** A pointer to a function that returns the current time.
+ *
+ *  The unit and origin are arbitrary (only differences between two calls are
+ *  used), but the clock should be monotonic and have a resolution of a few
+ *  microseconds or better.
+ *
+ *  In: data: the opaque pointer passed to secp256k1_ecmult_multi_calibrate.
+ */
+typedef double (*secp256k1_timer_function)(
+    void *data
+);
+
+/** Get the default tuning for multi-scalar multiplications.
+ *
+ *  Args:    ctx: pointer to a context object.
+ *  Out:  tuning: pointer to a tuning object to fill in.
+ */
+SECP256K1_API void secp256k1_ecmult_multi_tuning_default(
+    const secp256k1_context *ctx,
+    secp256k1_ecmult_multi_tuning *tuning
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+/** Measure the tuning for multi-scalar multiplications on this host.
+ *
+ *  Times Pippenger's algorithm with different bucket windows and Strauss'
+ *  algorithm for batch sizes up to max_points on the calling thread. Bucket
+ *  windows for larger batches are taken from the defaults. This takes in the
+ *  order of ten seconds for max_points = 8192, and roughly half as long for
+ *  every halving of max_points.
+ *
+ *  Returns 1 on success, 0 if the arguments are invalid or memory allocation
+ *  failed (in which case tuning is set to the defaults).
+ *  Args:        ctx: pointer to a context object.
+ *  Out:      tuning: pointer to a tuning object to fill in.
+ *  In:   max_points: the largest batch size to measure (between 1 and
+ *                    5000000).
+ *             timer: pointer to a function that returns the current time.
+ *        timer_data: the opaque pointer to pass to timer.
+ */
+SECP256K1_API int secp256k1_ecmult_multi_calibrate(
+    const secp256k1_context *ctx,
+    secp256k1_ecmult_multi_tuning *tuning,
+    size_t max_points,
+    secp256k1_timer_function timer,
+    void *timer_data
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(4);
+
+/** Set the tuning for multi-scalar multiplications that use a scratch space.
+ *
+ *  Returns 1 on success, 0 if the tuning is invalid (in which case the scratch
+ *  space is unchanged).
+ *  Args:     ctx: pointer to a context object.
+ *        scratch: pointer to a scratch space.
+ *  In:    tuning: pointer to a tuning object, which is copied (can be NULL, in
+ *                 which case the default tuning is used).
+ */
+SECP256K1_API int secp256k1_scratch_space_set_tuning(
+    const secp256k1_context *ctx,
+    secp256k1_scratch_space *scratch,
+    const secp256k1_ecmult_multi_tuning *tuning
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+/** Set whether multi-scalar multiplications that use a scratch space coalesce
+ *  repeated points.
+ *
+ *  If enabled, the points are read in chunks and the scalars of points with
+ *  the same x coordinate are summed up (or subtracted if the points are
+ *  negations of each other) before the multiplication, which then has fewer
+ *  points to process. This is worthwhile if many inputs share the same point,
+ *  e.g., when batch verifying signatures for few distinct public keys. The
+ *  hashing and the memory for the chunk are wasted if no point repeats, so
+ *  it is disabled by default.
+ *
+ *  Args:     ctx: pointer to a context object.
+ *        scratch: pointer to a scratch space.
+ *  In:    enable: 1 to coalesce repeated points, 0 to disable it.
+ */
+SECP256K1_API void secp256k1_scratch_space_set_dedup(
+    const secp256k1_context *ctx,
+    secp256k1_scratch_space *scratch,
+    int enable
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
 /** Parse a variable-length public key into the pubkey object.
  *
  *  Returns: 1 if the public key was fully valid.
@@ -596,6 +888,96 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdsa_verify(
     const secp256k1_pubkey *pubkey
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Verify a batch of ECDSA signatures.
+ *
+ *  Returns 1 if and only if secp256k1_ecdsa_verify would return 1 for every
+ *  signature in the batch. In particular, only signatures in lower-S form are
+ *  accepted.
+ *
+ *  Every signature is turned into the equation s*R = m*G + r*P, where R is the
+ *  nonce point that is lifted from r. The equations are combined with random
+ *  weights derived from a hash of all inputs and checked with a single
+ *  multi-scalar multiplication. This requires no inversions of s at all.
+ *  Lifting R from r requires knowing the parity of its y coordinate (and, in
+ *  cryptographically unreachable cases, whether its x coordinate exceeds the
+ *  group order), which is exactly the recovery id that the recovery module
+ *  produces when signing. These hints only affect performance: if the batch
+ *  check fails, for example because a hint is wrong, every signature is
+ *  verified individually to determine the result.
+ *
+ *  Returns: 1: all signatures are correct
+ *           0: at least one signature is incorrect or unparseable
+ *  Args:    ctx:       pointer to a context object
+ *           scratch:   scratch space used for the multi-scalar multiplication
+ *                      (can be NULL, in which case the batch is not faster
+ *                      than individual verification).
+ *  In:      sig:       array of pointers to signatures.
+ *           msghash32: array of pointers to 32-byte message hashes (see
+ *                      secp256k1_ecdsa_verify).
+ *           pubkey:    array of pointers to initialized public keys.
+ *           recid:     array of recovery ids (0, 1, 2 or 3) of the signatures
+ *                      (can be NULL, in which case all signatures are verified
+ *                      individually).
+ *           n_sigs:    number of signatures in the above arrays. The arrays can
+ *                      only be NULL if n_sigs is 0.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdsa_verify_batch(
+    const secp256k1_context *ctx,
+    secp256k1_scratch_space *scratch,
+    const secp256k1_ecdsa_signature * const *sig,
+    const unsigned char * const *msghash32,
+    const secp256k1_pubkey * const *pubkey,
+    const int *recid,
+    size_t n_sigs
+) SECP256K1_ARG_NONNULL(1);
+
+/** Prepare a public key for verifying many signatures.
+ *
+ *  Computes tables of multiples of the public key (about 32 KiB), which are
+ *  reused by every verification with the prepared key instead of being
+ *  recomputed for each one. This pays off after a few verifications.
+ *
+ *  Returns: a newly created prepared public key, or NULL if the arguments are
+ *           invalid.
+ *  Args:    ctx: pointer to a context object.
+ *  In:   pubkey: pointer to an initialized public key.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT secp256k1_pubkey_prepared *secp256k1_pubkey_prepared_create(
+    const secp256k1_context *ctx,
+    const secp256k1_pubkey *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+/** Destroy a prepared public key.
+ *
+ *  The pointer may not be used afterwards.
+ *  Args:      ctx: pointer to a context object.
+ *        prepared: pointer to a prepared public key to destroy (can be NULL,
+ *                  in which case this function is a no-op).
+ */
+SECP256K1_API void secp256k1_pubkey_prepared_destroy(
+    const secp256k1_context *ctx,
+    secp256k1_pubkey_prepared *prepared
+) SECP256K1_ARG_NONNULL(1);
+
+/** Verify an ECDSA signature with a prepared public key.
+ *
+ *  Same as secp256k1_ecdsa_verify, but faster.
+ *
+ *  Returns: 1: correct signature
+ *           0: incorrect or unparseable signature
+ *  Args:    ctx:       pointer to a context object
+ *  In:      sig:       the signature being verified.
+ *           msghash32: the 32-byte message hash being verified (see
+ *                      secp256k1_ecdsa_verify).
+ *           pubkey:    pointer to a prepared public key to verify with.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecdsa_verify_prepared(
+    const secp256k1_context *ctx,
+    const secp256k1_ecdsa_signature *sig,
+    const unsigned char *msghash32,
+    const secp256k1_pubkey_prepared *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
 /** Convert a signature to a normalized lower-S form.
  *
  *  Returns: 1 if sigin was not normalized, 0 if it already was.
@@ -679,6 +1061,162 @@ SECP256K1_API int secp256k1_ecdsa_sign(
     const void *ndata
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
 
+/** Create an empty signing nonce pool.
+ *
+ *  Every nonce in the pool is used for at most one signature and erased from
+ *  the pool when it is used. Signing with a pool uses uniformly random nonces
+ *  instead of deriving them from the secret key and message (as
+ *  secp256k1_nonce_function_rfc6979 and secp256k1_nonce_function_bip340 do).
+ *  The security of the signatures therefore depends on the randomness that
+ *  is given to secp256k1_sign_pool_fill or secp256k1_sign_pool_add_nonce.
+ *
+ *  Returns: a newly created pool, or NULL if the arguments are invalid.
+ *  Args:      ctx: pointer to a context object.
+ *  In:   capacity: maximum number of nonces in the pool (must be positive).
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT secp256k1_sign_pool *secp256k1_sign_pool_create(
+    const secp256k1_context *ctx,
+    size_t capacity
+) SECP256K1_ARG_NONNULL(1);
+
+/** Destroy a signing nonce pool, erasing the nonces it contains.
+ *
+ *  The pointer may not be used afterwards.
+ *  Args:  ctx: pointer to a context object.
+ *        pool: pointer to a pool to destroy (can be NULL, in which case this
+ *              function is a no-op).
+ */
+SECP256K1_API void secp256k1_sign_pool_destroy(
+    const secp256k1_context *ctx,
+    secp256k1_sign_pool *pool
+) SECP256K1_ARG_NONNULL(1);
+
+/** Return the number of nonces in a signing nonce pool.
+ *
+ *  Args:  ctx: pointer to a context object.
+ *  In:   pool: pointer to a pool.
+ */
+SECP256K1_API size_t secp256k1_sign_pool_size(
+    const secp256k1_context *ctx,
+    const secp256k1_sign_pool *pool
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+/** Fill a signing nonce pool up to its capacity.
+ *
+ *  The nonces are generated with a deterministic random bit generator that is
+ *  reseeded with seed32 (and its previous state) on every call, and their
+ *  nonce points are computed with the context. This is the expensive part of
+ *  signing, and is meant to be done ahead of time, e.g., when the signer is
+ *  idle. Adding a nonce takes roughly as long as creating a public key.
+ *
+ *  Returns: 1 always (the pool is full afterwards).
+ *  Args:     ctx: pointer to a context object (not secp256k1_context_static).
+ *  In/Out:  pool: pointer to a pool.
+ *  In:    seed32: pointer to 32 bytes of fresh randomness, e.g., from the
+ *                 operating system's random number generator. Using the same
+ *                 seed for different pools, or for a pool with the same
+ *                 history, results in the same nonces, which reveals the secret
+ *                 keys that sign with them.
+ */
+SECP256K1_API int secp256k1_sign_pool_fill(
+    const secp256k1_context *ctx,
+    secp256k1_sign_pool *pool,
+    const unsigned char *seed32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Add an externally generated nonce to a signing nonce pool.
+ *
+ *  The nonce point is computed with the context, so only the nonce is needed.
+ *  The nonce must be generated uniformly at random, kept secret, and not be
+ *  used for any other purpose: the caller should erase its copy after this
+ *  call. Two signatures with the same nonce reveal the secret key.
+ *
+ *  Returns: 1 if the nonce was added, 0 if it is invalid (zero or not less
+ *           than the group order) or the pool is full.
+ *  Args:     ctx: pointer to a context object (not secp256k1_context_static).
+ *  In/Out:  pool: pointer to a pool.
+ *  In:   nonce32: pointer to a 32-byte nonce.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_sign_pool_add_nonce(
+    const secp256k1_context *ctx,
+    secp256k1_sign_pool *pool,
+    const unsigned char *nonce32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Create an ECDSA signature with a nonce from a signing nonce pool.
+ *
+ *  Same as secp256k1_ecdsa_sign, but the nonce and nonce point are taken from
+ *  the pool, so that signing only needs arithmetic modulo the group order.
+ *  A nonce is taken from the pool even if the secret key is invalid.
+ *
+ *  Returns: 1: signature created
+ *           0: the secret key is invalid or the pool is empty
+ *  Args:    ctx:       pointer to a context object.
+ *  Out:     sig:       pointer to an array where the signature will be placed.
+ *  In:      msghash32: the 32-byte message hash being signed.
+ *           seckey:    pointer to a 32-byte secret key.
+ *  In/Out:  pool:      pointer to a pool.
+ */
+SECP256K1_API int secp256k1_ecdsa_sign_pool(
+    const secp256k1_context *ctx,
+    secp256k1_ecdsa_signature *sig,
+    const unsigned char *msghash32,
+    const unsigned char *seckey,
+    secp256k1_sign_pool *pool
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5);
+
+/** Create a signer for a secret key.
+ *
+ *  This validates the secret key and computes its public key once, and stores
+ *  them with the part of the deterministic nonce derivation that depends only
+ *  on the secret key.
+ *
+ *  Returns: a newly created signer, or NULL if the secret key is invalid.
+ *  Args:    ctx: pointer to a context object (not secp256k1_context_static).
+ *  In:   seckey: pointer to a 32-byte secret key (the signer keeps a copy, so
+ *                the caller may erase it afterwards).
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT secp256k1_signer *secp256k1_signer_create(
+    const secp256k1_context *ctx,
+    const unsigned char *seckey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+/** Destroy a signer, erasing the secret key and the state derived from it.
+ *
+ *  The pointer may not be used afterwards.
+ *  Args:    ctx: pointer to a context object.
+ *        signer: pointer to a signer to destroy (can be NULL, in which case
+ *                this function is a no-op).
+ */
+SECP256K1_API void secp256k1_signer_destroy(
+    const secp256k1_context *ctx,
+    secp256k1_signer *signer
+) SECP256K1_ARG_NONNULL(1);
+
+/** Create an ECDSA signature with a signer.
+ *
+ *  Same as secp256k1_ecdsa_sign with secp256k1_nonce_function_rfc6979 as the
+ *  nonce function, and creates the identical signature, but the secret key is
+ *  taken from the signer.
+ *
+ *  Returns: 1: signature created
+ *           0: the nonce generation function failed
+ *  Args:    ctx:       pointer to a context object (not secp256k1_context_static).
+ *  Out:     sig:       pointer to an array where the signature will be placed.
+ *  In:      msghash32: the 32-byte message hash being signed.
+ *           signer:    pointer to a signer created with secp256k1_signer_create.
+ *           ndata32:   pointer to 32 bytes of extra entropy for the nonce
+ *                      function (can be NULL, see
+ *                      secp256k1_nonce_function_rfc6979).
+ */
+SECP256K1_API int secp256k1_ecdsa_sign_signer(
+    const secp256k1_context *ctx,
+    secp256k1_ecdsa_signature *sig,
+    const unsigned char *msghash32,
+    const secp256k1_signer *signer,
+    const unsigned char *ndata32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
 /** Verify an ECDSA secret key.
  *
  *  A secret key is valid if it is not 0 and less than the secp256k1 curve order
@@ -710,6 +1248,56 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_create(
     const unsigned char *seckey
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
 
+/** Compute the public keys for a batch of secret keys.
+ *
+ *  Same as calling secp256k1_ec_pubkey_create for every secret key, but faster:
+ *  the public keys are converted to affine coordinates in groups that share a
+ *  single field inversion.
+ *
+ *  Returns: 1 if all secret keys are valid, 0 otherwise (in which case the
+ *           public keys for the invalid secret keys are zeroed out).
+ *  Args:    ctx:     pointer to a context object (not secp256k1_context_static).
+ *  Out:     pubkeys: array of n_keys public key objects to be filled in.
+ *  In:      seckeys: array of pointers to 32-byte secret keys.
+ *           n_keys:  number of secret keys. The arrays can only be NULL if
+ *                    n_keys is 0.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_create_batch(
+    const secp256k1_context *ctx,
+    secp256k1_pubkey *pubkeys,
+    const unsigned char * const *seckeys,
+    size_t n_keys
+) SECP256K1_ARG_NONNULL(1);
+
+/** Compute the public keys for a sequence of secret keys with a fixed step.
+ *
+ *  Sets pubkeys[i] to the public key for the secret key seckey + i*step
+ *  (modulo the group order) for i = 0, ..., n_keys-1. Only the first public
+ *  key and the step are computed with a full multiplication; every further
+ *  public key is derived from the previous one with a single point addition,
+ *  and groups of public keys share a single field inversion. This is much
+ *  faster than calling secp256k1_ec_pubkey_create for every secret key.
+ *
+ *  Returns: 1 if seckey and step32 are valid and none of the secret keys in the
+ *           sequence is zero, 0 otherwise. If seckey or step32 is invalid, all
+ *           public keys are zeroed out; otherwise the public keys for zero
+ *           secret keys are zeroed out.
+ *  Args:    ctx:     pointer to a context object (not secp256k1_context_static).
+ *  Out:     pubkeys: array of n_keys public key objects to be filled in (can
+ *                    only be NULL if n_keys is 0).
+ *  In:      seckey:  pointer to the 32-byte first secret key.
+ *           step32:  pointer to the 32-byte step, which must be valid as a
+ *                    secret key (can be NULL, in which case the step is 1).
+ *           n_keys:  number of public keys to compute.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_create_sequence(
+    const secp256k1_context *ctx,
+    secp256k1_pubkey *pubkeys,
+    const unsigned char *seckey,
+    const unsigned char *step32,
+    size_t n_keys
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(3);
+
 /** Negates a secret key in place.
  *
  *  Returns: 0 if the given secret key is invalid according to
@@ -891,6 +1479,43 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_combine(
     size_t n
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
 
+/** Compute a multi-scalar multiplication g*G + sum(scalar_i*pubkey_i).
+ *
+ *  The terms are obtained from a callback, so that callers do not need to
+ *  materialize them in memory. Depending on the number of terms and the size
+ *  of the scratch space, Strauss' or Pippenger's algorithm is used, which is
+ *  much faster than computing the products one by one with
+ *  secp256k1_ec_pubkey_tweak_mul and adding them with
+ *  secp256k1_ec_pubkey_combine.
+ *
+ *  This function is not constant time and must not be used with secret
+ *  scalars or points.
+ *
+ *  Returns: 1: the result is a valid public key.
+ *           0: the result is the point at infinity, a scalar is not less than
+ *              the group order, or the callback returned 0.
+ *  Args:       ctx: pointer to a context object.
+ *          scratch: scratch space used to hold intermediate results (can be
+ *                   NULL, in which case the terms are multiplied one by one).
+ *                   Its size determines how many points are processed at once.
+ *  Out:     pubkey: pointer to a public key object for placing the result.
+ *  In:  g_scalar32: pointer to a 32-byte scalar to multiply the generator with
+ *                   (can be NULL, which is equivalent to a zero scalar).
+ *         callback: pointer to a function returning the terms (can only be
+ *                   NULL if n is 0).
+ *             data: arbitrary data pointer passed to the callback.
+ *                n: the number of terms returned by the callback.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ecmult_multi(
+    const secp256k1_context *ctx,
+    secp256k1_scratch_space *scratch,
+    secp256k1_pubkey *pubkey,
+    const unsigned char *g_scalar32,
+    secp256k1_ecmult_multi_pubkey_callback callback,
+    void *data,
+    size_t n
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(3);
+
 /** Compute a tagged hash as defined in BIP-340.
  *
  *  This is useful for creating a message hash and achieving domain separation
@@ -916,6 +1541,47 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_tagged_sha256(
     size_t msglen
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(5);
 
+/** Initialize a tagged hasher for a tag.
+ *
+ *  The hasher stores the SHA256 state after hashing SHA256(tag)||SHA256(tag),
+ *  so that secp256k1_tagged_hasher_sha256 does not have to hash the tag again
+ *  for every message.
+ *
+ *  Returns: 1 always.
+ *  Args:    ctx: pointer to a context object
+ *  Out:  hasher: pointer to a tagged hasher object
+ *  In:      tag: pointer to an array containing the tag
+ *        taglen: length of the tag array
+ */
+SECP256K1_API int secp256k1_tagged_hasher_create(
+    const secp256k1_context *ctx,
+    secp256k1_tagged_hasher *hasher,
+    const unsigned char *tag,
+    size_t taglen
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
+
+/** Compute a tagged hash with a tagged hasher.
+ *
+ *  Returns SHA256(SHA256(tag)||SHA256(tag)||msg) for the tag the hasher was
+ *  created with, which is the same as secp256k1_tagged_sha256 with that tag.
+ *  The hasher is not modified and can be used for any number of messages.
+ *
+ *  Returns: 1 always.
+ *  Args:    ctx: pointer to a context object
+ *  Out:  hash32: pointer to a 32-byte array to store the resulting hash
+ *  In:   hasher: pointer to a tagged hasher initialized with
+ *                secp256k1_tagged_hasher_create
+ *           msg: pointer to an array containing the message
+ *        msglen: length of the message array
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_tagged_hasher_sha256(
+    const secp256k1_context *ctx,
+    unsigned char *hash32,
+    const secp256k1_tagged_hasher *hasher,
+    const unsigned char *msg,
+    size_t msglen
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,179 @@
+#ifndef SECP256K1_BATCH_H
+#define SECP256K1_BATCH_H
+
+#include "secp256k1.h"
+#include "secp256k1_extrakeys.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** This module implements a streaming batch verifier for ECDSA signatures,
+ *  BIP-340 Schnorr signatures and x-only tweak checks (as used by Taproot).
+ *
+ *  Items are added one by one as they become available. Each item is reduced
+ *  to a few terms of a single equation which is checked with one multi-scalar
+ *  multiplication once the scratch space is full (or when the batch is
+ *  verified explicitly). The random weights of the equation are derived from
+ *  a hash of all items in the flushed chunk. If a chunk fails, it is split in
+ *  halves repeatedly to find the invalid items, which are reported through an
+ *  optional callback.
+ *
+ *  Memory usage is proportional to the size of the scratch space given at
+ *  creation, independently of the number of items added.
+ */
+
+/** Opaque data structure that holds a batch of items to verify.
+ *
+ *  The batch keeps a pointer to the scratch space it was created with, which
+ *  must not be used for anything else and must outlive the batch.
+ */
+typedef struct secp256k1_batch_struct secp256k1_batch;
+
+/** A pointer to a function that is called for every invalid item.
+ *
+ *  In:  idx:  the index of the invalid item, counting all items added to the
+ *             batch since its creation (starting at 0).
+ *       data: the opaque pointer passed to secp256k1_batch_set_invalid_callback.
+ */
+typedef void (*secp256k1_batch_invalid_callback)(
+    size_t idx,
+    void *data
+);
+
+/** Create a batch verification object.
+ *
+ *  Returns: a newly created batch object, or NULL if the arguments are invalid.
+ *  Args:     ctx: pointer to a context object.
+ *  In:   scratch: pointer to a scratch space, which determines how many items
+ *                 are verified at once. A larger scratch space results in
+ *                 faster verification.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT secp256k1_batch *secp256k1_batch_create(
+    const secp256k1_context *ctx,
+    secp256k1_scratch_space *scratch
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+/** Destroy a batch verification object.
+ *
+ *  Items that have not been verified yet are discarded. The pointer may not be
+ *  used afterwards.
+ *  Args:   ctx: pointer to a context object.
+ *        batch: pointer to a batch object to destroy (can be NULL, in which
+ *               case this function is a no-op).
+ */
+SECP256K1_API void secp256k1_batch_destroy(
+    const secp256k1_context *ctx,
+    secp256k1_batch *batch
+) SECP256K1_ARG_NONNULL(1);
+
+/** Set a callback function to be called for every invalid item.
+ *
+ *  Invalid items are also reflected in the result of secp256k1_batch_verify,
+ *  so setting a callback is only needed to learn which items are invalid.
+ *
+ *  Args:   ctx: pointer to a context object.
+ *        batch: pointer to a batch object.
+ *  In:     fun: pointer to a function to call for every invalid item (can be
+ *               NULL, which disables the callback).
+ *         data: the opaque pointer to pass to fun.
+ */
+SECP256K1_API void secp256k1_batch_set_invalid_callback(
+    const secp256k1_context *ctx,
+    secp256k1_batch *batch,
+    secp256k1_batch_invalid_callback fun,
+    void *data
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+/** Add an ECDSA signature to the batch.
+ *
+ *  The signature is accepted if and only if secp256k1_ecdsa_verify would
+ *  accept it. If recid is NULL or does not match the signature, the signature
+ *  is verified individually.
+ *
+ *  Returns: 0 if the arguments are invalid, 1 otherwise (including when the
+ *           signature is found to be invalid immediately).
+ *  Args:        ctx: pointer to a context object.
+ *             batch: pointer to a batch object.
+ *  In:          sig: pointer to the signature.
+ *         msghash32: pointer to the 32-byte message hash.
+ *            pubkey: pointer to the public key.
+ *             recid: pointer to the recovery id of the signature (between 0
+ *                    and 3), as produced by secp256k1_ecdsa_sign_recoverable
+ *                    (can be NULL).
+ */
+SECP256K1_API int secp256k1_batch_add_ecdsa(
+    const secp256k1_context *ctx,
+    secp256k1_batch *batch,
+    const secp256k1_ecdsa_signature *sig,
+    const unsigned char *msghash32,
+    const secp256k1_pubkey *pubkey,
+    const int *recid
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5);
+
+/** Add a Schnorr signature to the batch.
+ *
+ *  The signature is accepted if and only if secp256k1_schnorrsig_verify would
+ *  accept it.
+ *
+ *  Returns: 0 if the arguments are invalid, 1 otherwise.
+ *  Args:    ctx: pointer to a context object.
+ *         batch: pointer to a batch object.
+ *  In:    sig64: pointer to the 64-byte signature.
+ *           msg: the message being verified. Can only be NULL if msglen is 0.
+ *        msglen: length of the message.
+ *        pubkey: pointer to an x-only public key to verify with.
+ */
+SECP256K1_API int secp256k1_batch_add_schnorrsig(
+    const secp256k1_context *ctx,
+    secp256k1_batch *batch,
+    const unsigned char *sig64,
+    const unsigned char *msg,
+    size_t msglen,
+    const secp256k1_xonly_pubkey *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(6);
+
+/** Add an x-only tweak check to the batch.
+ *
+ *  The item is accepted if and only if secp256k1_xonly_pubkey_tweak_add_check
+ *  would return 1 for the same arguments.
+ *
+ *  Returns: 0 if the arguments are invalid, 1 otherwise.
+ *  Args:               ctx: pointer to a context object.
+ *                    batch: pointer to a batch object.
+ *  In:    tweaked_pubkey32: pointer to a serialized xonly_pubkey.
+ *        tweaked_pk_parity: the parity of the tweaked pubkey.
+ *          internal_pubkey: pointer to an x-only public key object to apply
+ *                           the tweak to.
+ *                  tweak32: pointer to a 32-byte tweak.
+ */
+SECP256K1_API int secp256k1_batch_add_xonlypub_tweak_check(
+    const secp256k1_context *ctx,
+    secp256k1_batch *batch,
+    const unsigned char *tweaked_pubkey32,
+    int tweaked_pk_parity,
+    const secp256k1_xonly_pubkey *internal_pubkey,
+    const unsigned char *tweak32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3) SECP256K1_ARG_NONNULL(5) SECP256K1_ARG_NONNULL(6);
+
+/** Verify all pending items of the batch.
+ *
+ *  Returns 1 if and only if every item added to the batch since its creation
+ *  is valid (except with negligible probability). The batch can be used for
+ *  further items afterwards; the result keeps accumulating.
+ *
+ *  Returns: 1: all items are valid
+ *           0: at least one item is invalid
+ *  Args:   ctx: pointer to a context object.
+ *        batch: pointer to a batch object.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_batch_verify(
+    const secp256k1_context *ctx,
+    secp256k1_batch *batch
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SECP256K1_BATCH_H */
@@ -155,6 +155,40 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_xonly_pubkey_tweak_add_
     const unsigned char *tweak32
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(4) SECP256K1_ARG_NONNULL(5);
 
+/** Checks a batch of tweaked pubkeys at once.
+ *
+ *  Returns 1 if and only if secp256k1_xonly_pubkey_tweak_add_check would
+ *  return 1 for every entry (except with negligible probability). The checks
+ *  are combined with random weights derived from a hash of all inputs and
+ *  verified with a single multi-scalar multiplication, which is considerably
+ *  faster than checking them one by one for large batches. If the batch fails,
+ *  it is not indicated which entry is incorrect.
+ *
+ *  Returns: 1: all tweaked pubkeys are the result of tweaking the
+ *              corresponding internal_pubkey with the corresponding tweak32.
+ *           0: at least one entry is incorrect.
+ *  Args:              ctx: pointer to a context object.
+ *                 scratch: scratch space used for the multi-scalar
+ *                          multiplication (can be NULL, in which case the
+ *                          points are multiplied one by one).
+ *  In:   tweaked_pubkey32: array of pointers to serialized xonly_pubkeys.
+ *       tweaked_pk_parity: array of parities of the tweaked pubkeys.
+ *         internal_pubkey: array of pointers to the x-only public keys the
+ *                          tweaks were applied to.
+ *                 tweak32: array of pointers to 32-byte tweaks.
+ *                       n: number of entries in the above arrays. The arrays
+ *                          can only be NULL if n is 0.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_xonly_pubkey_tweak_add_check_batch(
+    const secp256k1_context *ctx,
+    secp256k1_scratch_space *scratch,
+    const unsigned char * const *tweaked_pubkey32,
+    const int *tweaked_pk_parity,
+    const secp256k1_xonly_pubkey * const *internal_pubkey,
+    const unsigned char * const *tweak32,
+    size_t n
+) SECP256K1_ARG_NONNULL(1);
+
 /** Compute the keypair for a secret key.
  *
  *  Returns: 1: secret was valid, keypair is ready to use
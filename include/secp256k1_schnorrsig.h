@@ -165,6 +165,56 @@ SECP256K1_API int secp256k1_schnorrsig_sign_custom(
     secp256k1_schnorrsig_extraparams *extraparams
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(5);
 
+/** Create a Schnorr signature with a nonce from a signing nonce pool.
+ *
+ *  Same as secp256k1_schnorrsig_sign_custom, but the nonce and nonce point are
+ *  taken from the pool (see secp256k1_sign_pool_create), so that signing only
+ *  needs hashing and arithmetic modulo the group order. The nonce is random
+ *  instead of derived as in BIP-340 "Default Signing"; BIP-340 permits this as
+ *  long as the nonce is never reused, which the pool ensures.
+ *
+ *  Returns 1 on success, 0 on failure (including if the pool is empty).
+ *  Args:   ctx: pointer to a context object.
+ *  Out:  sig64: pointer to a 64-byte array to store the serialized signature.
+ *  In:     msg: the message being signed. Can only be NULL if msglen is 0.
+ *       msglen: length of the message.
+ *      keypair: pointer to an initialized keypair.
+ *  In/Out: pool: pointer to a pool.
+ */
+SECP256K1_API int secp256k1_schnorrsig_sign_pool(
+    const secp256k1_context *ctx,
+    unsigned char *sig64,
+    const unsigned char *msg,
+    size_t msglen,
+    const secp256k1_keypair *keypair,
+    secp256k1_sign_pool *pool
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(5) SECP256K1_ARG_NONNULL(6);
+
+/** Create a Schnorr signature with a signer.
+ *
+ *  Same as secp256k1_schnorrsig_sign32 (with msglen arbitrary), but the secret
+ *  key and x-only public key are taken from the signer instead of being loaded
+ *  from a keypair. The signature is identical to the one created by
+ *  secp256k1_schnorrsig_sign32 with the keypair of the same secret key.
+ *
+ *  Returns 1 on success, 0 on failure.
+ *  Args:       ctx: pointer to a context object (not secp256k1_context_static).
+ *  Out:      sig64: pointer to a 64-byte array to store the serialized signature.
+ *  In:         msg: the message being signed. Can only be NULL if msglen is 0.
+ *           msglen: length of the message.
+ *           signer: pointer to a signer created with secp256k1_signer_create.
+ *       aux_rand32: 32 bytes of fresh randomness (can be NULL, see
+ *                   secp256k1_schnorrsig_sign32).
+ */
+SECP256K1_API int secp256k1_schnorrsig_sign_signer(
+    const secp256k1_context *ctx,
+    unsigned char *sig64,
+    const unsigned char *msg,
+    size_t msglen,
+    const secp256k1_signer *signer,
+    const unsigned char *aux_rand32
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(5);
+
 /** Verify a Schnorr signature.
  *
  *  Returns: 1: correct signature
@@ -183,6 +233,62 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorrsig_verify(
     const secp256k1_xonly_pubkey *pubkey
 ) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(5);
 
+/** Verify a Schnorr signature with a prepared public key.
+ *
+ *  Same as secp256k1_schnorrsig_verify, but faster. The x-only public key to
+ *  verify with is the one that corresponds to the prepared public key (as
+ *  computed by secp256k1_xonly_pubkey_from_pubkey).
+ *
+ *  Returns: 1: correct signature
+ *           0: incorrect signature
+ *  Args:    ctx: pointer to a context object.
+ *  In:    sig64: pointer to the 64-byte signature to verify.
+ *           msg: the message being verified. Can only be NULL if msglen is 0.
+ *        msglen: length of the message
+ *        pubkey: pointer to a prepared public key to verify with
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorrsig_verify_prepared(
+    const secp256k1_context *ctx,
+    const unsigned char *sig64,
+    const unsigned char *msg,
+    size_t msglen,
+    const secp256k1_pubkey_prepared *pubkey
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(5);
+
+/** Verify a batch of Schnorr signatures.
+ *
+ *  Returns 1 if and only if secp256k1_schnorrsig_verify would return 1 for
+ *  every signature in the batch (except with negligible probability). The
+ *  signatures are combined with random weights derived from a hash of all
+ *  inputs and checked with a single multi-scalar multiplication, which is
+ *  considerably faster than verifying them one by one for large batches. If
+ *  the batch fails, it is not indicated which signature is invalid.
+ *
+ *  Returns: 1: all signatures are correct
+ *           0: at least one signature is incorrect
+ *  Args:    ctx: pointer to a context object.
+ *       scratch: scratch space used for the multi-scalar multiplication (can
+ *                be NULL, in which case the signatures are effectively
+ *                verified one by one). Its size determines how many points
+ *                are processed at once.
+ *  In:    sig64: array of pointers to 64-byte signatures.
+ *           msg: array of pointers to messages. msg[i] can only be NULL if
+ *                msglen[i] is 0.
+ *        msglen: array of message lengths.
+ *        pubkey: array of pointers to x-only public keys.
+ *        n_sigs: number of signatures in the above arrays. The arrays can
+ *                only be NULL if n_sigs is 0.
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_schnorrsig_verify_batch(
+    const secp256k1_context *ctx,
+    secp256k1_scratch_space *scratch,
+    const unsigned char * const *sig64,
+    const unsigned char * const *msg,
+    const size_t *msglen,
+    const secp256k1_xonly_pubkey * const *pubkey,
+    size_t n_sigs
+) SECP256K1_ARG_NONNULL(1);
+
 #ifdef __cplusplus
 }
 #endif
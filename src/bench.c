@@ -37,9 +37,13 @@ static void help(int default_iters) {
     printf("    help              : display this help and exit\n");
     printf("    ecdsa             : all ECDSA algorithms--sign, verify, recovery (if enabled)\n");
     printf("    ecdsa_sign        : ECDSA siging algorithm\n");
+    printf("    ecdsa_sign_pool   : ECDSA signing with precomputed nonces (excluding the precomputation)\n");
+    printf("    ecdsa_sign_signer : ECDSA signing with a signer for a fixed key\n");
     printf("    ecdsa_verify      : ECDSA verification algorithm\n");
+    printf("    ecdsa_verify_prepared : ECDSA verification with a prepared public key\n");
     printf("    ec                : all EC public key algorithms (keygen)\n");
     printf("    ec_keygen         : EC public key generation\n");
+    printf("    ec_keygen_batch   : EC public key generation in batches of 64 keys\n");
 
 #ifdef ENABLE_MODULE_RECOVERY
     printf("    ecdsa_recover     : ECDSA public key recovery algorithm\n");
@@ -53,6 +57,8 @@ static void help(int default_iters) {
     printf("    schnorrsig        : all Schnorr signature algorithms (sign, verify)\n");
     printf("    schnorrsig_sign   : Schnorr sigining algorithm\n");
     printf("    schnorrsig_verify : Schnorr verification algorithm\n");
+    printf("    schnorrsig_verify_prepared : Schnorr verification with a prepared public key\n");
+    printf("    schnorrsig_verify_batch : Schnorr batch verification for increasing batch sizes\n");
 #endif
 
 #ifdef ENABLE_MODULE_ELLSWIFT
@@ -61,6 +67,8 @@ static void help(int default_iters) {
     printf("    ellswift_decode   : ElligatorSwift decoding\n");
     printf("    ellswift_keygen   : ElligatorSwift key generation\n");
     printf("    ellswift_ecdh     : ECDH on ElligatorSwift keys\n");
+    printf("    ellswift_encode_batch : ElligatorSwift batch encoding for increasing batch sizes\n");
+    printf("    ellswift_decode_batch : ElligatorSwift batch decoding for increasing batch sizes\n");
 #endif
 
     printf("\n");
@@ -74,6 +82,9 @@ typedef struct {
     size_t siglen;
     unsigned char pubkey[33];
     size_t pubkeylen;
+    secp256k1_pubkey_prepared *prepared;
+    secp256k1_sign_pool *pool;
+    secp256k1_signer *signer;
 } bench_data;
 
 static void bench_verify(void* arg, int iters) {
@@ -95,6 +106,23 @@ static void bench_verify(void* arg, int iters) {
     }
 }
 
+static void bench_verify_prepared(void* arg, int iters) {
+    int i;
+    bench_data* data = (bench_data*)arg;
+
+    for (i = 0; i < iters; i++) {
+        secp256k1_ecdsa_signature sig;
+        data->sig[data->siglen - 1] ^= (i & 0xFF);
+        data->sig[data->siglen - 2] ^= ((i >> 8) & 0xFF);
+        data->sig[data->siglen - 3] ^= ((i >> 16) & 0xFF);
+        CHECK(secp256k1_ecdsa_signature_parse_der(data->ctx, &sig, data->sig, data->siglen) == 1);
+        CHECK(secp256k1_ecdsa_verify_prepared(data->ctx, &sig, data->msg, data->prepared) == (i == 0));
+        data->sig[data->siglen - 1] ^= (i & 0xFF);
+        data->sig[data->siglen - 2] ^= ((i >> 8) & 0xFF);
+        data->sig[data->siglen - 3] ^= ((i >> 16) & 0xFF);
+    }
+}
+
 static void bench_sign_setup(void* arg) {
     int i;
     bench_data *data = (bench_data*)arg;
@@ -125,6 +153,44 @@ static void bench_sign_run(void* arg, int iters) {
     }
 }
 
+static void bench_sign_pool_setup(void* arg) {
+    bench_data *data = (bench_data*)arg;
+
+    bench_sign_setup(arg);
+    CHECK(secp256k1_sign_pool_fill(data->ctx, data->pool, data->msg));
+}
+
+static void bench_sign_signer_run(void* arg, int iters) {
+    int i;
+    bench_data *data = (bench_data*)arg;
+
+    unsigned char sig[64];
+    for (i = 0; i < iters; i++) {
+        secp256k1_ecdsa_signature signature;
+        CHECK(secp256k1_ecdsa_sign_signer(data->ctx, &signature, data->msg, data->signer, NULL));
+        CHECK(secp256k1_ecdsa_signature_serialize_compact(data->ctx, sig, &signature));
+        memcpy(data->msg, sig, 32);
+    }
+}
+
+static void bench_sign_pool_run(void* arg, int iters) {
+    int i;
+    bench_data *data = (bench_data*)arg;
+
+    unsigned char sig[74];
+    for (i = 0; i < iters; i++) {
+        size_t siglen = 74;
+        int j;
+        secp256k1_ecdsa_signature signature;
+        CHECK(secp256k1_ecdsa_sign_pool(data->ctx, &signature, data->msg, data->key, data->pool));
+        CHECK(secp256k1_ecdsa_signature_serialize_der(data->ctx, sig, &siglen, &signature));
+        for (j = 0; j < 32; j++) {
+            data->msg[j] = sig[j];
+            data->key[j] = sig[j + 32];
+        }
+    }
+}
+
 static void bench_keygen_setup(void* arg) {
     int i;
     bench_data *data = (bench_data*)arg;
@@ -148,6 +214,28 @@ static void bench_keygen_run(void *arg, int iters) {
     }
 }
 
+static void bench_keygen_batch_run(void *arg, int iters) {
+    int i, j;
+    bench_data *data = (bench_data*)arg;
+    unsigned char keys[64][32];
+    const unsigned char *key_ptrs[64];
+    secp256k1_pubkey pubkeys[64];
+
+    for (j = 0; j < 64; j++) {
+        memcpy(keys[j], data->key, 32);
+        keys[j][31] ^= j;
+        key_ptrs[j] = keys[j];
+    }
+    for (i = 0; i < iters; i += 64) {
+        int n = iters - i < 64 ? iters - i : 64;
+        unsigned char pub33[33];
+        size_t len = 33;
+        CHECK(secp256k1_ec_pubkey_create_batch(data->ctx, pubkeys, key_ptrs, n));
+        CHECK(secp256k1_ec_pubkey_serialize(data->ctx, pub33, &len, &pubkeys[n - 1], SECP256K1_EC_COMPRESSED));
+        memcpy(keys[0], pub33 + 1, 32);
+    }
+}
+
 
 #ifdef ENABLE_MODULE_ECDH
 # include "modules/ecdh/bench_impl.h"
@@ -176,10 +264,10 @@ int main(int argc, char** argv) {
     int iters = get_iters(default_iters);
 
     /* Check for invalid user arguments */
-    char* valid_args[] = {"ecdsa", "verify", "ecdsa_verify", "sign", "ecdsa_sign", "ecdh", "recover",
-                         "ecdsa_recover", "schnorrsig", "schnorrsig_verify", "schnorrsig_sign", "ec",
-                         "keygen", "ec_keygen", "ellswift", "encode", "ellswift_encode", "decode",
-                         "ellswift_decode", "ellswift_keygen", "ellswift_ecdh"};
+    char* valid_args[] = {"ecdsa", "verify", "ecdsa_verify", "ecdsa_verify_prepared", "sign", "ecdsa_sign", "ecdsa_sign_pool", "ecdsa_sign_signer", "ecdh", "recover",
+                         "ecdsa_recover", "schnorrsig", "schnorrsig_verify", "schnorrsig_verify_prepared", "schnorrsig_verify_batch", "schnorrsig_sign", "ec",
+                         "keygen", "ec_keygen", "ec_keygen_batch", "ellswift", "encode", "ellswift_encode", "decode",
+                         "ellswift_decode", "ellswift_keygen", "ellswift_ecdh", "ellswift_encode_batch", "ellswift_decode_batch"};
     size_t valid_args_size = sizeof(valid_args)/sizeof(valid_args[0]);
     int invalid_args = have_invalid_args(argc, argv, valid_args, valid_args_size);
 
@@ -214,7 +302,7 @@ int main(int argc, char** argv) {
 #endif
 
 #ifndef ENABLE_MODULE_SCHNORRSIG
-    if (have_flag(argc, argv, "schnorrsig") || have_flag(argc, argv, "schnorrsig_sign") || have_flag(argc, argv, "schnorrsig_verify")) {
+    if (have_flag(argc, argv, "schnorrsig") || have_flag(argc, argv, "schnorrsig_sign") || have_flag(argc, argv, "schnorrsig_verify") || have_flag(argc, argv, "schnorrsig_verify_prepared") || have_flag(argc, argv, "schnorrsig_verify_batch")) {
         fprintf(stderr, "./bench: Schnorr signatures module not enabled.\n");
         fprintf(stderr, "Use ./configure --enable-module-schnorrsig.\n\n");
         return 1;
@@ -224,7 +312,8 @@ int main(int argc, char** argv) {
 #ifndef ENABLE_MODULE_ELLSWIFT
     if (have_flag(argc, argv, "ellswift") || have_flag(argc, argv, "ellswift_encode") || have_flag(argc, argv, "ellswift_decode") ||
         have_flag(argc, argv, "encode") || have_flag(argc, argv, "decode") || have_flag(argc, argv, "ellswift_keygen") ||
-        have_flag(argc, argv, "ellswift_ecdh")) {
+        have_flag(argc, argv, "ellswift_ecdh") || have_flag(argc, argv, "ellswift_encode_batch") ||
+        have_flag(argc, argv, "ellswift_decode_batch")) {
         fprintf(stderr, "./bench: ElligatorSwift module not enabled.\n");
         fprintf(stderr, "Use ./configure --enable-module-ellswift.\n\n");
         return 1;
@@ -249,9 +338,29 @@ int main(int argc, char** argv) {
 
     print_output_table_header_row();
     if (d || have_flag(argc, argv, "ecdsa") || have_flag(argc, argv, "verify") || have_flag(argc, argv, "ecdsa_verify")) run_benchmark("ecdsa_verify", bench_verify, NULL, NULL, &data, 10, iters);
+    if (d || have_flag(argc, argv, "ecdsa") || have_flag(argc, argv, "verify") || have_flag(argc, argv, "ecdsa_verify_prepared")) {
+        data.prepared = secp256k1_pubkey_prepared_create(data.ctx, &pubkey);
+        CHECK(data.prepared != NULL);
+        run_benchmark("ecdsa_verify_prepared", bench_verify_prepared, NULL, NULL, &data, 10, iters);
+        secp256k1_pubkey_prepared_destroy(data.ctx, data.prepared);
+    }
 
     if (d || have_flag(argc, argv, "ecdsa") || have_flag(argc, argv, "sign") || have_flag(argc, argv, "ecdsa_sign")) run_benchmark("ecdsa_sign", bench_sign_run, bench_sign_setup, NULL, &data, 10, iters);
+    if (d || have_flag(argc, argv, "ecdsa") || have_flag(argc, argv, "sign") || have_flag(argc, argv, "ecdsa_sign_pool")) {
+        data.pool = secp256k1_sign_pool_create(data.ctx, iters);
+        CHECK(data.pool != NULL);
+        run_benchmark("ecdsa_sign_pool", bench_sign_pool_run, bench_sign_pool_setup, NULL, &data, 10, iters);
+        secp256k1_sign_pool_destroy(data.ctx, data.pool);
+    }
+    if (d || have_flag(argc, argv, "ecdsa") || have_flag(argc, argv, "sign") || have_flag(argc, argv, "ecdsa_sign_signer")) {
+        bench_sign_setup(&data);
+        data.signer = secp256k1_signer_create(data.ctx, data.key);
+        CHECK(data.signer != NULL);
+        run_benchmark("ecdsa_sign_signer", bench_sign_signer_run, NULL, NULL, &data, 10, iters);
+        secp256k1_signer_destroy(data.ctx, data.signer);
+    }
     if (d || have_flag(argc, argv, "ec") || have_flag(argc, argv, "keygen") || have_flag(argc, argv, "ec_keygen")) run_benchmark("ec_keygen", bench_keygen_run, bench_keygen_setup, NULL, &data, 10, iters);
+    if (d || have_flag(argc, argv, "ec") || have_flag(argc, argv, "keygen") || have_flag(argc, argv, "ec_keygen_batch")) run_benchmark("ec_keygen_batch", bench_keygen_batch_run, bench_keygen_setup, NULL, &data, 10, iters);
 
     secp256k1_context_destroy(data.ctx);
 
@@ -17,11 +17,12 @@
 #include "bench.h"
 
 #define POINTS 32768
+#define CALIBRATE_POINTS 8192
 
 static void help(char **argv) {
     printf("Benchmark EC multiplication algorithms\n");
     printf("\n");
-    printf("Usage: %s <help|pippenger_wnaf|strauss_wnaf|simple>\n", argv[0]);
+    printf("Usage: %s <help|pippenger_wnaf|strauss_wnaf|simple|calibrate>\n", argv[0]);
     printf("The output shows the number of multiplied and summed points right after the\n");
     printf("function name. The letter 'g' indicates that one of the points is the generator.\n");
     printf("The benchmarks are divided by the number of points.\n");
@@ -31,6 +32,8 @@ static void help(char **argv) {
     printf("pippenger_wnaf:         for all batch sizes\n");
     printf("strauss_wnaf:           for all batch sizes\n");
     printf("simple:                 multiply and sum each point individually\n");
+    printf("calibrate:              measure the algorithm crossover points on this host,\n");
+    printf("                        print them and use them for ecmult_multi\n");
 }
 
 typedef struct {
@@ -273,6 +276,25 @@ static void run_ecmult_multi_bench(bench_data* data, size_t count, int includes_
     run_benchmark(str, bench_ecmult_multi, bench_ecmult_multi_setup, bench_ecmult_multi_teardown, data, 10, count * iters);
 }
 
+static double bench_ecmult_timer(void *data) {
+    (void)data;
+    return (double)gettime_i64();
+}
+
+static void calibrate(bench_data *data) {
+    secp256k1_ecmult_multi_tuning tuning;
+    int i;
+
+    CHECK(secp256k1_ecmult_multi_calibrate(data->ctx, &tuning, CALIBRATE_POINTS, bench_ecmult_timer, NULL));
+    printf("pippenger_threshold = %lu\n", (unsigned long)tuning.pippenger_threshold);
+    printf("bucket_window_max_points = {");
+    for (i = 0; i < SECP256K1_ECMULT_MULTI_MAX_BUCKET_WINDOW - 1; i++) {
+        printf("%s%lu", i ? ", " : " ", (unsigned long)tuning.bucket_window_max_points[i]);
+    }
+    printf(" }\n\n");
+    CHECK(secp256k1_scratch_space_set_tuning(data->ctx, data->scratch, &tuning));
+}
+
 int main(int argc, char **argv) {
     bench_data data;
     int i, p;
@@ -296,6 +318,8 @@ int main(int argc, char **argv) {
             data.ecmult_multi = secp256k1_ecmult_strauss_batch_single;
         } else if(have_flag(argc, argv, "simple")) {
             printf("Using simple algorithm:\n");
+        } else if(have_flag(argc, argv, "calibrate")) {
+            printf("Using ecmult_multi with calibrated tuning:\n");
         } else {
             fprintf(stderr, "%s: unrecognized argument '%s'.\n\n", argv[0], argv[1]);
             help(argv);
@@ -310,6 +334,9 @@ int main(int argc, char **argv) {
     } else {
         data.scratch = NULL;
     }
+    if (have_flag(argc, argv, "calibrate")) {
+        calibrate(&data);
+    }
 
     /* Allocate stuff */
     data.scalars = malloc(sizeof(secp256k1_scalar) * POINTS);
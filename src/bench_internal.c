@@ -30,7 +30,7 @@ static void help(int default_iters) {
     printf("    scalar     : all scalar operations (add, half, inverse, mul, negate, split)\n");
     printf("    field      : all field operations (half, inverse, issquare, mul, normalize, sqr, sqrt)\n");
     printf("    group      : all group operations (add, double, to_affine)\n");
-    printf("    ecmult     : all point multiplication operations (ecmult_wnaf) \n");
+    printf("    ecmult     : all point multiplication operations (ecmult_wnaf, ecmult_gen, ecmult_gen_sequence) \n");
     printf("    hash       : all hash algorithms (hmac, rng6979, sha256)\n");
     printf("    context    : all context object operations (context_create)\n");
     printf("\n");
@@ -43,6 +43,7 @@ typedef struct {
     secp256k1_gej gej[2];
     unsigned char data[64];
     int wnaf[256];
+    secp256k1_context *ctx;
 } bench_inv;
 
 static void bench_setup(void* arg) {
@@ -339,6 +340,30 @@ static void bench_ecmult_wnaf(void* arg, int iters) {
     CHECK(bits <= 256*iters);
 }
 
+static void bench_ecmult_gen(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+
+    /* The path of secp256k1_ec_pubkey_create for every key. */
+    for (i = 0; i < iters; i++) {
+        secp256k1_ecmult_gen(&data->ctx->ecmult_gen_ctx, &data->gej[0], &data->scalar[0]);
+        secp256k1_ge_set_gej(&data->ge[0], &data->gej[0]);
+        secp256k1_scalar_add(&data->scalar[0], &data->scalar[0], &secp256k1_scalar_one);
+    }
+}
+
+static void bench_ecmult_gen_sequence(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+    secp256k1_pubkey pubkeys[256];
+
+    for (i = 0; i < iters; i += 256) {
+        size_t n = iters - i < 256 ? iters - i : 256;
+        CHECK(secp256k1_ec_pubkey_create_sequence(data->ctx, pubkeys, data->data, NULL, n));
+        data->data[0] ^= 1;
+    }
+}
+
 static void bench_sha256(void* arg, int iters) {
     int i;
     bench_inv *data = (bench_inv*)arg;
@@ -351,6 +376,30 @@ static void bench_sha256(void* arg, int iters) {
     }
 }
 
+static void bench_sha256_transform_portable(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+    uint32_t s[8] = {0};
+
+    for (i = 0; i < iters; i++) {
+        secp256k1_sha256_transform_portable(s, data->data);
+        data->data[0] ^= s[0];
+    }
+}
+
+#ifdef SECP256K1_SHA256_SHANI
+static void bench_sha256_transform_shani(void* arg, int iters) {
+    int i;
+    bench_inv *data = (bench_inv*)arg;
+    uint32_t s[8] = {0};
+
+    for (i = 0; i < iters; i++) {
+        secp256k1_sha256_transform_shani(s, data->data);
+        data->data[0] ^= s[0];
+    }
+}
+#endif
+
 static void bench_hmac_sha256(void* arg, int iters) {
     int i;
     bench_inv *data = (bench_inv*)arg;
@@ -425,8 +474,16 @@ int main(int argc, char **argv) {
     if (d || have_flag(argc, argv, "group") || have_flag(argc, argv, "to_affine")) run_benchmark("group_to_affine_var", bench_group_to_affine_var, bench_setup, NULL, &data, 10, iters);
 
     if (d || have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "wnaf")) run_benchmark("ecmult_wnaf", bench_ecmult_wnaf, bench_setup, NULL, &data, 10, iters);
+    data.ctx = secp256k1_context_create(SECP256K1_CONTEXT_NONE);
+    if (d || have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "ecmult_gen")) run_benchmark("ecmult_gen", bench_ecmult_gen, bench_setup, NULL, &data, 10, iters);
+    if (d || have_flag(argc, argv, "ecmult") || have_flag(argc, argv, "ecmult_gen_sequence")) run_benchmark("ecmult_gen_sequence", bench_ecmult_gen_sequence, bench_setup, NULL, &data, 10, iters);
+    secp256k1_context_destroy(data.ctx);
 
     if (d || have_flag(argc, argv, "hash") || have_flag(argc, argv, "sha256")) run_benchmark("hash_sha256", bench_sha256, bench_setup, NULL, &data, 10, iters);
+    if (d || have_flag(argc, argv, "hash") || have_flag(argc, argv, "sha256")) run_benchmark("hash_sha256_transform_portable", bench_sha256_transform_portable, bench_setup, NULL, &data, 10, iters);
+#ifdef SECP256K1_SHA256_SHANI
+    if (d || have_flag(argc, argv, "hash") || have_flag(argc, argv, "sha256")) run_benchmark("hash_sha256_transform_shani", bench_sha256_transform_shani, bench_setup, NULL, &data, 10, iters);
+#endif
     if (d || have_flag(argc, argv, "hash") || have_flag(argc, argv, "hmac")) run_benchmark("hash_hmac_sha256", bench_hmac_sha256, bench_setup, NULL, &data, 10, iters);
     if (d || have_flag(argc, argv, "hash") || have_flag(argc, argv, "rng6979")) run_benchmark("hash_rfc6979_hmac_sha256", bench_rfc6979_hmac_sha256, bench_setup, NULL, &data, 10, iters);
 
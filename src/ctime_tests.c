@@ -77,6 +77,10 @@ static void run_tests(secp256k1_context *ctx, unsigned char *key) {
     unsigned char msg[32];
     unsigned char sig[74];
     unsigned char spubkey[33];
+    const unsigned char *key_ptrs[5];
+    secp256k1_pubkey pubkeys[5];
+    secp256k1_sign_pool *pool;
+    secp256k1_signer *signer;
 #ifdef ENABLE_MODULE_RECOVERY
     secp256k1_ecdsa_recoverable_signature recoverable_signature;
     int recid;
@@ -101,6 +105,25 @@ static void run_tests(secp256k1_context *ctx, unsigned char *key) {
     CHECK(ret);
     CHECK(secp256k1_ec_pubkey_serialize(ctx, spubkey, &outputlen, &pubkey, SECP256K1_EC_COMPRESSED) == 1);
 
+    /* Test batch keygen (with enough keys for the four-lane path, if enabled). */
+    for (i = 0; i < 5; i++) {
+        key_ptrs[i] = key;
+    }
+    SECP256K1_CHECKMEM_UNDEFINE(key, 32);
+    ret = secp256k1_ec_pubkey_create_batch(ctx, pubkeys, key_ptrs, 5);
+    SECP256K1_CHECKMEM_DEFINE(pubkeys, sizeof(pubkeys));
+    SECP256K1_CHECKMEM_DEFINE(&ret, sizeof(ret));
+    CHECK(ret);
+
+    /* Test sequential keygen. */
+    SECP256K1_CHECKMEM_UNDEFINE(key, 32);
+    SECP256K1_CHECKMEM_UNDEFINE(msg, 32);
+    ret = secp256k1_ec_pubkey_create_sequence(ctx, pubkeys, key, msg, 2);
+    SECP256K1_CHECKMEM_DEFINE(pubkeys, sizeof(pubkeys));
+    SECP256K1_CHECKMEM_DEFINE(&ret, sizeof(ret));
+    SECP256K1_CHECKMEM_DEFINE(msg, 32);
+    CHECK(ret);
+
     /* Test signing. */
     SECP256K1_CHECKMEM_UNDEFINE(key, 32);
     ret = secp256k1_ecdsa_sign(ctx, &signature, msg, key, NULL, NULL);
@@ -109,6 +132,35 @@ static void run_tests(secp256k1_context *ctx, unsigned char *key) {
     CHECK(ret);
     CHECK(secp256k1_ecdsa_signature_serialize_der(ctx, sig, &siglen, &signature));
 
+    /* Test signing with a nonce pool, filled with a secret seed. */
+    pool = secp256k1_sign_pool_create(ctx, 1);
+    CHECK(pool != NULL);
+    SECP256K1_CHECKMEM_UNDEFINE(key, 32);
+    ret = secp256k1_sign_pool_fill(ctx, pool, key);
+    SECP256K1_CHECKMEM_DEFINE(&ret, sizeof(ret));
+    CHECK(ret);
+    ret = secp256k1_ecdsa_sign_pool(ctx, &signature, msg, key, pool);
+    SECP256K1_CHECKMEM_DEFINE(&signature, sizeof(secp256k1_ecdsa_signature));
+    SECP256K1_CHECKMEM_DEFINE(&ret, sizeof(ret));
+    CHECK(ret);
+    secp256k1_sign_pool_destroy(ctx, pool);
+
+    /* Test signing with a signer. */
+    SECP256K1_CHECKMEM_UNDEFINE(key, 32);
+    signer = secp256k1_signer_create(ctx, key);
+    SECP256K1_CHECKMEM_DEFINE(&signer, sizeof(signer));
+    CHECK(signer != NULL);
+    ret = secp256k1_ecdsa_sign_signer(ctx, &signature, msg, signer, NULL);
+    SECP256K1_CHECKMEM_DEFINE(&signature, sizeof(secp256k1_ecdsa_signature));
+    SECP256K1_CHECKMEM_DEFINE(&ret, sizeof(ret));
+    CHECK(ret);
+#ifdef ENABLE_MODULE_SCHNORRSIG
+    ret = secp256k1_schnorrsig_sign_signer(ctx, sig, msg, 32, signer, NULL);
+    SECP256K1_CHECKMEM_DEFINE(&ret, sizeof(ret));
+    CHECK(ret == 1);
+#endif
+    secp256k1_signer_destroy(ctx, signer);
+
 #ifdef ENABLE_MODULE_ECDH
     /* Test ECDH. */
     SECP256K1_CHECKMEM_UNDEFINE(key, 32);
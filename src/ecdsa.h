@@ -15,7 +15,15 @@
 
 static int secp256k1_ecdsa_sig_parse(secp256k1_scalar *r, secp256k1_scalar *s, const unsigned char *sig, size_t size);
 static int secp256k1_ecdsa_sig_serialize(unsigned char *sig, size_t *size, const secp256k1_scalar *r, const secp256k1_scalar *s);
-static int secp256k1_ecdsa_sig_verify(const secp256k1_scalar* r, const secp256k1_scalar* s, const secp256k1_ge *pubkey, const secp256k1_scalar *message);
+static int secp256k1_ecdsa_sig_verify(const secp256k1_ecmult_g_tables *gt, const secp256k1_scalar* r, const secp256k1_scalar* s, const secp256k1_ge *pubkey, const secp256k1_scalar *message);
+/** Same as secp256k1_ecdsa_sig_verify, with the public key given by its prepared tables. */
+static int secp256k1_ecdsa_sig_verify_prepared(const secp256k1_ecmult_g_tables *gt, const secp256k1_scalar* r, const secp256k1_scalar* s, const secp256k1_ecmult_prepared_table *pubkey, const secp256k1_scalar *message);
+/** Compute the nonce point R whose x coordinate is sigr (if recid & 2 is 0) or
+ *  sigr + n (if recid & 2 is 1), and whose y coordinate has parity recid & 1.
+ *  Returns 0 if no such point exists. */
+static int secp256k1_ecdsa_sig_lift_r(secp256k1_ge *r, const secp256k1_scalar *sigr, int recid);
 static int secp256k1_ecdsa_sig_sign(const secp256k1_ecmult_gen_context *ctx, secp256k1_scalar* r, secp256k1_scalar* s, const secp256k1_scalar *seckey, const secp256k1_scalar *message, const secp256k1_scalar *nonce, int *recid);
+/** Same as secp256k1_ecdsa_sig_sign, but with the nonce point rp = nonce*G given. */
+static int secp256k1_ecdsa_sig_sign_point(secp256k1_scalar* r, secp256k1_scalar* s, const secp256k1_scalar *seckey, const secp256k1_scalar *message, const secp256k1_scalar *nonce, const secp256k1_ge *rp, int *recid);
 
 #endif /* SECP256K1_ECDSA_H */
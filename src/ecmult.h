@@ -40,9 +40,37 @@
 /** The number of entries a table with precomputed multiples needs to have. */
 #define ECMULT_TABLE_SIZE(w) (1L << ((w)-2))
 
+/** Tables of odd multiples of G and of 2^128*G in affine coordinates, with
+ *  ECMULT_TABLE_SIZE(window_g) entries each. */
+typedef struct {
+    const secp256k1_ge_storage *pre_g;
+    const secp256k1_ge_storage *pre_g_128;
+    int window_g;
+} secp256k1_ecmult_g_tables;
+
 /** Double multiply: R = na*A + ng*G */
 static void secp256k1_ecmult(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng);
 
+/** Same as secp256k1_ecmult, but using the given tables for G. */
+static void secp256k1_ecmult_tables(const secp256k1_ecmult_g_tables *gt, secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng);
+
+/** Window size of the tables of a point A that is multiplied repeatedly. Each
+ *  table takes 2^(ECMULT_PREPARED_WINDOW-2) group elements. */
+#define ECMULT_PREPARED_WINDOW 10
+
+/** Precomputed tables of a point A: odd multiples of A and of 2^128*A, in
+ *  affine coordinates (analogous to secp256k1_pre_g and secp256k1_pre_g_128). */
+typedef struct {
+    secp256k1_ge_storage pre[ECMULT_TABLE_SIZE(ECMULT_PREPARED_WINDOW)];
+    secp256k1_ge_storage pre_128[ECMULT_TABLE_SIZE(ECMULT_PREPARED_WINDOW)];
+} secp256k1_ecmult_prepared_table;
+
+/** Fill the tables of a point A, which must not be infinity. */
+static void secp256k1_ecmult_prepared_table_build(secp256k1_ecmult_prepared_table *pre, const secp256k1_ge *a);
+
+/** Double multiply with prepared tables: R = na*A + ng*G (ng can be NULL). */
+static void secp256k1_ecmult_prepared(const secp256k1_ecmult_g_tables *gt, secp256k1_gej *r, const secp256k1_ecmult_prepared_table *pre, const secp256k1_scalar *na, const secp256k1_scalar *ng);
+
 typedef int (secp256k1_ecmult_multi_callback)(secp256k1_scalar *sc, secp256k1_ge *pt, size_t idx, void *data);
 
 /**
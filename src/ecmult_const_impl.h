@@ -59,7 +59,7 @@ static void secp256k1_ecmult_const_odd_multiples_table_globalz(secp256k1_ge *pre
  * which means we just need to look up one of the precomputed values, and optionally negate it.
  */
 #define ECMULT_CONST_TABLE_GET_GE(r,pre,n) do { \
-    unsigned int m = 0; \
+    secp256k1_ge_storage entry; \
     /* If the top bit of n is 0, we want the negation. */ \
     volatile unsigned int negative = ((n) >> (ECMULT_CONST_GROUP_SIZE - 1)) ^ 1; \
     /* Let n[i] be the i-th bit of n, then the index is
@@ -87,17 +87,10 @@ static void secp256k1_ecmult_const_odd_multiples_table_globalz(secp256k1_ge *pre
     secp256k1_fe neg_y; \
     VERIFY_CHECK((n) < (1U << ECMULT_CONST_GROUP_SIZE)); \
     VERIFY_CHECK(index < (1U << (ECMULT_CONST_GROUP_SIZE - 1))); \
-    /* Unconditionally set r->x = (pre)[m].x. r->y = (pre)[m].y. because it's either the correct one
-     * or will get replaced in the later iterations, this is needed to make sure `r` is initialized. */ \
-    (r)->x = (pre)[m].x; \
-    (r)->y = (pre)[m].y; \
-    for (m = 1; m < ECMULT_CONST_TABLE_SIZE; m++) { \
-        /* This loop is used to avoid secret data in array indices. See
-         * the comment in ecmult_gen_impl.h for rationale. */ \
-        secp256k1_fe_cmov(&(r)->x, &(pre)[m].x, m == index); \
-        secp256k1_fe_cmov(&(r)->y, &(pre)[m].y, m == index); \
-    } \
-    (r)->infinity = 0; \
+    /* This reads every entry to avoid secret data in array indices. See
+     * the comment in ecmult_gen_impl.h for rationale. */ \
+    secp256k1_ge_storage_table_lookup(&entry, pre, ECMULT_CONST_TABLE_SIZE, index); \
+    secp256k1_ge_from_storage(r, &entry); \
     secp256k1_fe_negate(&neg_y, &(r)->y, 1); \
     secp256k1_fe_cmov(&(r)->y, &neg_y, negative); \
 } while(0)
@@ -192,7 +185,8 @@ static void secp256k1_ecmult_const(secp256k1_gej *r, const secp256k1_ge *a, cons
     static const secp256k1_scalar S_OFFSET = SECP256K1_SCALAR_CONST(0, 0, 0, 1, 0, 0, 0, 0);
     secp256k1_scalar s, v1, v2;
     secp256k1_ge pre_a[ECMULT_CONST_TABLE_SIZE];
-    secp256k1_ge pre_a_lam[ECMULT_CONST_TABLE_SIZE];
+    secp256k1_ge_storage pre_a_s[ECMULT_CONST_TABLE_SIZE];
+    secp256k1_ge_storage pre_a_lam_s[ECMULT_CONST_TABLE_SIZE];
     secp256k1_fe global_z;
     int group, i;
 
@@ -227,8 +221,12 @@ static void secp256k1_ecmult_const(secp256k1_gej *r, const secp256k1_ge *a, cons
      */
     secp256k1_gej_set_ge(r, a);
     secp256k1_ecmult_const_odd_multiples_table_globalz(pre_a, &global_z, r);
+    /* The tables are looked up in storage form, which is smaller. */
     for (i = 0; i < ECMULT_CONST_TABLE_SIZE; i++) {
-        secp256k1_ge_mul_lambda(&pre_a_lam[i], &pre_a[i]);
+        secp256k1_ge lam;
+        secp256k1_ge_mul_lambda(&lam, &pre_a[i]);
+        secp256k1_ge_to_storage(&pre_a_s[i], &pre_a[i]);
+        secp256k1_ge_to_storage(&pre_a_lam_s[i], &lam);
     }
 
     /* Next, we compute r = C_l(v1, A) + C_l(v2, lambda*A).
@@ -248,7 +246,7 @@ static void secp256k1_ecmult_const(secp256k1_gej *r, const secp256k1_ge *a, cons
         secp256k1_ge t;
         int j;
 
-        ECMULT_CONST_TABLE_GET_GE(&t, pre_a, bits1);
+        ECMULT_CONST_TABLE_GET_GE(&t, pre_a_s, bits1);
         if (group == ECMULT_CONST_GROUPS - 1) {
             /* Directly set r in the first iteration. */
             secp256k1_gej_set_ge(r, &t);
@@ -259,7 +257,7 @@ static void secp256k1_ecmult_const(secp256k1_gej *r, const secp256k1_ge *a, cons
             }
             secp256k1_gej_add_ge(r, r, &t);
         }
-        ECMULT_CONST_TABLE_GET_GE(&t, pre_a_lam, bits2);
+        ECMULT_CONST_TABLE_GET_GE(&t, pre_a_lam_s, bits2);
         secp256k1_gej_add_ge(r, r, &t);
     }
 
@@ -31,7 +31,10 @@
  * addition involves a cmov from (1 << (COMB_TEETH - 1)) table entries and a
  * conditional negation.
  *
- * The number of point doublings is COMB_SPACING - 1. */
+ * The number of point doublings is COMB_SPACING - 1.
+ *
+ * COMB_BLOCKS and COMB_TEETH determine the built-in table. A context can use a
+ * table for other values (see secp256k1_ecmult_gen_context_set_table). */
 
 #if defined(EXHAUSTIVE_TEST_ORDER)
 /* We need to control these values for exhaustive tests because
@@ -107,6 +110,13 @@
 #  error "COMB_TEETH can be reduced"
 #endif
 
+/* The largest value of blocks * teeth * spacing over all (blocks, teeth) that
+ * pass the checks above (see secp256k1_ecmult_gen_comb_params_valid). */
+#define COMB_MAX_BITS 294
+#if COMB_BITS > COMB_MAX_BITS
+#  error "COMB_BITS exceeds COMB_MAX_BITS"
+#endif
+
 #ifdef DEBUG_CONFIG
 #  pragma message DEBUG_CONFIG_DEF(COMB_RANGE)
 #  pragma message DEBUG_CONFIG_DEF(COMB_BLOCKS)
@@ -118,6 +128,13 @@ typedef struct {
     /* Whether the context has been built. */
     int built;
 
+    /* The comb table, in the layout of secp256k1_ecmult_gen_prec_table, and
+     * its parameters (analogous to COMB_BLOCKS, COMB_TEETH and COMB_SPACING). */
+    const secp256k1_ge_storage *prec;
+    int blocks;
+    int teeth;
+    int spacing;
+
     /* Values chosen such that
      *
      *   n*G == comb(n + scalar_offset, G/2) + ge_offset.
@@ -135,9 +152,20 @@ typedef struct {
 static void secp256k1_ecmult_gen_context_build(secp256k1_ecmult_gen_context* ctx);
 static void secp256k1_ecmult_gen_context_clear(secp256k1_ecmult_gen_context* ctx);
 
+/** Make a built context use the given comb table (NULL for the built-in one),
+ *  which must have been computed for valid parameters blocks and teeth. The
+ *  blinding is kept. */
+static void secp256k1_ecmult_gen_context_set_table(secp256k1_ecmult_gen_context* ctx, const secp256k1_ge_storage *prec, int blocks, int teeth);
+
 /** Multiply with the generator: R = a*G */
 static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context* ctx, secp256k1_gej *r, const secp256k1_scalar *a);
 
+#ifdef SECP256K1_FE_X4
+/** Multiply with the generator: r[j] = a[j]*G for j=0..3. Faster than four calls of
+ *  secp256k1_ecmult_gen. */
+static void secp256k1_ecmult_gen_x4(const secp256k1_ecmult_gen_context* ctx, secp256k1_gej *r, const secp256k1_scalar *a);
+#endif
+
 static void secp256k1_ecmult_gen_blind(secp256k1_ecmult_gen_context *ctx, const unsigned char *seed32);
 
 #endif /* SECP256K1_ECMULT_GEN_H */
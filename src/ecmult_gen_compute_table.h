@@ -9,6 +9,11 @@
 
 #include "ecmult_gen.h"
 
+/** Whether a comb table with the given parameters can be computed and used,
+ *  i.e., whether they pass the checks on COMB_BLOCKS and COMB_TEETH. */
+static int secp256k1_ecmult_gen_comb_params_valid(int blocks, int teeth);
+
+/** Compute a comb table for gen. Does not allocate memory. */
 static void secp256k1_ecmult_gen_compute_table(secp256k1_ge_storage* table, const secp256k1_ge* gen, int blocks, int teeth, int spacing);
 
 #endif /* SECP256K1_ECMULT_GEN_COMPUTE_TABLE_H */
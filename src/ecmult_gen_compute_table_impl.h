@@ -14,18 +14,24 @@
 #include "ecmult_gen.h"
 #include "util.h"
 
+static int secp256k1_ecmult_gen_comb_params_valid(int blocks, int teeth) {
+    int spacing;
+
+    if (blocks < 1 || blocks > 256 || teeth < 1 || teeth > 8) {
+        return 0;
+    }
+    spacing = CEIL_DIV(COMB_RANGE, blocks * teeth);
+    return (blocks - 1) * teeth * spacing < 256 && blocks * (teeth - 1) * spacing < 256;
+}
+
 static void secp256k1_ecmult_gen_compute_table(secp256k1_ge_storage* table, const secp256k1_ge* gen, int blocks, int teeth, int spacing) {
-    size_t points = ((size_t)1) << (teeth - 1);
-    size_t points_total = points * blocks;
-    secp256k1_ge* prec = checked_malloc(&default_error_callback, points_total * sizeof(*prec));
-    secp256k1_gej* ds = checked_malloc(&default_error_callback, teeth * sizeof(*ds));
-    secp256k1_gej* vs = checked_malloc(&default_error_callback, points_total * sizeof(*vs));
+    size_t pos = 0;
+    secp256k1_gej ds[8];
     secp256k1_gej u;
-    size_t vs_pos = 0;
     secp256k1_scalar half;
     int block, i;
 
-    VERIFY_CHECK(points_total > 0);
+    VERIFY_CHECK(teeth >= 1 && teeth <= 8);
 
     /* u is the running power of two times gen we're working with, initially gen/2. */
     secp256k1_scalar_half(&half, &secp256k1_scalar_one);
@@ -48,6 +54,7 @@ static void secp256k1_ecmult_gen_compute_table(secp256k1_ge_storage* table, cons
 
     for (block = 0; block < blocks; ++block) {
         int tooth;
+        secp256k1_ge ge;
         /* Here u = 2^(block*teeth*spacing) * gen/2. */
         secp256k1_gej sum;
         secp256k1_gej_set_infinity(&sum);
@@ -70,39 +77,33 @@ static void secp256k1_ecmult_gen_compute_table(secp256k1_ge_storage* table, cons
         /* Now u = 2^((block*teeth + teeth)*spacing) * gen/2
          *       = 2^((block+1)*teeth*spacing) * gen/2       */
 
-        /* Next, compute the table entries for block number block in Jacobian coordinates.
-         * The entries will occupy vs[block*points + i] for i=0..points-1.
-         * We start by computing the first (i=0) value corresponding to all summed
-         * powers of two times G being negative. */
-        secp256k1_gej_neg(&vs[vs_pos++], &sum);
+        /* Next, compute the table entries for block number block. They will
+         * occupy table[block*points + i] for i=0..points-1. We start by computing
+         * the first (i=0) value corresponding to all summed powers of two times G
+         * being negative. */
+        secp256k1_gej_neg(&sum, &sum);
+        secp256k1_ge_set_gej_var(&ge, &sum);
+        VERIFY_CHECK(!secp256k1_ge_is_infinity(&ge));
+        secp256k1_ge_to_storage(&table[pos++], &ge);
         /* And then teeth-1 times "double" the range of i values for which the table
          * is computed: in each iteration, double the table by taking an existing
-         * table entry and adding ds[tooth]. */
+         * table entry and adding ds[tooth]. Every entry is converted to affine
+         * coordinates on its own, which avoids memory allocation at the cost of
+         * one inversion per entry. */
         for (tooth = 0; tooth < teeth - 1; ++tooth) {
             size_t stride = ((size_t)1) << tooth;
             size_t index;
-            for (index = 0; index < stride; ++index, ++vs_pos) {
-                secp256k1_gej_add_var(&vs[vs_pos], &vs[vs_pos - stride], &ds[tooth], NULL);
+            for (index = 0; index < stride; ++index, ++pos) {
+                secp256k1_gej tmp;
+                secp256k1_ge_from_storage(&ge, &table[pos - stride]);
+                secp256k1_gej_add_ge_var(&tmp, &ds[tooth], &ge, NULL);
+                secp256k1_ge_set_gej_var(&ge, &tmp);
+                VERIFY_CHECK(!secp256k1_ge_is_infinity(&ge));
+                secp256k1_ge_to_storage(&table[pos], &ge);
             }
         }
     }
-    VERIFY_CHECK(vs_pos == points_total);
-
-    /* Convert all points simultaneously from secp256k1_gej to secp256k1_ge. */
-    secp256k1_ge_set_all_gej_var(prec, vs, points_total);
-    /* Convert all points from secp256k1_ge to secp256k1_ge_storage output. */
-    for (block = 0; block < blocks; ++block) {
-        size_t index;
-        for (index = 0; index < points; ++index) {
-            VERIFY_CHECK(!secp256k1_ge_is_infinity(&prec[block * points + index]));
-            secp256k1_ge_to_storage(&table[block * points + index], &prec[block * points + index]);
-        }
-    }
-
-    /* Free memory. */
-    free(vs);
-    free(ds);
-    free(prec);
+    VERIFY_CHECK(pos == ((size_t)blocks << (teeth - 1)));
 }
 
 #endif /* SECP256K1_ECMULT_GEN_COMPUTE_TABLE_IMPL_H */
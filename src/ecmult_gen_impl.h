@@ -10,11 +10,16 @@
 #include "util.h"
 #include "scalar.h"
 #include "group.h"
+#include "group_x4_impl.h"
 #include "ecmult_gen.h"
 #include "hash_impl.h"
 #include "precomputed_ecmult_gen.h"
 
 static void secp256k1_ecmult_gen_context_build(secp256k1_ecmult_gen_context *ctx) {
+    ctx->prec = &secp256k1_ecmult_gen_prec_table[0][0];
+    ctx->blocks = COMB_BLOCKS;
+    ctx->teeth = COMB_TEETH;
+    ctx->spacing = COMB_SPACING;
     secp256k1_ecmult_gen_blind(ctx, NULL);
     ctx->built = 1;
 }
@@ -25,6 +30,10 @@ static int secp256k1_ecmult_gen_context_is_built(const secp256k1_ecmult_gen_cont
 
 static void secp256k1_ecmult_gen_context_clear(secp256k1_ecmult_gen_context *ctx) {
     ctx->built = 0;
+    ctx->prec = NULL;
+    ctx->blocks = 0;
+    ctx->teeth = 0;
+    ctx->spacing = 0;
     secp256k1_scalar_clear(&ctx->scalar_offset);
     secp256k1_ge_clear(&ctx->ge_offset);
     secp256k1_fe_clear(&ctx->proj_blind);
@@ -32,8 +41,8 @@ static void secp256k1_ecmult_gen_context_clear(secp256k1_ecmult_gen_context *ctx
 
 /* Compute the scalar (2^COMB_BITS - 1) / 2, the difference between the gn argument to
  * secp256k1_ecmult_gen, and the scalar whose encoding the table lookup bits are drawn
- * from (before applying blinding). */
-static void secp256k1_ecmult_gen_scalar_diff(secp256k1_scalar* diff) {
+ * from (before applying blinding). Here COMB_BITS is given by comb_bits. */
+static void secp256k1_ecmult_gen_scalar_diff(secp256k1_scalar* diff, int comb_bits) {
     int i;
 
     /* Compute scalar -1/2. */
@@ -43,7 +52,7 @@ static void secp256k1_ecmult_gen_scalar_diff(secp256k1_scalar* diff) {
 
     /* Compute offset = 2^(COMB_BITS - 1). */
     *diff = secp256k1_scalar_one;
-    for (i = 0; i < COMB_BITS - 1; ++i) {
+    for (i = 0; i < comb_bits - 1; ++i) {
         secp256k1_scalar_add(diff, diff, diff);
     }
 
@@ -51,7 +60,52 @@ static void secp256k1_ecmult_gen_scalar_diff(secp256k1_scalar* diff) {
     secp256k1_scalar_add(diff, diff, &neghalf);
 }
 
-static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context *ctx, secp256k1_gej *r, const secp256k1_scalar *gn) {
+/* Compute the table index abs (and whether the table entry is to be negated, in
+ * sign) for the block whose first bit is at position bit_pos of the recoded scalar. */
+static SECP256K1_INLINE void secp256k1_ecmult_gen_comb_digit(uint32_t *sign, uint32_t *abs, const uint32_t *recoded, uint32_t bit_pos, const int teeth, const int spacing) {
+    /* Gather the mask(block)-selected bits of d into bits. They're packed:
+     * bits[tooth] = d[(block*COMB_TEETH + tooth)*COMB_SPACING + comb_off]. */
+    uint32_t bits = 0, tooth;
+    /* Instead of reading individual bits here to construct the bits variable,
+     * build up the result by xoring rotated reads together. In every iteration,
+     * one additional bit is made correct, starting at the bottom. The bits
+     * above that contain junk. This reduces leakage by avoiding computations
+     * on variables that can have only a low number of possible values (e.g.,
+     * just two values when reading a single bit into a variable.) See:
+     * https://www.usenix.org/system/files/conference/usenixsecurity18/sec18-alam.pdf
+     */
+    for (tooth = 0; tooth < (uint32_t)teeth; ++tooth) {
+        /* Construct bitdata s.t. the bottom bit is the bit we'd like to read.
+         *
+         * We could just set bitdata = recoded[bit_pos >> 5] >> (bit_pos & 0x1f)
+         * but this would simply discard the bits that fall off at the bottom,
+         * and thus, for example, bitdata could still have only two values if we
+         * happen to shift by exactly 31 positions. We use a rotation instead,
+         * which ensures that bitdata doesn't loose entropy. This relies on the
+         * rotation being atomic, i.e., the compiler emitting an actual rot
+         * instruction. */
+        uint32_t bitdata = secp256k1_rotr32(recoded[bit_pos >> 5], bit_pos & 0x1f);
+
+        /* Clear the bit at position tooth, but sssh, don't tell clang. */
+        uint32_t volatile vmask = ~(1 << tooth);
+        bits &= vmask;
+
+        /* Write the bit into position tooth (and junk into higher bits). */
+        bits ^= bitdata << tooth;
+        bit_pos += spacing;
+    }
+
+    /* If the top bit of bits is 1, flip them all (corresponding to looking up
+     * the negated table value), and remember to negate the result in sign. */
+    *sign = (bits >> (teeth - 1)) & 1;
+    *abs = (bits ^ -*sign) & (((uint32_t)1 << (teeth - 1)) - 1);
+    VERIFY_CHECK(*sign == 0 || *sign == 1);
+}
+
+/* Computes R = gn*G with a comb table for the given parameters (which are constants
+ * when called with the built-in ones, so that the compiler can specialize this). */
+SECP256K1_INLINE static void secp256k1_ecmult_gen_comb(const secp256k1_ecmult_gen_context *ctx, secp256k1_gej *r, const secp256k1_scalar *gn, const int blocks, const int teeth, const int spacing) {
+    const uint32_t points = (uint32_t)1 << (teeth - 1);
     uint32_t comb_off;
     secp256k1_ge add;
     secp256k1_fe neg;
@@ -60,7 +114,7 @@ static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context *ctx, secp25
     /* Array of uint32_t values large enough to store COMB_BITS bits. Only the bottom
      * 8 are ever nonzero, but having the zero padding at the end if COMB_BITS>256
      * avoids the need to deal with out-of-bounds reads from a scalar. */
-    uint32_t recoded[(COMB_BITS + 31) >> 5] = {0};
+    uint32_t recoded[(COMB_MAX_BITS + 31) >> 5] = {0};
     int first = 1, i;
 
     memset(&adds, 0, sizeof(adds));
@@ -109,7 +163,8 @@ static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context *ctx, secp25
     /* Compute the scalar d = (gn + ctx->scalar_offset). */
     secp256k1_scalar_add(&d, &ctx->scalar_offset, gn);
     /* Convert to recoded array. */
-    for (i = 0; i < 8 && i < ((COMB_BITS + 31) >> 5); ++i) {
+    VERIFY_CHECK(blocks * teeth * spacing <= COMB_MAX_BITS);
+    for (i = 0; i < 8 && i < ((blocks * teeth * spacing + 31) >> 5); ++i) {
         recoded[i] = secp256k1_scalar_get_bits_limb32(&d, 32 * i, 32);
     }
     secp256k1_scalar_clear(&d);
@@ -189,50 +244,16 @@ static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context *ctx, secp25
      * is the relevant mask(b) bits of m packed together without gaps. */
 
     /* Outer loop: iterate over comb_off from COMB_SPACING - 1 down to 0. */
-    comb_off = COMB_SPACING - 1;
+    comb_off = spacing - 1;
     while (1) {
         uint32_t block;
         uint32_t bit_pos = comb_off;
         /* Inner loop: for each block, add table entries to the result. */
-        for (block = 0; block < COMB_BLOCKS; ++block) {
-            /* Gather the mask(block)-selected bits of d into bits. They're packed:
-             * bits[tooth] = d[(block*COMB_TEETH + tooth)*COMB_SPACING + comb_off]. */
-            uint32_t bits = 0, sign, abs, index, tooth;
-            /* Instead of reading individual bits here to construct the bits variable,
-             * build up the result by xoring rotated reads together. In every iteration,
-             * one additional bit is made correct, starting at the bottom. The bits
-             * above that contain junk. This reduces leakage by avoiding computations
-             * on variables that can have only a low number of possible values (e.g.,
-             * just two values when reading a single bit into a variable.) See:
-             * https://www.usenix.org/system/files/conference/usenixsecurity18/sec18-alam.pdf
-             */
-            for (tooth = 0; tooth < COMB_TEETH; ++tooth) {
-                /* Construct bitdata s.t. the bottom bit is the bit we'd like to read.
-                 *
-                 * We could just set bitdata = recoded[bit_pos >> 5] >> (bit_pos & 0x1f)
-                 * but this would simply discard the bits that fall off at the bottom,
-                 * and thus, for example, bitdata could still have only two values if we
-                 * happen to shift by exactly 31 positions. We use a rotation instead,
-                 * which ensures that bitdata doesn't loose entropy. This relies on the
-                 * rotation being atomic, i.e., the compiler emitting an actual rot
-                 * instruction. */
-                uint32_t bitdata = secp256k1_rotr32(recoded[bit_pos >> 5], bit_pos & 0x1f);
-
-                /* Clear the bit at position tooth, but sssh, don't tell clang. */
-                uint32_t volatile vmask = ~(1 << tooth);
-                bits &= vmask;
-
-                /* Write the bit into position tooth (and junk into higher bits). */
-                bits ^= bitdata << tooth;
-                bit_pos += COMB_SPACING;
-            }
-
-            /* If the top bit of bits is 1, flip them all (corresponding to looking up
-             * the negated table value), and remember to negate the result in sign. */
-            sign = (bits >> (COMB_TEETH - 1)) & 1;
-            abs = (bits ^ -sign) & (COMB_POINTS - 1);
-            VERIFY_CHECK(sign == 0 || sign == 1);
-            VERIFY_CHECK(abs < COMB_POINTS);
+        for (block = 0; block < (uint32_t)blocks; ++block) {
+            uint32_t sign, abs;
+            secp256k1_ecmult_gen_comb_digit(&sign, &abs, recoded, bit_pos, teeth, spacing);
+            bit_pos += teeth * spacing;
+            VERIFY_CHECK(abs < points);
 
             /** This uses a conditional move to avoid any secret data in array indexes.
              *   _Any_ use of secret indexes has been demonstrated to result in timing
@@ -244,9 +265,7 @@ static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context *ctx, secp25
              *    by Dag Arne Osvik, Adi Shamir, and Eran Tromer
              *    (https://www.tau.ac.il/~tromer/papers/cache.pdf)
              */
-            for (index = 0; index < COMB_POINTS; ++index) {
-                secp256k1_ge_storage_cmov(&adds, &secp256k1_ecmult_gen_prec_table[block][index], index == abs);
-            }
+            secp256k1_ge_storage_table_lookup(&adds, &ctx->prec[block * points], points, abs);
 
             /* Set add=adds or add=-adds, in constant time, based on sign. */
             secp256k1_ge_from_storage(&add, &adds);
@@ -281,6 +300,110 @@ static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context *ctx, secp25
     memset(&recoded, 0, sizeof(recoded));
 }
 
+static void secp256k1_ecmult_gen(const secp256k1_ecmult_gen_context *ctx, secp256k1_gej *r, const secp256k1_scalar *gn) {
+    /* Dispatch on the (public) comb parameters of the context. */
+    if (ctx->blocks == COMB_BLOCKS && ctx->teeth == COMB_TEETH) {
+        secp256k1_ecmult_gen_comb(ctx, r, gn, COMB_BLOCKS, COMB_TEETH, COMB_SPACING);
+    } else {
+        secp256k1_ecmult_gen_comb(ctx, r, gn, ctx->blocks, ctx->teeth, ctx->spacing);
+    }
+}
+
+#ifdef SECP256K1_FE_X4
+/* Computes r[j] = gn[j]*G for j=0..3, with the same operations as secp256k1_ecmult_gen_comb
+ * in each of the lanes of the secp256k1_gej_x4 type. */
+static void secp256k1_ecmult_gen_x4(const secp256k1_ecmult_gen_context *ctx, secp256k1_gej *r, const secp256k1_scalar *gn) {
+    const int blocks = ctx->blocks, teeth = ctx->teeth, spacing = ctx->spacing;
+    const uint32_t points = (uint32_t)1 << (teeth - 1);
+    uint32_t comb_off;
+    secp256k1_ge_storage adds[4];
+    const secp256k1_ge_storage *adds_ptr[4];
+    secp256k1_ge_x4 add, offset;
+    secp256k1_gej_x4 rx;
+    secp256k1_fe_x4 blind;
+    secp256k1_fe proj_blind = ctx->proj_blind;
+    secp256k1_scalar d;
+    uint32_t recoded[4][(COMB_MAX_BITS + 31) >> 5];
+    uint64_t sign[4];
+    int first = 1, i, j;
+
+    memset(recoded, 0, sizeof(recoded));
+    VERIFY_CHECK(blocks * teeth * spacing <= COMB_MAX_BITS);
+    for (j = 0; j < 4; j++) {
+        secp256k1_scalar_add(&d, &ctx->scalar_offset, &gn[j]);
+        for (i = 0; i < 8 && i < ((blocks * teeth * spacing + 31) >> 5); ++i) {
+            recoded[j][i] = secp256k1_scalar_get_bits_limb32(&d, 32 * i, 32);
+        }
+        adds_ptr[j] = &adds[j];
+    }
+    secp256k1_scalar_clear(&d);
+    secp256k1_fe_normalize(&proj_blind);
+    secp256k1_fe_x4_set_fe(&blind, &proj_blind);
+
+    comb_off = spacing - 1;
+    while (1) {
+        uint32_t block;
+        uint32_t bit_pos = comb_off;
+        for (block = 0; block < (uint32_t)blocks; ++block) {
+            for (j = 0; j < 4; j++) {
+                uint32_t s, abs;
+                secp256k1_ecmult_gen_comb_digit(&s, &abs, recoded[j], bit_pos, teeth, spacing);
+                VERIFY_CHECK(abs < points);
+                secp256k1_ge_storage_table_lookup(&adds[j], &ctx->prec[block * points], points, abs);
+                sign[j] = -(uint64_t)s;
+            }
+            bit_pos += teeth * spacing;
+
+            secp256k1_ge_x4_set_storage(&add, adds_ptr);
+            secp256k1_ge_x4_cond_negate(&add, _mm256_loadu_si256((const __m256i *)(const void *)sign));
+            if (EXPECT(first, 0)) {
+                secp256k1_gej_x4_set_ge(&rx, &add);
+                secp256k1_gej_x4_rescale(&rx, &blind);
+                first = 0;
+            } else {
+                secp256k1_gej_x4_add_ge(&rx, &rx, &add);
+            }
+        }
+
+        if (comb_off-- == 0) break;
+        secp256k1_gej_x4_double(&rx, &rx);
+    }
+
+    secp256k1_ge_x4_set_ge(&offset, &ctx->ge_offset);
+    secp256k1_gej_x4_add_ge(&rx, &rx, &offset);
+    secp256k1_gej_x4_get_gej(r, &rx);
+
+    /* Cleanup. */
+    memset(&add, 0, sizeof(add));
+    memset(&rx, 0, sizeof(rx));
+    memset(adds, 0, sizeof(adds));
+    memset(sign, 0, sizeof(sign));
+    memset(recoded, 0, sizeof(recoded));
+}
+#endif
+
+static void secp256k1_ecmult_gen_context_set_table(secp256k1_ecmult_gen_context *ctx, const secp256k1_ge_storage *prec, int blocks, int teeth) {
+    secp256k1_scalar diff;
+
+    VERIFY_CHECK(ctx->built);
+    if (prec == NULL) {
+        prec = &secp256k1_ecmult_gen_prec_table[0][0];
+        blocks = COMB_BLOCKS;
+        teeth = COMB_TEETH;
+    }
+    /* scalar_offset = (2^COMB_BITS - 1)/2 - b depends on COMB_BITS, so replace
+     * that term to keep the blinding value b. */
+    secp256k1_ecmult_gen_scalar_diff(&diff, ctx->blocks * ctx->teeth * ctx->spacing);
+    secp256k1_scalar_negate(&diff, &diff);
+    secp256k1_scalar_add(&ctx->scalar_offset, &ctx->scalar_offset, &diff);
+    ctx->prec = prec;
+    ctx->blocks = blocks;
+    ctx->teeth = teeth;
+    ctx->spacing = CEIL_DIV(COMB_RANGE, blocks * teeth);
+    secp256k1_ecmult_gen_scalar_diff(&diff, ctx->blocks * ctx->teeth * ctx->spacing);
+    secp256k1_scalar_add(&ctx->scalar_offset, &ctx->scalar_offset, &diff);
+}
+
 /* Setup blinding values for secp256k1_ecmult_gen. */
 static void secp256k1_ecmult_gen_blind(secp256k1_ecmult_gen_context *ctx, const unsigned char *seed32) {
     secp256k1_scalar b;
@@ -292,7 +415,7 @@ static void secp256k1_ecmult_gen_blind(secp256k1_ecmult_gen_context *ctx, const
     unsigned char keydata[64];
 
     /* Compute the (2^COMB_BITS - 1)/2 term once. */
-    secp256k1_ecmult_gen_scalar_diff(&diff);
+    secp256k1_ecmult_gen_scalar_diff(&diff, ctx->blocks * ctx->teeth * ctx->spacing);
 
     if (seed32 == NULL) {
         /* When seed is NULL, reset the final point and blinding value. */
@@ -41,21 +41,53 @@
  */
 #endif
 
+static const secp256k1_ecmult_g_tables secp256k1_ecmult_g_tables_default = {
+    secp256k1_pre_g, secp256k1_pre_g_128, WINDOW_G
+};
+
 #define WNAF_BITS 128
 #define WNAF_SIZE_BITS(bits, w) CEIL_DIV(bits, w)
 #define WNAF_SIZE(w) WNAF_SIZE_BITS(WNAF_BITS, w)
 
 /* The number of objects allocated on the scratch space for ecmult_multi algorithms */
-#define PIPPENGER_SCRATCH_OBJECTS 6
+#define PIPPENGER_SCRATCH_OBJECTS 7
 #define STRAUSS_SCRATCH_OBJECTS 5
 
 #define PIPPENGER_MAX_BUCKET_WINDOW 12
 
+#if PIPPENGER_MAX_BUCKET_WINDOW != SECP256K1_ECMULT_MULTI_MAX_BUCKET_WINDOW
+#  error "PIPPENGER_MAX_BUCKET_WINDOW must match SECP256K1_ECMULT_MULTI_MAX_BUCKET_WINDOW"
+#endif
+
 /* Minimum number of points for which pippenger_wnaf is faster than strauss wnaf */
 #define ECMULT_PIPPENGER_THRESHOLD 88
 
 #define ECMULT_MAX_POINTS_PER_BATCH 5000000
 
+/* Objects allocated to coalesce repeated points, and the maximum number of
+ * hash table slots probed per point. */
+#define ECMULT_MULTI_DEDUP_SCRATCH_OBJECTS 3
+#define ECMULT_MULTI_DEDUP_MAX_PROBES 16
+
+/* Pippenger's algorithm is split into at most this many tasks. */
+#define ECMULT_PIPPENGER_MAX_TASKS 256
+/* Minimum number of points (after splitting with the endomorphism) per
+ * Pippenger task. Smaller tasks spend most of their time summing buckets. */
+#define ECMULT_PIPPENGER_MIN_TASK_POINTS 64
+
+/* Minimum bucket window for which Pippenger's buckets are accumulated in
+ * affine coordinates, sharing one inversion between many additions. With
+ * fewer points per bucket, the rounds of additions are too small to make up
+ * for the inversions. */
+#define ECMULT_PIPPENGER_AFFINE_MIN_WINDOW 9
+/* Maximum number of affine bucket additions sharing an inversion. Rounds much
+ * smaller than the number of buckets keep collisions (points that have to
+ * wait for the next round because their bucket is busy) rare. */
+#define ECMULT_PIPPENGER_AFFINE_ROUND_SIZE(w) (ECMULT_TABLE_SIZE((w)+2) >> 3)
+/* Once the last rounds of affine bucket additions have fewer additions than
+ * this, the remaining ones are done in Jacobian coordinates. */
+#define ECMULT_PIPPENGER_AFFINE_MIN_ROUND 16
+
 /** Fill a table 'pre_a' with precomputed odd multiples of a.
  *  pre_a will contain [1*a,3*a,...,(2*n-1)*a], so it needs space for n group elements.
  *  zr needs space for n field elements.
@@ -231,7 +263,7 @@ struct secp256k1_strauss_state {
     struct secp256k1_strauss_point_state* ps;
 };
 
-static void secp256k1_ecmult_strauss_wnaf(const struct secp256k1_strauss_state *state, secp256k1_gej *r, size_t num, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng) {
+static void secp256k1_ecmult_strauss_wnaf(const struct secp256k1_strauss_state *state, const secp256k1_ecmult_g_tables *gt, secp256k1_gej *r, size_t num, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng) {
     secp256k1_ge tmpa;
     secp256k1_fe Z;
     /* Split G factors. */
@@ -303,8 +335,8 @@ static void secp256k1_ecmult_strauss_wnaf(const struct secp256k1_strauss_state *
         secp256k1_scalar_split_128(&ng_1, &ng_128, ng);
 
         /* Build wnaf representation for ng_1 and ng_128 */
-        bits_ng_1   = secp256k1_ecmult_wnaf(wnaf_ng_1,   129, &ng_1,   WINDOW_G);
-        bits_ng_128 = secp256k1_ecmult_wnaf(wnaf_ng_128, 129, &ng_128, WINDOW_G);
+        bits_ng_1   = secp256k1_ecmult_wnaf(wnaf_ng_1,   129, &ng_1,   gt->window_g);
+        bits_ng_128 = secp256k1_ecmult_wnaf(wnaf_ng_128, 129, &ng_128, gt->window_g);
         if (bits_ng_1 > bits) {
             bits = bits_ng_1;
         }
@@ -329,11 +361,11 @@ static void secp256k1_ecmult_strauss_wnaf(const struct secp256k1_strauss_state *
             }
         }
         if (i < bits_ng_1 && (n = wnaf_ng_1[i])) {
-            secp256k1_ecmult_table_get_ge_storage(&tmpa, secp256k1_pre_g, n, WINDOW_G);
+            secp256k1_ecmult_table_get_ge_storage(&tmpa, gt->pre_g, n, gt->window_g);
             secp256k1_gej_add_zinv_var(r, r, &tmpa, &Z);
         }
         if (i < bits_ng_128 && (n = wnaf_ng_128[i])) {
-            secp256k1_ecmult_table_get_ge_storage(&tmpa, secp256k1_pre_g_128, n, WINDOW_G);
+            secp256k1_ecmult_table_get_ge_storage(&tmpa, gt->pre_g_128, n, gt->window_g);
             secp256k1_gej_add_zinv_var(r, r, &tmpa, &Z);
         }
     }
@@ -343,7 +375,7 @@ static void secp256k1_ecmult_strauss_wnaf(const struct secp256k1_strauss_state *
     }
 }
 
-static void secp256k1_ecmult(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng) {
+static void secp256k1_ecmult_tables(const secp256k1_ecmult_g_tables *gt, secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng) {
     secp256k1_fe aux[ECMULT_TABLE_SIZE(WINDOW_A)];
     secp256k1_ge pre_a[ECMULT_TABLE_SIZE(WINDOW_A)];
     struct secp256k1_strauss_point_state ps[1];
@@ -352,7 +384,96 @@ static void secp256k1_ecmult(secp256k1_gej *r, const secp256k1_gej *a, const sec
     state.aux = aux;
     state.pre_a = pre_a;
     state.ps = ps;
-    secp256k1_ecmult_strauss_wnaf(&state, r, 1, a, na, ng);
+    secp256k1_ecmult_strauss_wnaf(&state, gt, r, 1, a, na, ng);
+}
+
+static void secp256k1_ecmult(secp256k1_gej *r, const secp256k1_gej *a, const secp256k1_scalar *na, const secp256k1_scalar *ng) {
+    secp256k1_ecmult_tables(&secp256k1_ecmult_g_tables_default, r, a, na, ng);
+}
+
+/* Fills pre with the odd multiples of a in affine coordinates. */
+static void secp256k1_ecmult_prepared_table_fill(secp256k1_ge_storage *pre, const secp256k1_gej *a) {
+    secp256k1_ge pre_a[ECMULT_TABLE_SIZE(ECMULT_PREPARED_WINDOW)];
+    secp256k1_fe zr[ECMULT_TABLE_SIZE(ECMULT_PREPARED_WINDOW)];
+    secp256k1_fe zi;
+    int i;
+
+    secp256k1_ecmult_odd_multiples_table(ECMULT_TABLE_SIZE(ECMULT_PREPARED_WINDOW), pre_a, zr, &zi, a);
+    /* Bring the table to the z coordinate of its last entry, and convert it
+     * to affine coordinates with a single inversion. */
+    secp256k1_ge_table_set_globalz(ECMULT_TABLE_SIZE(ECMULT_PREPARED_WINDOW), pre_a, zr);
+    secp256k1_fe_inv_var(&zi, &zi);
+    for (i = 0; i < ECMULT_TABLE_SIZE(ECMULT_PREPARED_WINDOW); i++) {
+        secp256k1_gej tmpj;
+        secp256k1_ge tmp;
+        secp256k1_gej_set_ge(&tmpj, &pre_a[i]);
+        secp256k1_ge_set_gej_zinv(&tmp, &tmpj, &zi);
+        secp256k1_ge_to_storage(&pre[i], &tmp);
+    }
+}
+
+static void secp256k1_ecmult_prepared_table_build(secp256k1_ecmult_prepared_table *pre, const secp256k1_ge *a) {
+    secp256k1_gej aj;
+    int i;
+
+    VERIFY_CHECK(!secp256k1_ge_is_infinity(a));
+    secp256k1_gej_set_ge(&aj, a);
+    secp256k1_ecmult_prepared_table_fill(pre->pre, &aj);
+    for (i = 0; i < 128; i++) {
+        secp256k1_gej_double_var(&aj, &aj, NULL);
+    }
+    secp256k1_ecmult_prepared_table_fill(pre->pre_128, &aj);
+}
+
+static void secp256k1_ecmult_prepared(const secp256k1_ecmult_g_tables *gt, secp256k1_gej *r, const secp256k1_ecmult_prepared_table *pre, const secp256k1_scalar *na, const secp256k1_scalar *ng) {
+    secp256k1_ge tmpa;
+    /* Split both factors into 128-bit halves. */
+    secp256k1_scalar na_1, na_128, ng_1, ng_128;
+    int wnaf_na_1[129], wnaf_na_128[129];
+    int wnaf_ng_1[129], wnaf_ng_128[129];
+    int bits_na_1, bits_na_128;
+    int bits_ng_1 = 0, bits_ng_128 = 0;
+    int bits;
+    int i;
+
+    secp256k1_scalar_split_128(&na_1, &na_128, na);
+    bits_na_1   = secp256k1_ecmult_wnaf(wnaf_na_1,   129, &na_1,   ECMULT_PREPARED_WINDOW);
+    bits_na_128 = secp256k1_ecmult_wnaf(wnaf_na_128, 129, &na_128, ECMULT_PREPARED_WINDOW);
+    bits = bits_na_1 > bits_na_128 ? bits_na_1 : bits_na_128;
+    if (ng) {
+        secp256k1_scalar_split_128(&ng_1, &ng_128, ng);
+        bits_ng_1   = secp256k1_ecmult_wnaf(wnaf_ng_1,   129, &ng_1,   gt->window_g);
+        bits_ng_128 = secp256k1_ecmult_wnaf(wnaf_ng_128, 129, &ng_128, gt->window_g);
+        if (bits_ng_1 > bits) {
+            bits = bits_ng_1;
+        }
+        if (bits_ng_128 > bits) {
+            bits = bits_ng_128;
+        }
+    }
+
+    /* All tables are affine, so every addition is a mixed one. */
+    secp256k1_gej_set_infinity(r);
+    for (i = bits - 1; i >= 0; i--) {
+        int n;
+        secp256k1_gej_double_var(r, r, NULL);
+        if (i < bits_na_1 && (n = wnaf_na_1[i])) {
+            secp256k1_ecmult_table_get_ge_storage(&tmpa, pre->pre, n, ECMULT_PREPARED_WINDOW);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+        if (i < bits_na_128 && (n = wnaf_na_128[i])) {
+            secp256k1_ecmult_table_get_ge_storage(&tmpa, pre->pre_128, n, ECMULT_PREPARED_WINDOW);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+        if (i < bits_ng_1 && (n = wnaf_ng_1[i])) {
+            secp256k1_ecmult_table_get_ge_storage(&tmpa, gt->pre_g, n, gt->window_g);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+        if (i < bits_ng_128 && (n = wnaf_ng_128[i])) {
+            secp256k1_ecmult_table_get_ge_storage(&tmpa, gt->pre_g_128, n, gt->window_g);
+            secp256k1_gej_add_ge_var(r, r, &tmpa, NULL);
+        }
+    }
 }
 
 static size_t secp256k1_strauss_scratch_size(size_t n_points) {
@@ -394,7 +515,7 @@ static int secp256k1_ecmult_strauss_batch(const secp256k1_callback* error_callba
         }
         secp256k1_gej_set_ge(&points[i], &point);
     }
-    secp256k1_ecmult_strauss_wnaf(&state, r, n_points, points, scalars, inp_g_sc);
+    secp256k1_ecmult_strauss_wnaf(&state, &secp256k1_ecmult_g_tables_default, r, n_points, points, scalars, inp_g_sc);
     secp256k1_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
     return 1;
 }
@@ -482,17 +603,231 @@ struct secp256k1_pippenger_point_state {
     size_t input_pos;
 };
 
+/* Buckets in affine coordinates, used for bucket windows of at least
+ * ECMULT_PIPPENGER_AFFINE_MIN_WINDOW. The additions into the buckets are done
+ * in rounds of at most ECMULT_PIPPENGER_AFFINE_ROUND_SIZE additions, each into
+ * a different bucket, so that all additions of a round can share a single
+ * field inversion. */
+struct secp256k1_pippenger_affine_state {
+    secp256k1_ge *buckets;
+    /* Whether each bucket has an addition in the current round. */
+    unsigned char *busy;
+    /* The pending additions of the current round: the bucket, the point to
+     * add, and the denominator of the slope. */
+    int *pending;
+    secp256k1_ge *addends;
+    secp256k1_fe *den;
+    /* Prefix products of den, which are turned into the inverses of den. */
+    secp256k1_fe *inv;
+    /* Indices (into wnaf_na and ps) of points deferred to a later round. */
+    size_t *deferred;
+};
+
 struct secp256k1_pippenger_state {
     int *wnaf_na;
     struct secp256k1_pippenger_point_state* ps;
+    /* NULL if buckets are in Jacobian coordinates. */
+    struct secp256k1_pippenger_affine_state *affine;
+};
+
+/* A disjoint range of points processed with its own buckets and state. */
+struct secp256k1_pippenger_task {
+    secp256k1_gej *buckets;
+    int bucket_window;
+    struct secp256k1_pippenger_state state;
+    struct secp256k1_pippenger_affine_state affine;
+    const secp256k1_scalar *sc;
+    const secp256k1_ge *pt;
+    size_t num;
+    secp256k1_gej r;
 };
 
+/* Returns whether buckets are accumulated in affine coordinates for a given
+ * bucket_window. */
+static int secp256k1_pippenger_affine_buckets(int bucket_window) {
+    return bucket_window >= ECMULT_PIPPENGER_AFFINE_MIN_WINDOW;
+}
+
+/* Sets r to the point given by wnaf digit n (which must be nonzero) of point
+ * a and returns the index of its bucket. */
+SECP256K1_INLINE static int secp256k1_pippenger_digit(secp256k1_ge *r, int n, const secp256k1_ge *a) {
+    if (n > 0) {
+        *r = *a;
+        return (n - 1)/2;
+    }
+    secp256k1_ge_neg(r, a);
+    return -(n + 1)/2;
+}
+
+/* Performs the pending additions of the current round of affine bucket
+ * accumulation, using one inversion for all of them (Montgomery's trick). */
+static void secp256k1_pippenger_affine_apply(struct secp256k1_pippenger_affine_state *aff, size_t n_pending) {
+    secp256k1_fe u;
+    size_t k;
+
+    if (n_pending == 0) {
+        return;
+    }
+    secp256k1_fe_inv_var(&u, &aff->inv[n_pending - 1]);
+    for (k = n_pending - 1; k > 0; k--) {
+        secp256k1_fe_mul(&aff->inv[k], &aff->inv[k - 1], &u);
+        secp256k1_fe_mul(&u, &u, &aff->den[k]);
+    }
+    aff->inv[0] = u;
+
+    for (k = 0; k < n_pending; k++) {
+        int idx = aff->pending[k];
+        secp256k1_ge *a = &aff->buckets[idx];
+        const secp256k1_ge *b = &aff->addends[k];
+        secp256k1_fe lambda, x3, y3, t;
+
+        /* lambda = (y2 - y1)/(x2 - x1), x3 = lambda^2 - x1 - x2,
+         * y3 = lambda*(x1 - x3) - y1 */
+        secp256k1_fe_negate(&t, &a->y, SECP256K1_GE_Y_MAGNITUDE_MAX);
+        secp256k1_fe_add(&t, &b->y);
+        secp256k1_fe_mul(&lambda, &t, &aff->inv[k]);
+        secp256k1_fe_sqr(&x3, &lambda);
+        secp256k1_fe_negate(&t, &a->x, SECP256K1_GE_X_MAGNITUDE_MAX);
+        secp256k1_fe_add(&x3, &t);
+        secp256k1_fe_negate(&t, &b->x, SECP256K1_GE_X_MAGNITUDE_MAX);
+        secp256k1_fe_add(&x3, &t);
+        secp256k1_fe_normalize_weak(&x3);
+        secp256k1_fe_negate(&t, &x3, 1);
+        secp256k1_fe_add(&t, &a->x);
+        secp256k1_fe_mul(&y3, &lambda, &t);
+        secp256k1_fe_negate(&t, &a->y, SECP256K1_GE_Y_MAGNITUDE_MAX);
+        secp256k1_fe_add(&y3, &t);
+        secp256k1_fe_normalize_weak(&y3);
+        secp256k1_ge_set_xy(a, &x3, &y3);
+        aff->busy[idx] = 0;
+    }
+}
+
+/* Schedules the addition of point a with wnaf digit n into its affine bucket.
+ * Returns 0 if the bucket already has an addition in the current round, in
+ * which case the point must be retried in a later round. */
+static int secp256k1_pippenger_affine_add(struct secp256k1_pippenger_affine_state *aff, size_t *n_pending, int n, const secp256k1_ge *a) {
+    secp256k1_ge *b = &aff->addends[*n_pending];
+    secp256k1_fe *den = &aff->den[*n_pending];
+    secp256k1_ge *bucket;
+    int idx;
+
+    if (n == 0) {
+        return 1;
+    }
+    idx = n > 0 ? (n - 1)/2 : -(n + 1)/2;
+    if (aff->busy[idx]) {
+        return 0;
+    }
+    bucket = &aff->buckets[idx];
+    secp256k1_pippenger_digit(b, n, a);
+    if (secp256k1_ge_is_infinity(bucket)) {
+        *bucket = *b;
+        return 1;
+    }
+    secp256k1_fe_negate(den, &bucket->x, SECP256K1_GE_X_MAGNITUDE_MAX);
+    secp256k1_fe_add(den, &b->x);
+    if (secp256k1_fe_normalizes_to_zero_var(den)) {
+        /* Same x coordinate: the bucket is either doubled or becomes
+         * infinity. */
+        secp256k1_fe t;
+        secp256k1_fe_negate(&t, &bucket->y, SECP256K1_GE_Y_MAGNITUDE_MAX);
+        secp256k1_fe_add(&t, &b->y);
+        if (secp256k1_fe_normalizes_to_zero_var(&t)) {
+            secp256k1_gej tmpj;
+            secp256k1_gej_set_ge(&tmpj, b);
+            secp256k1_gej_double_var(&tmpj, &tmpj, NULL);
+            secp256k1_ge_set_gej_var(bucket, &tmpj);
+        } else {
+            secp256k1_ge_set_infinity(bucket);
+        }
+        return 1;
+    }
+    if (*n_pending == 0) {
+        aff->inv[0] = *den;
+    } else {
+        secp256k1_fe_mul(&aff->inv[*n_pending], &aff->inv[*n_pending - 1], den);
+    }
+    aff->busy[idx] = 1;
+    aff->pending[(*n_pending)++] = idx;
+    return 1;
+}
+
+/* Adds the points of window i into the affine buckets. */
+static void secp256k1_ecmult_pippenger_fill_affine(struct secp256k1_pippenger_affine_state *aff, int bucket_window, const struct secp256k1_pippenger_state *state, size_t n_wnaf, int i, const secp256k1_ge *pt, size_t no) {
+    size_t max_pending = ECMULT_PIPPENGER_AFFINE_ROUND_SIZE(bucket_window);
+    size_t np = 0;
+    size_t n_deferred = 0;
+    size_t k;
+    int j;
+
+    for (j = 0; j < ECMULT_TABLE_SIZE(bucket_window+2); j++) {
+        secp256k1_ge_set_infinity(&aff->buckets[j]);
+    }
+    memset(aff->busy, 0, ECMULT_TABLE_SIZE(bucket_window+2));
+
+    while (np < no || n_deferred > 0) {
+        size_t n_pending = 0;
+        size_t n_retry = n_deferred;
+
+        /* Retry the deferred points first, then continue with new ones until
+         * the round is full. */
+        n_deferred = 0;
+        for (k = 0; k < n_retry; k++) {
+            size_t nq = aff->deferred[k];
+            if (n_pending == max_pending || !secp256k1_pippenger_affine_add(aff, &n_pending, state->wnaf_na[nq*n_wnaf + i], &pt[state->ps[nq].input_pos])) {
+                aff->deferred[n_deferred++] = nq;
+            }
+        }
+        for (; np < no && n_pending < max_pending; np++) {
+            if (!secp256k1_pippenger_affine_add(aff, &n_pending, state->wnaf_na[np*n_wnaf + i], &pt[state->ps[np].input_pos])) {
+                aff->deferred[n_deferred++] = np;
+            }
+        }
+        secp256k1_pippenger_affine_apply(aff, n_pending);
+
+        if (np == no && n_pending < ECMULT_PIPPENGER_AFFINE_MIN_ROUND) {
+            break;
+        }
+    }
+
+    /* The remaining points belong to only a few buckets (all of which were
+     * pending in the last round), so rounds would be dominated by the
+     * inversion. Sum the points of each bucket in Jacobian coordinates
+     * instead. */
+    while (n_deferred > 0) {
+        size_t n_rest = 0;
+        size_t np0 = aff->deferred[0];
+        secp256k1_gej sum;
+        secp256k1_ge tmp;
+        int idx0 = secp256k1_pippenger_digit(&tmp, state->wnaf_na[np0*n_wnaf + i], &pt[state->ps[np0].input_pos]);
+
+        secp256k1_gej_set_ge(&sum, &aff->buckets[idx0]);
+        for (k = 0; k < n_deferred; k++) {
+            size_t nq = aff->deferred[k];
+            int idx = secp256k1_pippenger_digit(&tmp, state->wnaf_na[nq*n_wnaf + i], &pt[state->ps[nq].input_pos]);
+
+            if (idx != idx0) {
+                aff->deferred[n_rest++] = nq;
+                continue;
+            }
+            secp256k1_gej_add_ge_var(&sum, &sum, &tmp, NULL);
+        }
+        secp256k1_ge_set_gej_var(&aff->buckets[idx0], &sum);
+        n_deferred = n_rest;
+    }
+}
+
 /*
  * pippenger_wnaf computes the result of a multi-point multiplication as
  * follows: The scalars are brought into wnaf with n_wnaf elements each. Then
  * for every i < n_wnaf, first each point is added to a "bucket" corresponding
  * to the point's wnaf[i]. Second, the buckets are added together such that
  * r += 1*bucket[0] + 3*bucket[1] + 5*bucket[2] + ...
+ *
+ * If state->affine is not NULL, the buckets are kept in affine coordinates
+ * (and the buckets argument is unused), which makes the additions into the
+ * buckets cheaper when there are many points per bucket.
  */
 static int secp256k1_ecmult_pippenger_wnaf(secp256k1_gej *buckets, int bucket_window, struct secp256k1_pippenger_state *state, secp256k1_gej *r, const secp256k1_scalar *sc, const secp256k1_ge *pt, size_t num) {
     size_t n_wnaf = WNAF_SIZE(bucket_window+1);
@@ -518,6 +853,36 @@ static int secp256k1_ecmult_pippenger_wnaf(secp256k1_gej *buckets, int bucket_wi
     for (i = n_wnaf - 1; i >= 0; i--) {
         secp256k1_gej running_sum;
 
+        for(j = 0; j < bucket_window; j++) {
+            secp256k1_gej_double_var(r, r, NULL);
+        }
+
+        secp256k1_gej_set_infinity(&running_sum);
+        if (state->affine != NULL) {
+            const secp256k1_ge *aff_buckets = state->affine->buckets;
+
+            secp256k1_ecmult_pippenger_fill_affine(state->affine, bucket_window, state, n_wnaf, i, pt, no);
+            /* See below. */
+            for(j = ECMULT_TABLE_SIZE(bucket_window+2) - 1; j > 0; j--) {
+                secp256k1_gej_add_ge_var(&running_sum, &running_sum, &aff_buckets[j], NULL);
+                secp256k1_gej_add_var(r, r, &running_sum, NULL);
+            }
+            secp256k1_gej_add_ge_var(&running_sum, &running_sum, &aff_buckets[0], NULL);
+            if (i == 0) {
+                /* correct for wnaf skew, which only affects bucket[0] */
+                for (np = 0; np < no; ++np) {
+                    if (state->ps[np].skew_na) {
+                        secp256k1_ge tmp;
+                        secp256k1_ge_neg(&tmp, &pt[state->ps[np].input_pos]);
+                        secp256k1_gej_add_ge_var(&running_sum, &running_sum, &tmp, NULL);
+                    }
+                }
+            }
+            secp256k1_gej_double_var(r, r, NULL);
+            secp256k1_gej_add_var(r, r, &running_sum, NULL);
+            continue;
+        }
+
         for(j = 0; j < ECMULT_TABLE_SIZE(bucket_window+2); j++) {
             secp256k1_gej_set_infinity(&buckets[j]);
         }
@@ -546,11 +911,6 @@ static int secp256k1_ecmult_pippenger_wnaf(secp256k1_gej *buckets, int bucket_wi
             }
         }
 
-        for(j = 0; j < bucket_window; j++) {
-            secp256k1_gej_double_var(r, r, NULL);
-        }
-
-        secp256k1_gej_set_infinity(&running_sum);
         /* Accumulate the sum: bucket[0] + 3*bucket[1] + 5*bucket[2] + 7*bucket[3] + ...
          *                   = bucket[0] +   bucket[1] +   bucket[2] +   bucket[3] + ...
          *                   +         2 *  (bucket[1] + 2*bucket[2] + 3*bucket[3] + ...)
@@ -571,6 +931,18 @@ static int secp256k1_ecmult_pippenger_wnaf(secp256k1_gej *buckets, int bucket_wi
     return 1;
 }
 
+static void secp256k1_ecmult_pippenger_task(size_t idx, void *data) {
+    struct secp256k1_pippenger_task *task = &((struct secp256k1_pippenger_task *)data)[idx];
+    secp256k1_ecmult_pippenger_wnaf(task->buckets, task->bucket_window, &task->state, &task->r, task->sc, task->pt, task->num);
+}
+
+/* Returns the number of tasks Pippenger's algorithm may be split into with
+ * the executor of the given scratch space. */
+static size_t secp256k1_pippenger_max_tasks(const secp256k1_scratch *scratch) {
+    size_t n_tasks = secp256k1_scratch_n_tasks(scratch);
+    return n_tasks > ECMULT_PIPPENGER_MAX_TASKS ? ECMULT_PIPPENGER_MAX_TASKS : n_tasks;
+}
+
 /**
  * Returns optimal bucket_window (number of bits of a scalar represented by a
  * set of buckets) for a given number of points.
@@ -622,6 +994,62 @@ static size_t secp256k1_pippenger_bucket_window_inv(int bucket_window) {
     return 0;
 }
 
+/* Sets tuning to the defaults, i.e., ECMULT_PIPPENGER_THRESHOLD and the
+ * bucket windows of secp256k1_pippenger_bucket_window. */
+static void secp256k1_ecmult_multi_tuning_init(secp256k1_ecmult_multi_tuning *tuning) {
+    int bucket_window;
+
+    tuning->pippenger_threshold = ECMULT_PIPPENGER_THRESHOLD;
+    for (bucket_window = 1; bucket_window < PIPPENGER_MAX_BUCKET_WINDOW; bucket_window++) {
+        tuning->bucket_window_max_points[bucket_window - 1] = secp256k1_pippenger_bucket_window_inv(bucket_window);
+    }
+}
+
+static int secp256k1_ecmult_multi_tuning_is_valid(const secp256k1_ecmult_multi_tuning *tuning) {
+    int i;
+
+    for (i = 1; i < PIPPENGER_MAX_BUCKET_WINDOW - 1; i++) {
+        if (tuning->bucket_window_max_points[i] < tuning->bucket_window_max_points[i - 1]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Returns the minimum number of points for Pippenger's algorithm with the
+ * tuning of a scratch space. */
+static size_t secp256k1_pippenger_threshold(const secp256k1_scratch *scratch) {
+    return scratch->has_tuning ? scratch->tuning.pippenger_threshold : ECMULT_PIPPENGER_THRESHOLD;
+}
+
+/* Same as secp256k1_pippenger_bucket_window, but with the tuning of a scratch
+ * space. */
+static int secp256k1_pippenger_scratch_bucket_window(const secp256k1_scratch *scratch, size_t n) {
+    int bucket_window;
+
+    if (!scratch->has_tuning) {
+        return secp256k1_pippenger_bucket_window(n);
+    }
+    for (bucket_window = 1; bucket_window < PIPPENGER_MAX_BUCKET_WINDOW; bucket_window++) {
+        if (n <= scratch->tuning.bucket_window_max_points[bucket_window - 1]) {
+            return bucket_window;
+        }
+    }
+    return PIPPENGER_MAX_BUCKET_WINDOW;
+}
+
+/* Same as secp256k1_pippenger_bucket_window_inv, but with the tuning of a
+ * scratch space. */
+static size_t secp256k1_pippenger_scratch_bucket_window_inv(const secp256k1_scratch *scratch, int bucket_window) {
+    if (!scratch->has_tuning) {
+        return secp256k1_pippenger_bucket_window_inv(bucket_window);
+    }
+    if (bucket_window == PIPPENGER_MAX_BUCKET_WINDOW) {
+        return SIZE_MAX;
+    }
+    return scratch->tuning.bucket_window_max_points[bucket_window - 1];
+}
+
 
 SECP256K1_INLINE static void secp256k1_ecmult_endo_split(secp256k1_scalar *s1, secp256k1_scalar *s2, secp256k1_ge *p1, secp256k1_ge *p2) {
     secp256k1_scalar tmp = *s1;
@@ -638,14 +1066,37 @@ SECP256K1_INLINE static void secp256k1_ecmult_endo_split(secp256k1_scalar *s1, s
     }
 }
 
+/**
+ * Returns the scratch size of the buckets of one task for a given
+ * bucket_window.
+ */
+static size_t secp256k1_pippenger_bucket_size(int bucket_window) {
+    if (secp256k1_pippenger_affine_buckets(bucket_window)) {
+        return ((sizeof(secp256k1_ge) + 1) << bucket_window)
+            + ECMULT_PIPPENGER_AFFINE_ROUND_SIZE(bucket_window) * (sizeof(int) + sizeof(secp256k1_ge) + 2*sizeof(secp256k1_fe));
+    }
+    return sizeof(secp256k1_gej) << bucket_window;
+}
+
+/**
+ * Returns the scratch size per entry (point after splitting with the
+ * endomorphism) for a given bucket_window.
+ */
+static size_t secp256k1_pippenger_entry_size(int bucket_window) {
+    size_t entry_size = sizeof(secp256k1_ge) + sizeof(secp256k1_scalar) + sizeof(struct secp256k1_pippenger_point_state) + (WNAF_SIZE(bucket_window+1)+1)*sizeof(int);
+    if (secp256k1_pippenger_affine_buckets(bucket_window)) {
+        entry_size += sizeof(size_t);
+    }
+    return entry_size;
+}
+
 /**
  * Returns the scratch size required for a given number of points (excluding
- * base point G) without considering alignment.
+ * base point G) and tasks without considering alignment.
  */
-static size_t secp256k1_pippenger_scratch_size(size_t n_points, int bucket_window) {
+static size_t secp256k1_pippenger_scratch_size(size_t n_points, int bucket_window, size_t n_tasks) {
     size_t entries = 2*n_points + 2;
-    size_t entry_size = sizeof(secp256k1_ge) + sizeof(secp256k1_scalar) + sizeof(struct secp256k1_pippenger_point_state) + (WNAF_SIZE(bucket_window+1)+1)*sizeof(int);
-    return (sizeof(secp256k1_gej) << bucket_window) + sizeof(struct secp256k1_pippenger_state) + entries * entry_size;
+    return n_tasks * (secp256k1_pippenger_bucket_size(bucket_window) + sizeof(struct secp256k1_pippenger_task)) + entries * secp256k1_pippenger_entry_size(bucket_window);
 }
 
 static int secp256k1_ecmult_pippenger_batch(const secp256k1_callback* error_callback, secp256k1_scratch *scratch, secp256k1_gej *r, const secp256k1_scalar *inp_g_sc, secp256k1_ecmult_multi_callback cb, void *cbdata, size_t n_points, size_t cb_offset) {
@@ -654,20 +1105,30 @@ static int secp256k1_ecmult_pippenger_batch(const secp256k1_callback* error_call
      * sizes. The reason for +1 is that we add the G scalar to the list of
      * other scalars. */
     size_t entries = 2*n_points + 2;
+    const size_t max_tasks = secp256k1_pippenger_max_tasks(scratch);
     secp256k1_ge *points;
     secp256k1_scalar *scalars;
     secp256k1_gej *buckets;
-    struct secp256k1_pippenger_state *state_space;
+    struct secp256k1_pippenger_task *tasks;
+    struct secp256k1_pippenger_point_state *ps;
+    int *wnaf_na;
+    size_t *deferred = NULL;
+    size_t n_wnaf;
+    size_t n_tasks;
     size_t idx = 0;
     size_t point_idx = 0;
-    int i, j;
+    size_t offset;
+    size_t i;
     int bucket_window;
+    int affine;
 
     secp256k1_gej_set_infinity(r);
     if (inp_g_sc == NULL && n_points == 0) {
         return 1;
     }
-    bucket_window = secp256k1_pippenger_bucket_window(n_points);
+    bucket_window = secp256k1_pippenger_scratch_bucket_window(scratch, n_points);
+    n_wnaf = WNAF_SIZE(bucket_window+1);
+    affine = secp256k1_pippenger_affine_buckets(bucket_window);
 
     /* We allocate PIPPENGER_SCRATCH_OBJECTS objects on the scratch space. If
      * these allocations change, make sure to update the
@@ -675,15 +1136,20 @@ static int secp256k1_ecmult_pippenger_batch(const secp256k1_callback* error_call
      * accordingly. */
     points = (secp256k1_ge *) secp256k1_scratch_alloc(error_callback, scratch, entries * sizeof(*points));
     scalars = (secp256k1_scalar *) secp256k1_scratch_alloc(error_callback, scratch, entries * sizeof(*scalars));
-    state_space = (struct secp256k1_pippenger_state *) secp256k1_scratch_alloc(error_callback, scratch, sizeof(*state_space));
-    if (points == NULL || scalars == NULL || state_space == NULL) {
+    tasks = (struct secp256k1_pippenger_task *) secp256k1_scratch_alloc(error_callback, scratch, max_tasks * sizeof(*tasks));
+    if (points == NULL || scalars == NULL || tasks == NULL) {
         secp256k1_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
         return 0;
     }
-    state_space->ps = (struct secp256k1_pippenger_point_state *) secp256k1_scratch_alloc(error_callback, scratch, entries * sizeof(*state_space->ps));
-    state_space->wnaf_na = (int *) secp256k1_scratch_alloc(error_callback, scratch, entries*(WNAF_SIZE(bucket_window+1)) * sizeof(int));
-    buckets = (secp256k1_gej *) secp256k1_scratch_alloc(error_callback, scratch, ((size_t)1 << bucket_window) * sizeof(*buckets));
-    if (state_space->ps == NULL || state_space->wnaf_na == NULL || buckets == NULL) {
+    ps = (struct secp256k1_pippenger_point_state *) secp256k1_scratch_alloc(error_callback, scratch, entries * sizeof(*ps));
+    wnaf_na = (int *) secp256k1_scratch_alloc(error_callback, scratch, entries * n_wnaf * sizeof(int));
+    /* In affine mode, the buckets of each task hold the arrays of a
+     * secp256k1_pippenger_affine_state instead. */
+    buckets = (secp256k1_gej *) secp256k1_scratch_alloc(error_callback, scratch, max_tasks * secp256k1_pippenger_bucket_size(bucket_window));
+    if (affine) {
+        deferred = (size_t *) secp256k1_scratch_alloc(error_callback, scratch, entries * sizeof(*deferred));
+    }
+    if (ps == NULL || wnaf_na == NULL || buckets == NULL || (affine && deferred == NULL)) {
         secp256k1_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
         return 0;
     }
@@ -707,18 +1173,65 @@ static int secp256k1_ecmult_pippenger_batch(const secp256k1_callback* error_call
         point_idx++;
     }
 
-    secp256k1_ecmult_pippenger_wnaf(buckets, bucket_window, state_space, r, scalars, points, idx);
+    /* Split the points into disjoint ranges, each with its own buckets, and
+     * run them through the executor if there is one. */
+    n_tasks = idx / ECMULT_PIPPENGER_MIN_TASK_POINTS;
+    if (n_tasks > max_tasks) {
+        n_tasks = max_tasks;
+    }
+    if (n_tasks == 0 || scratch->executor == NULL) {
+        n_tasks = 1;
+    }
+    offset = 0;
+    for (i = 0; i < n_tasks; i++) {
+        tasks[i].buckets = (secp256k1_gej *) (void *) ((unsigned char *) buckets + i * secp256k1_pippenger_bucket_size(bucket_window));
+        tasks[i].bucket_window = bucket_window;
+        tasks[i].state.ps = &ps[offset];
+        tasks[i].state.wnaf_na = &wnaf_na[offset * n_wnaf];
+        tasks[i].state.affine = NULL;
+        if (affine) {
+            /* The arrays are ordered by decreasing alignment. */
+            size_t n_buckets = ECMULT_TABLE_SIZE(bucket_window+2);
+            size_t round_size = ECMULT_PIPPENGER_AFFINE_ROUND_SIZE(bucket_window);
+            tasks[i].affine.buckets = (secp256k1_ge *) (void *) tasks[i].buckets;
+            tasks[i].affine.addends = &tasks[i].affine.buckets[n_buckets];
+            tasks[i].affine.den = (secp256k1_fe *) (void *) &tasks[i].affine.addends[round_size];
+            tasks[i].affine.inv = &tasks[i].affine.den[round_size];
+            tasks[i].affine.pending = (int *) (void *) &tasks[i].affine.inv[round_size];
+            tasks[i].affine.busy = (unsigned char *) &tasks[i].affine.pending[round_size];
+            tasks[i].affine.deferred = &deferred[offset];
+            tasks[i].state.affine = &tasks[i].affine;
+        }
+        tasks[i].sc = &scalars[offset];
+        tasks[i].pt = &points[offset];
+        tasks[i].num = idx / n_tasks + (i < idx % n_tasks);
+        offset += tasks[i].num;
+    }
+    VERIFY_CHECK(offset == idx);
+    if (n_tasks == 1) {
+        secp256k1_ecmult_pippenger_task(0, tasks);
+    } else {
+        scratch->executor(secp256k1_ecmult_pippenger_task, tasks, n_tasks, scratch->executor_data);
+    }
+    for (i = 0; i < n_tasks; i++) {
+        secp256k1_gej_add_var(r, r, &tasks[i].r, NULL);
+    }
 
     /* Clear data */
-    for(i = 0; (size_t)i < idx; i++) {
+    for(i = 0; i < idx; i++) {
         secp256k1_scalar_clear(&scalars[i]);
-        state_space->ps[i].skew_na = 0;
-        for(j = 0; j < WNAF_SIZE(bucket_window+1); j++) {
-            state_space->wnaf_na[i * WNAF_SIZE(bucket_window+1) + j] = 0;
+        ps[i].skew_na = 0;
+    }
+    memset(wnaf_na, 0, idx * n_wnaf * sizeof(int));
+    if (affine) {
+        memset(buckets, 0, n_tasks * secp256k1_pippenger_bucket_size(bucket_window));
+    } else {
+        for(i = 0; i < (n_tasks << bucket_window); i++) {
+            secp256k1_gej_clear(&buckets[i]);
         }
     }
-    for(i = 0; i < 1<<bucket_window; i++) {
-        secp256k1_gej_clear(&buckets[i]);
+    for(i = 0; i < n_tasks; i++) {
+        secp256k1_gej_clear(&tasks[i].r);
     }
     secp256k1_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
     return 1;
@@ -736,18 +1249,18 @@ static int secp256k1_ecmult_pippenger_batch_single(const secp256k1_callback* err
  */
 static size_t secp256k1_pippenger_max_points(const secp256k1_callback* error_callback, secp256k1_scratch *scratch) {
     size_t max_alloc = secp256k1_scratch_max_allocation(error_callback, scratch, PIPPENGER_SCRATCH_OBJECTS);
+    size_t max_tasks = secp256k1_pippenger_max_tasks(scratch);
     int bucket_window;
     size_t res = 0;
 
     for (bucket_window = 1; bucket_window <= PIPPENGER_MAX_BUCKET_WINDOW; bucket_window++) {
         size_t n_points;
-        size_t max_points = secp256k1_pippenger_bucket_window_inv(bucket_window);
+        size_t max_points = secp256k1_pippenger_scratch_bucket_window_inv(scratch, bucket_window);
         size_t space_for_points;
         size_t space_overhead;
-        size_t entry_size = sizeof(secp256k1_ge) + sizeof(secp256k1_scalar) + sizeof(struct secp256k1_pippenger_point_state) + (WNAF_SIZE(bucket_window+1)+1)*sizeof(int);
+        size_t entry_size = 2*secp256k1_pippenger_entry_size(bucket_window);
 
-        entry_size = 2*entry_size;
-        space_overhead = (sizeof(secp256k1_gej) << bucket_window) + entry_size + sizeof(struct secp256k1_pippenger_state);
+        space_overhead = max_tasks * (secp256k1_pippenger_bucket_size(bucket_window) + sizeof(struct secp256k1_pippenger_task)) + entry_size;
         if (space_overhead > max_alloc) {
             break;
         }
@@ -814,7 +1327,7 @@ static int secp256k1_ecmult_multi_batch_size_helper(size_t *n_batches, size_t *n
 }
 
 typedef int (*secp256k1_ecmult_multi_func)(const secp256k1_callback* error_callback, secp256k1_scratch*, secp256k1_gej*, const secp256k1_scalar*, secp256k1_ecmult_multi_callback cb, void*, size_t);
-static int secp256k1_ecmult_multi_var(const secp256k1_callback* error_callback, secp256k1_scratch *scratch, secp256k1_gej *r, const secp256k1_scalar *inp_g_sc, secp256k1_ecmult_multi_callback cb, void *cbdata, size_t n) {
+static int secp256k1_ecmult_multi_batch_var(const secp256k1_callback* error_callback, secp256k1_scratch *scratch, secp256k1_gej *r, const secp256k1_scalar *inp_g_sc, secp256k1_ecmult_multi_callback cb, void *cbdata, size_t n) {
     size_t i;
 
     int (*f)(const secp256k1_callback* error_callback, secp256k1_scratch*, secp256k1_gej*, const secp256k1_scalar*, secp256k1_ecmult_multi_callback cb, void*, size_t, size_t);
@@ -839,7 +1352,7 @@ static int secp256k1_ecmult_multi_var(const secp256k1_callback* error_callback,
     if (!secp256k1_ecmult_multi_batch_size_helper(&n_batches, &n_batch_points, secp256k1_pippenger_max_points(error_callback, scratch), n)) {
         return secp256k1_ecmult_multi_simple_var(r, inp_g_sc, cb, cbdata, n);
     }
-    if (n_batch_points >= ECMULT_PIPPENGER_THRESHOLD) {
+    if (n_batch_points >= secp256k1_pippenger_threshold(scratch)) {
         f = secp256k1_ecmult_pippenger_batch;
     } else {
         if (!secp256k1_ecmult_multi_batch_size_helper(&n_batches, &n_batch_points, secp256k1_strauss_max_points(error_callback, scratch), n)) {
@@ -860,4 +1373,147 @@ static int secp256k1_ecmult_multi_var(const secp256k1_callback* error_callback,
     return 1;
 }
 
+/* Returns the number of hash table slots used to coalesce n points, a power
+ * of two that is at least 2*n. */
+static size_t secp256k1_ecmult_multi_dedup_slots(size_t n) {
+    size_t slots = 2;
+    while (slots < 2*n) {
+        slots <<= 1;
+    }
+    return slots;
+}
+
+static size_t secp256k1_ecmult_multi_dedup_scratch_size(size_t n) {
+    return n * (sizeof(secp256k1_ge) + sizeof(secp256k1_scalar)) + secp256k1_ecmult_multi_dedup_slots(n) * sizeof(size_t);
+}
+
+struct secp256k1_ecmult_multi_dedup_data {
+    const secp256k1_scalar *sc;
+    const secp256k1_ge *pt;
+};
+
+static int secp256k1_ecmult_multi_dedup_callback(secp256k1_scalar *sc, secp256k1_ge *pt, size_t idx, void *data) {
+    const struct secp256k1_ecmult_multi_dedup_data *dedup = (const struct secp256k1_ecmult_multi_dedup_data *)data;
+    *sc = dedup->sc[idx];
+    *pt = dedup->pt[idx];
+    return 1;
+}
+
+/* Reads the n points starting at cb_offset and coalesces points with equal x
+ * coordinates by adding their scalars (or subtracting them if the points are
+ * negations of each other). Terms that are zero are dropped. The remaining
+ * terms are stored in sc and pt, and their number in *n_distinct.
+ *
+ * The points are found through a hash table with linear probing, keyed by the
+ * low bits of x. As the points may be chosen by an attacker, the number of
+ * probes per point is bounded; a point that is not found within the bound is
+ * kept as a separate term. */
+static int secp256k1_ecmult_multi_dedup(secp256k1_scalar *sc, secp256k1_ge *pt, size_t *n_distinct, size_t *table, size_t n_slots, secp256k1_ecmult_multi_callback cb, void *cbdata, size_t n, size_t cb_offset) {
+    size_t i, j, k = 0;
+
+    memset(table, 0, n_slots * sizeof(*table));
+    for (i = 0; i < n; i++) {
+        unsigned char x32[32];
+        size_t slot, probes;
+        if (!cb(&sc[k], &pt[k], i + cb_offset, cbdata)) {
+            return 0;
+        }
+        if (pt[k].infinity || secp256k1_scalar_is_zero(&sc[k])) {
+            continue;
+        }
+        secp256k1_fe_normalize_var(&pt[k].x);
+        secp256k1_fe_normalize_var(&pt[k].y);
+        secp256k1_fe_get_b32(x32, &pt[k].x);
+        slot = (size_t)secp256k1_read_be64(&x32[24]) & (n_slots - 1);
+        for (probes = 0; probes < ECMULT_MULTI_DEDUP_MAX_PROBES; probes++) {
+            if (table[slot] == 0) {
+                table[slot] = k + 1;
+                break;
+            }
+            j = table[slot] - 1;
+            if (secp256k1_fe_equal(&pt[j].x, &pt[k].x)) {
+                if (!secp256k1_fe_equal(&pt[j].y, &pt[k].y)) {
+                    secp256k1_scalar_negate(&sc[k], &sc[k]);
+                }
+                secp256k1_scalar_add(&sc[j], &sc[j], &sc[k]);
+                break;
+            }
+            slot = (slot + 1) & (n_slots - 1);
+        }
+        if (probes == ECMULT_MULTI_DEDUP_MAX_PROBES || table[slot] == k + 1) {
+            k++;
+        }
+    }
+
+    /* Drop the terms whose scalars cancelled out. */
+    j = 0;
+    for (i = 0; i < k; i++) {
+        if (!secp256k1_scalar_is_zero(&sc[i])) {
+            sc[j] = sc[i];
+            pt[j] = pt[i];
+            j++;
+        }
+    }
+    *n_distinct = j;
+    return 1;
+}
+
+/* Same as secp256k1_ecmult_multi_batch_var, but coalesces repeated points
+ * first. The points are processed in chunks that leave enough of the scratch
+ * space to multiply a whole chunk in a single batch if no point repeats. */
+static int secp256k1_ecmult_multi_dedup_var(const secp256k1_callback* error_callback, secp256k1_scratch *scratch, secp256k1_gej *r, const secp256k1_scalar *inp_g_sc, secp256k1_ecmult_multi_callback cb, void *cbdata, size_t n) {
+    const size_t scratch_checkpoint = secp256k1_scratch_checkpoint(error_callback, scratch);
+    size_t max_alloc = secp256k1_scratch_max_allocation(error_callback, scratch, ECMULT_MULTI_DEDUP_SCRATCH_OBJECTS);
+    struct secp256k1_ecmult_multi_dedup_data data;
+    secp256k1_scalar *sc = NULL;
+    secp256k1_ge *pt = NULL;
+    size_t *table = NULL;
+    size_t n_chunk = n;
+    size_t offset;
+
+    if (n_chunk > ECMULT_MAX_POINTS_PER_BATCH) {
+        n_chunk = ECMULT_MAX_POINTS_PER_BATCH;
+    }
+    while (n_chunk > 1 && secp256k1_ecmult_multi_dedup_scratch_size(n_chunk) > max_alloc) {
+        n_chunk -= n_chunk/8 + 1;
+    }
+    for (; n_chunk > 1; n_chunk -= n_chunk/8 + 1) {
+        sc = (secp256k1_scalar *)secp256k1_scratch_alloc(error_callback, scratch, n_chunk * sizeof(*sc));
+        pt = (secp256k1_ge *)secp256k1_scratch_alloc(error_callback, scratch, n_chunk * sizeof(*pt));
+        table = (size_t *)secp256k1_scratch_alloc(error_callback, scratch, secp256k1_ecmult_multi_dedup_slots(n_chunk) * sizeof(*table));
+        if (sc != NULL && pt != NULL && table != NULL && secp256k1_pippenger_max_points(error_callback, scratch) >= n_chunk) {
+            break;
+        }
+        secp256k1_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
+    }
+    if (n_chunk <= 1) {
+        /* The scratch space is too small to be worth splitting. */
+        return secp256k1_ecmult_multi_batch_var(error_callback, scratch, r, inp_g_sc, cb, cbdata, n);
+    }
+
+    data.sc = sc;
+    data.pt = pt;
+    secp256k1_gej_set_infinity(r);
+    for (offset = 0; offset < n; offset += n_chunk) {
+        size_t n_points = n - offset < n_chunk ? n - offset : n_chunk;
+        size_t n_distinct;
+        secp256k1_gej tmp;
+        if (!secp256k1_ecmult_multi_dedup(sc, pt, &n_distinct, table, secp256k1_ecmult_multi_dedup_slots(n_chunk), cb, cbdata, n_points, offset)
+            || !secp256k1_ecmult_multi_batch_var(error_callback, scratch, &tmp, offset == 0 ? inp_g_sc : NULL, secp256k1_ecmult_multi_dedup_callback, &data, n_distinct)) {
+            secp256k1_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
+            return 0;
+        }
+        secp256k1_gej_add_var(r, r, &tmp, NULL);
+    }
+    secp256k1_scratch_apply_checkpoint(error_callback, scratch, scratch_checkpoint);
+    return 1;
+}
+
+static int secp256k1_ecmult_multi_var(const secp256k1_callback* error_callback, secp256k1_scratch *scratch, secp256k1_gej *r, const secp256k1_scalar *inp_g_sc, secp256k1_ecmult_multi_callback cb, void *cbdata, size_t n) {
+    if (scratch != NULL && scratch->dedup && n > 1) {
+        return secp256k1_ecmult_multi_dedup_var(error_callback, scratch, r, inp_g_sc, cb, cbdata, n);
+    }
+    return secp256k1_ecmult_multi_batch_var(error_callback, scratch, r, inp_g_sc, cb, cbdata, n);
+}
+
 #endif /* SECP256K1_ECMULT_IMPL_H */
@@ -12,6 +12,11 @@
 #include "field.h"
 #include "modinv64_impl.h"
 
+/* There is intentionally no x86_64 assembly for secp256k1_fe_mul_inner and secp256k1_fe_sqr_inner.
+ * Handwritten versions, including one using MULX with separate ADCX/ADOX carry chains, have not
+ * been faster than what compilers generate from the C code below (which uses MULX by itself when
+ * the compiler targets BMI2), and the register constraints of inline assembly make the
+ * surrounding group operations slower. */
 #include "field_5x52_int128_impl.h"
 
 #ifdef VERIFY
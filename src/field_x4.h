@@ -0,0 +1,75 @@
+/***********************************************************************
+ * Distributed under the MIT software license, see the accompanying    *
+ * file COPYING or https://www.opensource.org/licenses/mit-license.php.*
+ ***********************************************************************/
+
+#ifndef SECP256K1_FIELD_X4_H
+#define SECP256K1_FIELD_X4_H
+
+#include "field.h"
+
+/* Four field elements in structure-of-arrays form, processed with AVX2.
+ *
+ * This is only available if the compiler targets AVX2 (which implies x86, so
+ * that the code below may rely on a little-endian byte order). Code that uses
+ * it must also have a path for SECP256K1_FE_X4 not being defined. */
+#if defined(__AVX2__)
+#define SECP256K1_FE_X4
+
+#include <immintrin.h>
+
+typedef struct {
+    /* Lane j of the 64-bit lanes of n[i] holds limb i of element j in the
+     * representation of field_10x26.h, and has the same bounds: a field
+     * element of magnitude m has limbs of at most 2*m*(2^26 - 1) (and at
+     * most 2*m*(2^22 - 1) for the top limb). The upper 32 bits of every lane
+     * are zero, so that the limbs can be multiplied with _mm256_mul_epu32.
+     * Magnitudes are not tracked at runtime; the functions below have the
+     * same requirements as the corresponding secp256k1_fe functions. */
+    __m256i n[10];
+} secp256k1_fe_x4;
+
+/** Set every lane of r to a. a must be normalized. */
+static void secp256k1_fe_x4_set_fe(secp256k1_fe_x4 *r, const secp256k1_fe *a);
+
+/** Set lane j of r to *a[j]. The result has magnitude 1 and is normalized. */
+static void secp256k1_fe_x4_set_storage(secp256k1_fe_x4 *r, const secp256k1_fe_storage * const *a);
+
+/** Set r[j] to lane j of a, which must be normalized. */
+static void secp256k1_fe_x4_get_storage(secp256k1_fe_storage *r, const secp256k1_fe_x4 *a);
+
+/** Multiply laneswise. Same requirements as secp256k1_fe_mul, except that r may alias a and b. */
+static void secp256k1_fe_x4_mul(secp256k1_fe_x4 *r, const secp256k1_fe_x4 *a, const secp256k1_fe_x4 *b);
+
+/** Square laneswise. Same requirements as secp256k1_fe_sqr. */
+static void secp256k1_fe_x4_sqr(secp256k1_fe_x4 *r, const secp256k1_fe_x4 *a);
+
+/** Add a to r laneswise. Same requirements as secp256k1_fe_add. */
+static void secp256k1_fe_x4_add(secp256k1_fe_x4 *r, const secp256k1_fe_x4 *a);
+
+/** Multiply r laneswise by a small integer. Same requirements as secp256k1_fe_mul_int. */
+static void secp256k1_fe_x4_mul_int(secp256k1_fe_x4 *r, int a);
+
+/** Negate a laneswise, whose magnitude is at most m. Same requirements as secp256k1_fe_negate. */
+static void secp256k1_fe_x4_negate(secp256k1_fe_x4 *r, const secp256k1_fe_x4 *a, int m);
+
+/** Halve r laneswise. Same requirements as secp256k1_fe_half. */
+static void secp256k1_fe_x4_half(secp256k1_fe_x4 *r);
+
+/** Normalize r laneswise to magnitude 1 (weakly). */
+static void secp256k1_fe_x4_normalize_weak(secp256k1_fe_x4 *r);
+
+/** Normalize r laneswise fully. Constant-time. */
+static void secp256k1_fe_x4_normalize(secp256k1_fe_x4 *r);
+
+/** Return a lane mask (all ones in the lanes of r that are zero modulo p, zero
+ *  in the others). Same requirements as secp256k1_fe_normalizes_to_zero. Constant-time. */
+static __m256i secp256k1_fe_x4_normalizes_to_zero(const secp256k1_fe_x4 *r);
+
+/** Set the lanes of r selected by mask (all ones or zero in every lane) to
+ *  those of a. Constant-time. */
+static void secp256k1_fe_x4_cmov(secp256k1_fe_x4 *r, const secp256k1_fe_x4 *a, __m256i mask);
+
+#endif
+
+#endif /* SECP256K1_FIELD_X4_H */
@@ -0,0 +1,557 @@
+/***********************************************************************
+ * Distributed under the MIT software license, see the accompanying    *
+ * file COPYING or https://www.opensource.org/licenses/mit-license.php.*
+ ***********************************************************************/
+
+#ifndef SECP256K1_FIELD_X4_IMPL_H
+#define SECP256K1_FIELD_X4_IMPL_H
+
+#include <string.h>
+
+#include "field_x4.h"
+#include "util.h"
+
+#ifdef SECP256K1_FE_X4
+
+/* Set r from the little-endian 32-bit words of four normalized field elements
+ * (w[j] holding the words of lane j), as in secp256k1_fe_impl_from_storage of
+ * field_10x26_impl.h. */
+static void secp256k1_fe_x4_set_words(secp256k1_fe_x4 *r, const uint32_t (*w)[8]) {
+    const __m256i vm = _mm256_set1_epi64x(0x3FFFFFFUL);
+    __m256i v[8];
+    int i;
+    for (i = 0; i < 8; i++) {
+        v[i] = _mm256_set_epi64x(w[3][i], w[2][i], w[1][i], w[0][i]);
+    }
+    r->n[0] = _mm256_and_si256(v[0], vm);
+    r->n[1] = _mm256_or_si256(_mm256_srli_epi64(v[0], 26), _mm256_and_si256(_mm256_slli_epi64(v[1], 6), vm));
+    r->n[2] = _mm256_or_si256(_mm256_srli_epi64(v[1], 20), _mm256_and_si256(_mm256_slli_epi64(v[2], 12), vm));
+    r->n[3] = _mm256_or_si256(_mm256_srli_epi64(v[2], 14), _mm256_and_si256(_mm256_slli_epi64(v[3], 18), vm));
+    r->n[4] = _mm256_or_si256(_mm256_srli_epi64(v[3], 8), _mm256_and_si256(_mm256_slli_epi64(v[4], 24), vm));
+    r->n[5] = _mm256_and_si256(_mm256_srli_epi64(v[4], 2), vm);
+    r->n[6] = _mm256_or_si256(_mm256_srli_epi64(v[4], 28), _mm256_and_si256(_mm256_slli_epi64(v[5], 4), vm));
+    r->n[7] = _mm256_or_si256(_mm256_srli_epi64(v[5], 22), _mm256_and_si256(_mm256_slli_epi64(v[6], 10), vm));
+    r->n[8] = _mm256_or_si256(_mm256_srli_epi64(v[6], 16), _mm256_and_si256(_mm256_slli_epi64(v[7], 16), vm));
+    r->n[9] = _mm256_srli_epi64(v[7], 10);
+}
+
+static void secp256k1_fe_x4_set_fe(secp256k1_fe_x4 *r, const secp256k1_fe *a) {
+    secp256k1_fe_storage s;
+    uint32_t w[4][8];
+    int j;
+    secp256k1_fe_to_storage(&s, a);
+    /* Both storage types hold the element in little-endian order. */
+    STATIC_ASSERT(sizeof(s) == sizeof(w[0]));
+    for (j = 0; j < 4; j++) {
+        memcpy(w[j], &s, sizeof(w[j]));
+    }
+    secp256k1_fe_x4_set_words(r, (const uint32_t (*)[8])w);
+}
+
+static void secp256k1_fe_x4_set_storage(secp256k1_fe_x4 *r, const secp256k1_fe_storage * const *a) {
+    uint32_t w[4][8];
+    int j;
+    STATIC_ASSERT(sizeof(*a[0]) == sizeof(w[0]));
+    for (j = 0; j < 4; j++) {
+        memcpy(w[j], a[j], sizeof(w[j]));
+    }
+    secp256k1_fe_x4_set_words(r, (const uint32_t (*)[8])w);
+}
+
+static void secp256k1_fe_x4_get_storage(secp256k1_fe_storage *r, const secp256k1_fe_x4 *a) {
+    uint64_t n[10][4];
+    uint32_t w[8];
+    int i, j;
+    for (i = 0; i < 10; i++) {
+        _mm256_storeu_si256((__m256i *)(void *)n[i], a->n[i]);
+    }
+    STATIC_ASSERT(sizeof(r[0]) == sizeof(w));
+    for (j = 0; j < 4; j++) {
+        /* As in secp256k1_fe_impl_to_storage of field_10x26_impl.h. */
+        w[0] = n[0][j] | n[1][j] << 26;
+        w[1] = n[1][j] >> 6 | n[2][j] << 20;
+        w[2] = n[2][j] >> 12 | n[3][j] << 14;
+        w[3] = n[3][j] >> 18 | n[4][j] << 8;
+        w[4] = n[4][j] >> 24 | n[5][j] << 2 | n[6][j] << 28;
+        w[5] = n[6][j] >> 4 | n[7][j] << 22;
+        w[6] = n[7][j] >> 10 | n[8][j] << 16;
+        w[7] = n[8][j] >> 16 | n[9][j] << 10;
+        memcpy(&r[j], w, sizeof(w));
+    }
+}
+
+/* Multiply the (up to 64-bit) lanes of a by k < 2^32. */
+static SECP256K1_INLINE __m256i secp256k1_fe_x4_mul_u32(__m256i a, uint32_t k) {
+    const __m256i vk = _mm256_set1_epi64x(k);
+    return _mm256_add_epi64(_mm256_mul_epu32(a, vk), _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), vk), 32));
+}
+
+/* The multiplication and squaring below perform the same operations as
+ * secp256k1_fe_mul_inner and secp256k1_fe_sqr_inner of field_10x26_impl.h (in
+ * every lane), whose comments contain the bounds of all intermediate values.
+ * Multiplications by constants that may exceed 32 bits use
+ * secp256k1_fe_x4_mul_u32, and those by powers of two use shifts. */
+static void secp256k1_fe_x4_mul(secp256k1_fe_x4 *r, const secp256k1_fe_x4 *a, const secp256k1_fe_x4 *b) {
+    __m256i c, d;
+    __m256i u0, u1, u2, u3, u4, u5, u6, u7, u8;
+    __m256i t9, t1, t0, t2, t3, t4, t5, t6, t7;
+    const __m256i vm = _mm256_set1_epi64x(0x3FFFFFFUL), vm22 = _mm256_set1_epi64x(0x03FFFFFUL);
+    const __m256i vr0 = _mm256_set1_epi64x(0x3D10UL);
+
+    d = _mm256_mul_epu32(a->n[0], b->n[9]);
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[1], b->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[2], b->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[3], b->n[6]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[4], b->n[5]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[5], b->n[4]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[6], b->n[3]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[7], b->n[2]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[8], b->n[1]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], b->n[0]));
+    t9 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_mul_epu32(a->n[0], b->n[0]);
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[1], b->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[2], b->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[3], b->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[4], b->n[6]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[5], b->n[5]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[6], b->n[4]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[7], b->n[3]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[8], b->n[2]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], b->n[1]));
+    u0 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u0, vr0));
+    t0 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u0, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[0], b->n[1]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[1], b->n[0]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[2], b->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[3], b->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[4], b->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[5], b->n[6]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[6], b->n[5]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[7], b->n[4]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[8], b->n[3]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], b->n[2]));
+    u1 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u1, vr0));
+    t1 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u1, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[0], b->n[2]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[1], b->n[1]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[2], b->n[0]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[3], b->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[4], b->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[5], b->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[6], b->n[6]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[7], b->n[5]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[8], b->n[4]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], b->n[3]));
+    u2 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u2, vr0));
+    t2 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u2, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[0], b->n[3]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[1], b->n[2]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[2], b->n[1]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[3], b->n[0]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[4], b->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[5], b->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[6], b->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[7], b->n[6]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[8], b->n[5]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], b->n[4]));
+    u3 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u3, vr0));
+    t3 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u3, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[0], b->n[4]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[1], b->n[3]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[2], b->n[2]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[3], b->n[1]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[4], b->n[0]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[5], b->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[6], b->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[7], b->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[8], b->n[6]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], b->n[5]));
+    u4 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u4, vr0));
+    t4 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u4, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[0], b->n[5]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[1], b->n[4]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[2], b->n[3]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[3], b->n[2]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[4], b->n[1]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[5], b->n[0]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[6], b->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[7], b->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[8], b->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], b->n[6]));
+    u5 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u5, vr0));
+    t5 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u5, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[0], b->n[6]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[1], b->n[5]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[2], b->n[4]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[3], b->n[3]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[4], b->n[2]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[5], b->n[1]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[6], b->n[0]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[7], b->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[8], b->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], b->n[7]));
+    u6 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u6, vr0));
+    t6 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u6, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[0], b->n[7]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[1], b->n[6]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[2], b->n[5]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[3], b->n[4]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[4], b->n[3]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[5], b->n[2]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[6], b->n[1]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[7], b->n[0]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[8], b->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], b->n[8]));
+    u7 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u7, vr0));
+    t7 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u7, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[0], b->n[8]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[1], b->n[7]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[2], b->n[6]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[3], b->n[5]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[4], b->n[4]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[5], b->n[3]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[6], b->n[2]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[7], b->n[1]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[8], b->n[0]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], b->n[9]));
+    u8 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u8, vr0));
+    r->n[3] = t3;
+    r->n[4] = t4;
+    r->n[5] = t5;
+    r->n[6] = t6;
+    r->n[7] = t7;
+    r->n[8] = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u8, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(d, vr0));
+    c = _mm256_add_epi64(c, t9);
+    r->n[9] = _mm256_and_si256(c, vm22);
+    c = _mm256_srli_epi64(c, 22);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(d, 14));
+    d = secp256k1_fe_x4_mul_u32(c, 0x3D1);
+    d = _mm256_add_epi64(d, t0);
+    r->n[0] = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    d = _mm256_add_epi64(d, _mm256_slli_epi64(c, 6));
+    d = _mm256_add_epi64(d, t1);
+    r->n[1] = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    d = _mm256_add_epi64(d, t2);
+    r->n[2] = d;
+}
+
+static void secp256k1_fe_x4_sqr(secp256k1_fe_x4 *r, const secp256k1_fe_x4 *a) {
+    __m256i c, d;
+    __m256i u0, u1, u2, u3, u4, u5, u6, u7, u8;
+    __m256i t9, t0, t1, t2, t3, t4, t5, t6, t7;
+    __m256i a2[9];
+    const __m256i vm = _mm256_set1_epi64x(0x3FFFFFFUL), vm22 = _mm256_set1_epi64x(0x03FFFFFUL);
+    const __m256i vr0 = _mm256_set1_epi64x(0x3D10UL);
+    int i;
+
+    for (i = 0; i < 9; i++) {
+        a2[i] = _mm256_slli_epi64(a->n[i], 1);
+    }
+
+    d = _mm256_mul_epu32(a2[0], a->n[9]);
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[1], a->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[2], a->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[3], a->n[6]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[4], a->n[5]));
+    t9 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_mul_epu32(a->n[0], a->n[0]);
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[1], a->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[2], a->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[3], a->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[4], a->n[6]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[5], a->n[5]));
+    u0 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u0, vr0));
+    t0 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u0, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[0], a->n[1]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[2], a->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[3], a->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[4], a->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[5], a->n[6]));
+    u1 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u1, vr0));
+    t1 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u1, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[0], a->n[2]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[1], a->n[1]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[3], a->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[4], a->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[5], a->n[7]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[6], a->n[6]));
+    u2 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u2, vr0));
+    t2 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u2, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[0], a->n[3]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[1], a->n[2]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[4], a->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[5], a->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[6], a->n[7]));
+    u3 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u3, vr0));
+    t3 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u3, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[0], a->n[4]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[1], a->n[3]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[2], a->n[2]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[5], a->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[6], a->n[8]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[7], a->n[7]));
+    u4 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u4, vr0));
+    t4 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u4, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[0], a->n[5]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[1], a->n[4]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[2], a->n[3]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[6], a->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[7], a->n[8]));
+    u5 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u5, vr0));
+    t5 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u5, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[0], a->n[6]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[1], a->n[5]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[2], a->n[4]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[3], a->n[3]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[7], a->n[9]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[8], a->n[8]));
+    u6 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u6, vr0));
+    t6 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u6, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[0], a->n[7]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[1], a->n[6]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[2], a->n[5]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[3], a->n[4]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a2[8], a->n[9]));
+    u7 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u7, vr0));
+    t7 = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u7, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[0], a->n[8]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[1], a->n[7]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[2], a->n[6]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a2[3], a->n[5]));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(a->n[4], a->n[4]));
+    d = _mm256_add_epi64(d, _mm256_mul_epu32(a->n[9], a->n[9]));
+    u8 = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(u8, vr0));
+    r->n[3] = t3;
+    r->n[4] = t4;
+    r->n[5] = t5;
+    r->n[6] = t6;
+    r->n[7] = t7;
+    r->n[8] = _mm256_and_si256(c, vm);
+    c = _mm256_srli_epi64(c, 26);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(u8, 10));
+    c = _mm256_add_epi64(c, _mm256_mul_epu32(d, vr0));
+    c = _mm256_add_epi64(c, t9);
+    r->n[9] = _mm256_and_si256(c, vm22);
+    c = _mm256_srli_epi64(c, 22);
+    c = _mm256_add_epi64(c, _mm256_slli_epi64(d, 14));
+    d = secp256k1_fe_x4_mul_u32(c, 0x3D1);
+    d = _mm256_add_epi64(d, t0);
+    r->n[0] = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    d = _mm256_add_epi64(d, _mm256_slli_epi64(c, 6));
+    d = _mm256_add_epi64(d, t1);
+    r->n[1] = _mm256_and_si256(d, vm);
+    d = _mm256_srli_epi64(d, 26);
+    d = _mm256_add_epi64(d, t2);
+    r->n[2] = d;
+}
+
+static void secp256k1_fe_x4_add(secp256k1_fe_x4 *r, const secp256k1_fe_x4 *a) {
+    int i;
+    for (i = 0; i < 10; i++) {
+        r->n[i] = _mm256_add_epi64(r->n[i], a->n[i]);
+    }
+}
+
+static void secp256k1_fe_x4_mul_int(secp256k1_fe_x4 *r, int a) {
+    const __m256i va = _mm256_set1_epi64x(a);
+    int i;
+    VERIFY_CHECK(a >= 0 && a <= 32);
+    for (i = 0; i < 10; i++) {
+        r->n[i] = _mm256_mul_epu32(r->n[i], va);
+    }
+}
+
+static void secp256k1_fe_x4_negate(secp256k1_fe_x4 *r, const secp256k1_fe_x4 *a, int m) {
+    const uint64_t k = 2 * (m + 1);
+    const __m256i v = _mm256_set1_epi64x(0x3FFFFFFUL * k);
+    int i;
+    VERIFY_CHECK(m >= 0 && m <= 31);
+    /* As in secp256k1_fe_impl_negate_unchecked of field_10x26_impl.h. */
+    r->n[0] = _mm256_sub_epi64(_mm256_set1_epi64x(0x3FFFC2FUL * k), a->n[0]);
+    r->n[1] = _mm256_sub_epi64(_mm256_set1_epi64x(0x3FFFFBFUL * k), a->n[1]);
+    for (i = 2; i < 9; i++) {
+        r->n[i] = _mm256_sub_epi64(v, a->n[i]);
+    }
+    r->n[9] = _mm256_sub_epi64(_mm256_set1_epi64x(0x03FFFFFUL * k), a->n[9]);
+}
+
+static void secp256k1_fe_x4_half(secp256k1_fe_x4 *r) {
+    const __m256i one = _mm256_set1_epi64x(1);
+    /* All ones (in the 26 limb bits) in the lanes in which r is odd. */
+    const __m256i mask = _mm256_and_si256(_mm256_sub_epi64(_mm256_setzero_si256(), _mm256_and_si256(r->n[0], one)), _mm256_set1_epi64x(0x3FFFFFFUL));
+    __m256i t[10];
+    int i;
+
+    /* As in secp256k1_fe_impl_half of field_10x26_impl.h: add p if r is odd, then shift. */
+    t[0] = _mm256_add_epi64(r->n[0], _mm256_and_si256(mask, _mm256_set1_epi64x(0x3FFFC2FUL)));
+    t[1] = _mm256_add_epi64(r->n[1], _mm256_and_si256(mask, _mm256_set1_epi64x(0x3FFFFBFUL)));
+    for (i = 2; i < 9; i++) {
+        t[i] = _mm256_add_epi64(r->n[i], mask);
+    }
+    t[9] = _mm256_add_epi64(r->n[9], _mm256_srli_epi64(mask, 4));
+    for (i = 0; i < 9; i++) {
+        r->n[i] = _mm256_add_epi64(_mm256_srli_epi64(t[i], 1), _mm256_slli_epi64(_mm256_and_si256(t[i + 1], one), 25));
+    }
+    r->n[9] = _mm256_srli_epi64(t[9], 1);
+}
+
+/* Reduce the top limb of t and propagate the carries, as the first pass of the
+ * normalization functions of field_10x26_impl.h. */
+static SECP256K1_INLINE void secp256k1_fe_x4_carry(__m256i *t) {
+    const __m256i vm = _mm256_set1_epi64x(0x3FFFFFFUL);
+    const __m256i x = _mm256_srli_epi64(t[9], 22);
+    int i;
+    t[9] = _mm256_and_si256(t[9], _mm256_set1_epi64x(0x03FFFFFUL));
+    t[0] = _mm256_add_epi64(t[0], _mm256_mul_epu32(x, _mm256_set1_epi64x(0x3D1UL)));
+    t[1] = _mm256_add_epi64(t[1], _mm256_slli_epi64(x, 6));
+    for (i = 0; i < 9; i++) {
+        t[i + 1] = _mm256_add_epi64(t[i + 1], _mm256_srli_epi64(t[i], 26));
+        t[i] = _mm256_and_si256(t[i], vm);
+    }
+}
+
+static void secp256k1_fe_x4_normalize_weak(secp256k1_fe_x4 *r) {
+    secp256k1_fe_x4_carry(r->n);
+}
+
+static void secp256k1_fe_x4_normalize(secp256k1_fe_x4 *r) {
+    const __m256i vm = _mm256_set1_epi64x(0x3FFFFFFUL);
+    const __m256i one = _mm256_set1_epi64x(1);
+    __m256i m, x;
+    int i;
+
+    secp256k1_fe_x4_carry(r->n);
+
+    /* At most a single final reduction is needed; check if the value is >= the field
+     * characteristic, as in secp256k1_fe_impl_normalize of field_10x26_impl.h. */
+    m = r->n[2];
+    for (i = 3; i < 9; i++) {
+        m = _mm256_and_si256(m, r->n[i]);
+    }
+    x = _mm256_and_si256(_mm256_cmpeq_epi64(r->n[9], _mm256_set1_epi64x(0x03FFFFFUL)), _mm256_cmpeq_epi64(m, vm));
+    x = _mm256_and_si256(x, _mm256_cmpgt_epi64(
+        _mm256_add_epi64(_mm256_add_epi64(r->n[1], _mm256_set1_epi64x(0x40UL)), _mm256_srli_epi64(_mm256_add_epi64(r->n[0], _mm256_set1_epi64x(0x3D1UL)), 26)),
+        vm));
+    x = _mm256_or_si256(_mm256_srli_epi64(r->n[9], 22), _mm256_and_si256(x, one));
+
+    /* Apply the final reduction (for constant-time behaviour, we do it always). */
+    r->n[0] = _mm256_add_epi64(r->n[0], _mm256_mul_epu32(x, _mm256_set1_epi64x(0x3D1UL)));
+    r->n[1] = _mm256_add_epi64(r->n[1], _mm256_slli_epi64(x, 6));
+    for (i = 0; i < 9; i++) {
+        r->n[i + 1] = _mm256_add_epi64(r->n[i + 1], _mm256_srli_epi64(r->n[i], 26));
+        r->n[i] = _mm256_and_si256(r->n[i], vm);
+    }
+    /* Mask off the possible multiple of 2^256 from the final reduction. */
+    r->n[9] = _mm256_and_si256(r->n[9], _mm256_set1_epi64x(0x03FFFFFUL));
+}
+
+static __m256i secp256k1_fe_x4_normalizes_to_zero(const secp256k1_fe_x4 *r) {
+    __m256i t[10], z0, z1;
+    int i;
+
+    /* As in secp256k1_fe_impl_normalizes_to_zero of field_10x26_impl.h: z0 tracks
+     * a possible raw value of 0, z1 tracks a possible raw value of P. */
+    for (i = 0; i < 10; i++) {
+        t[i] = r->n[i];
+    }
+    secp256k1_fe_x4_carry(t);
+    z0 = t[0];
+    z1 = _mm256_xor_si256(t[0], _mm256_set1_epi64x(0x3D0UL));
+    z0 = _mm256_or_si256(z0, t[1]);
+    z1 = _mm256_and_si256(z1, _mm256_xor_si256(t[1], _mm256_set1_epi64x(0x40UL)));
+    for (i = 2; i < 9; i++) {
+        z0 = _mm256_or_si256(z0, t[i]);
+        z1 = _mm256_and_si256(z1, t[i]);
+    }
+    z0 = _mm256_or_si256(z0, t[9]);
+    z1 = _mm256_and_si256(z1, _mm256_xor_si256(t[9], _mm256_set1_epi64x(0x3C00000UL)));
+    return _mm256_or_si256(_mm256_cmpeq_epi64(z0, _mm256_setzero_si256()), _mm256_cmpeq_epi64(z1, _mm256_set1_epi64x(0x3FFFFFFUL)));
+}
+
+static void secp256k1_fe_x4_cmov(secp256k1_fe_x4 *r, const secp256k1_fe_x4 *a, __m256i mask) {
+    int i;
+    for (i = 0; i < 10; i++) {
+        r->n[i] = _mm256_blendv_epi8(r->n[i], a->n[i], mask);
+    }
+}
+
+#endif
+
+#endif /* SECP256K1_FIELD_X4_IMPL_H */
@@ -83,6 +83,10 @@ static void secp256k1_ge_set_gej_var(secp256k1_ge *r, secp256k1_gej *a);
 /** Set a batch of group elements equal to the inputs given in jacobian coordinates */
 static void secp256k1_ge_set_all_gej_var(secp256k1_ge *r, const secp256k1_gej *a, size_t len);
 
+/** Set a batch of group elements equal to the inputs given in jacobian coordinates,
+ *  using a single inversion. None of the inputs may be infinity. Constant time. */
+static void secp256k1_ge_set_all_gej(secp256k1_ge *r, const secp256k1_gej *a, size_t len);
+
 /** Bring a batch of inputs to the same global z "denominator", based on ratios between
  *  (omitted) z coordinates of adjacent elements.
  *
@@ -171,6 +175,10 @@ static void secp256k1_gej_cmov(secp256k1_gej *r, const secp256k1_gej *a, int fla
 /** If flag is true, set *r equal to *a; otherwise leave it. Constant-time.  Both *r and *a must be initialized.*/
 static void secp256k1_ge_storage_cmov(secp256k1_ge_storage *r, const secp256k1_ge_storage *a, int flag);
 
+/** Set *r equal to table[index], where table has n > 0 entries and index < n. Constant-time in
+ *  index: every entry of the table is read. Uses SSE2 or AVX2 if the compiler targets them. */
+static void secp256k1_ge_storage_table_lookup(secp256k1_ge_storage *r, const secp256k1_ge_storage *table, uint32_t n, uint32_t index);
+
 /** Rescale a jacobian point by b which must be non-zero. Constant-time. */
 static void secp256k1_gej_rescale(secp256k1_gej *r, const secp256k1_fe *b);
 
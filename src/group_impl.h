@@ -11,6 +11,14 @@
 #include "group.h"
 #include "util.h"
 
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define SECP256K1_GE_STORAGE_LOOKUP_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define SECP256K1_GE_STORAGE_LOOKUP_SSE2
+#endif
+
 /* Begin of section generated by sage/gen_exhaustive_groups.sage. */
 #define SECP256K1_G_ORDER_7 SECP256K1_GE_CONST(\
     0x66625d13, 0x317ffe44, 0x63d32cff, 0x1ca02b9b,\
@@ -246,6 +254,44 @@ static void secp256k1_ge_set_all_gej_var(secp256k1_ge *r, const secp256k1_gej *a
 #endif
 }
 
+static void secp256k1_ge_set_all_gej(secp256k1_ge *r, const secp256k1_gej *a, size_t len) {
+    secp256k1_fe u;
+    size_t i;
+#ifdef VERIFY
+    for (i = 0; i < len; i++) {
+        SECP256K1_GEJ_VERIFY(&a[i]);
+        VERIFY_CHECK(!a[i].infinity);
+    }
+#endif
+
+    if (len == 0) {
+        return;
+    }
+    /* Use destination's x coordinates as scratch space for the prefix products
+     * of the z coordinates. */
+    r[0].x = a[0].z;
+    for (i = 1; i < len; i++) {
+        secp256k1_fe_mul(&r[i].x, &r[i - 1].x, &a[i].z);
+    }
+    secp256k1_fe_inv(&u, &r[len - 1].x);
+
+    for (i = len - 1; i > 0; i--) {
+        secp256k1_fe_mul(&r[i].x, &r[i - 1].x, &u);
+        secp256k1_fe_mul(&u, &u, &a[i].z);
+    }
+    r[0].x = u;
+
+    for (i = 0; i < len; i++) {
+        secp256k1_ge_set_gej_zinv(&r[i], &a[i], &r[i].x);
+    }
+
+#ifdef VERIFY
+    for (i = 0; i < len; i++) {
+        SECP256K1_GE_VERIFY(&r[i]);
+    }
+#endif
+}
+
 static void secp256k1_ge_table_set_globalz(size_t len, secp256k1_ge *a, const secp256k1_fe *zr) {
     size_t i;
     secp256k1_fe zs;
@@ -881,6 +927,52 @@ static SECP256K1_INLINE void secp256k1_ge_storage_cmov(secp256k1_ge_storage *r,
     secp256k1_fe_storage_cmov(&r->y, &a->y, flag);
 }
 
+static void secp256k1_ge_storage_table_lookup(secp256k1_ge_storage *r, const secp256k1_ge_storage *table, uint32_t n, uint32_t index) {
+    uint32_t i;
+#if defined(SECP256K1_GE_STORAGE_LOOKUP_AVX2)
+    /* OR together all entries ANDed with a mask that is all ones only for the entry at
+     * index. The mask is computed with a vector comparison, so neither a branch nor an
+     * address depends on index. */
+    const __m256i vindex = _mm256_set1_epi32((int)index);
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    STATIC_ASSERT(sizeof(secp256k1_ge_storage) == 64);
+    VERIFY_CHECK(index < n);
+    for (i = 0; i < n; i++) {
+        const __m256i *p = (const __m256i *)(const void *)&table[i];
+        const __m256i mask = _mm256_cmpeq_epi32(_mm256_set1_epi32((int)i), vindex);
+        acc0 = _mm256_or_si256(acc0, _mm256_and_si256(mask, _mm256_loadu_si256(p)));
+        acc1 = _mm256_or_si256(acc1, _mm256_and_si256(mask, _mm256_loadu_si256(p + 1)));
+    }
+    _mm256_storeu_si256((__m256i *)(void *)r, acc0);
+    _mm256_storeu_si256((__m256i *)(void *)r + 1, acc1);
+#elif defined(SECP256K1_GE_STORAGE_LOOKUP_SSE2)
+    /* Same as above, with 128-bit vectors. */
+    const __m128i vindex = _mm_set1_epi32((int)index);
+    __m128i acc0 = _mm_setzero_si128(), acc1 = _mm_setzero_si128();
+    __m128i acc2 = _mm_setzero_si128(), acc3 = _mm_setzero_si128();
+    STATIC_ASSERT(sizeof(secp256k1_ge_storage) == 64);
+    VERIFY_CHECK(index < n);
+    for (i = 0; i < n; i++) {
+        const __m128i *p = (const __m128i *)(const void *)&table[i];
+        const __m128i mask = _mm_cmpeq_epi32(_mm_set1_epi32((int)i), vindex);
+        acc0 = _mm_or_si128(acc0, _mm_and_si128(mask, _mm_loadu_si128(p)));
+        acc1 = _mm_or_si128(acc1, _mm_and_si128(mask, _mm_loadu_si128(p + 1)));
+        acc2 = _mm_or_si128(acc2, _mm_and_si128(mask, _mm_loadu_si128(p + 2)));
+        acc3 = _mm_or_si128(acc3, _mm_and_si128(mask, _mm_loadu_si128(p + 3)));
+    }
+    _mm_storeu_si128((__m128i *)(void *)r, acc0);
+    _mm_storeu_si128((__m128i *)(void *)r + 1, acc1);
+    _mm_storeu_si128((__m128i *)(void *)r + 2, acc2);
+    _mm_storeu_si128((__m128i *)(void *)r + 3, acc3);
+#else
+    VERIFY_CHECK(index < n);
+    *r = table[0];
+    for (i = 1; i < n; i++) {
+        secp256k1_ge_storage_cmov(r, &table[i], i == index);
+    }
+#endif
+}
+
 static void secp256k1_ge_mul_lambda(secp256k1_ge *r, const secp256k1_ge *a) {
     SECP256K1_GE_VERIFY(a);
 
@@ -0,0 +1,57 @@
+/***********************************************************************
+ * Distributed under the MIT software license, see the accompanying    *
+ * file COPYING or https://www.opensource.org/licenses/mit-license.php.*
+ ***********************************************************************/
+
+#ifndef SECP256K1_GROUP_X4_H
+#define SECP256K1_GROUP_X4_H
+
+#include "field_x4.h"
+#include "group.h"
+
+#ifdef SECP256K1_FE_X4
+
+/** Four group elements in affine coordinates (none of them infinity). */
+typedef struct {
+    secp256k1_fe_x4 x;
+    secp256k1_fe_x4 y;
+} secp256k1_ge_x4;
+
+/** Four group elements in jacobian coordinates. The magnitudes of the
+ *  coordinates are bounded as for secp256k1_gej. */
+typedef struct {
+    secp256k1_fe_x4 x;
+    secp256k1_fe_x4 y;
+    secp256k1_fe_x4 z;
+    /* All ones in the lanes that are infinity, zero in the others. */
+    __m256i infinity;
+} secp256k1_gej_x4;
+
+/** Set every lane of r to a, which must not be infinity. */
+static void secp256k1_ge_x4_set_ge(secp256k1_ge_x4 *r, const secp256k1_ge *a);
+
+/** Set lane j of r to *a[j]. */
+static void secp256k1_ge_x4_set_storage(secp256k1_ge_x4 *r, const secp256k1_ge_storage * const *a);
+
+/** Negate the lanes of r selected by mask (all ones or zero in every lane). Constant-time. */
+static void secp256k1_ge_x4_cond_negate(secp256k1_ge_x4 *r, __m256i mask);
+
+/** Set r to a with Z coordinates 1. */
+static void secp256k1_gej_x4_set_ge(secp256k1_gej_x4 *r, const secp256k1_ge_x4 *a);
+
+/** Set r[j] to lane j of a. */
+static void secp256k1_gej_x4_get_gej(secp256k1_gej *r, const secp256k1_gej_x4 *a);
+
+/** Set r = 2*a laneswise. Same as secp256k1_gej_double. Constant-time. */
+static void secp256k1_gej_x4_double(secp256k1_gej_x4 *r, const secp256k1_gej_x4 *a);
+
+/** Set r = a+b laneswise. Same as secp256k1_gej_add_ge (in particular, a may
+ *  be infinity or equal to b or -b). Constant-time. */
+static void secp256k1_gej_x4_add_ge(secp256k1_gej_x4 *r, const secp256k1_gej_x4 *a, const secp256k1_ge_x4 *b);
+
+/** Rescale every lane of r by s, which must be non-zero. Same as secp256k1_gej_rescale. Constant-time. */
+static void secp256k1_gej_x4_rescale(secp256k1_gej_x4 *r, const secp256k1_fe_x4 *s);
+
+#endif
+
+#endif /* SECP256K1_GROUP_X4_H */
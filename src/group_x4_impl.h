@@ -0,0 +1,160 @@
+/***********************************************************************
+ * Distributed under the MIT software license, see the accompanying    *
+ * file COPYING or https://www.opensource.org/licenses/mit-license.php.*
+ ***********************************************************************/
+
+#ifndef SECP256K1_GROUP_X4_IMPL_H
+#define SECP256K1_GROUP_X4_IMPL_H
+
+#include "field_x4_impl.h"
+#include "group_x4.h"
+
+#ifdef SECP256K1_FE_X4
+
+static void secp256k1_fe_x4_set_one(secp256k1_fe_x4 *r) {
+    int i;
+    r->n[0] = _mm256_set1_epi64x(1);
+    for (i = 1; i < 10; i++) {
+        r->n[i] = _mm256_setzero_si256();
+    }
+}
+
+static void secp256k1_ge_x4_set_ge(secp256k1_ge_x4 *r, const secp256k1_ge *a) {
+    secp256k1_fe x = a->x, y = a->y;
+    VERIFY_CHECK(!a->infinity);
+    secp256k1_fe_normalize(&x);
+    secp256k1_fe_normalize(&y);
+    secp256k1_fe_x4_set_fe(&r->x, &x);
+    secp256k1_fe_x4_set_fe(&r->y, &y);
+}
+
+static void secp256k1_ge_x4_set_storage(secp256k1_ge_x4 *r, const secp256k1_ge_storage * const *a) {
+    const secp256k1_fe_storage *x[4], *y[4];
+    int j;
+    for (j = 0; j < 4; j++) {
+        x[j] = &a[j]->x;
+        y[j] = &a[j]->y;
+    }
+    secp256k1_fe_x4_set_storage(&r->x, x);
+    secp256k1_fe_x4_set_storage(&r->y, y);
+}
+
+static void secp256k1_ge_x4_cond_negate(secp256k1_ge_x4 *r, __m256i mask) {
+    secp256k1_fe_x4 neg;
+    secp256k1_fe_x4_negate(&neg, &r->y, 1);
+    secp256k1_fe_x4_cmov(&r->y, &neg, mask);
+}
+
+static void secp256k1_gej_x4_set_ge(secp256k1_gej_x4 *r, const secp256k1_ge_x4 *a) {
+    r->x = a->x;
+    r->y = a->y;
+    secp256k1_fe_x4_set_one(&r->z);
+    r->infinity = _mm256_setzero_si256();
+}
+
+static void secp256k1_gej_x4_get_gej(secp256k1_gej *r, const secp256k1_gej_x4 *a) {
+    secp256k1_fe_x4 x = a->x, y = a->y, z = a->z;
+    secp256k1_fe_storage xs[4], ys[4], zs[4];
+    uint64_t infinity[4];
+    int j;
+
+    secp256k1_fe_x4_normalize(&x);
+    secp256k1_fe_x4_normalize(&y);
+    secp256k1_fe_x4_normalize(&z);
+    secp256k1_fe_x4_get_storage(xs, &x);
+    secp256k1_fe_x4_get_storage(ys, &y);
+    secp256k1_fe_x4_get_storage(zs, &z);
+    _mm256_storeu_si256((__m256i *)(void *)infinity, a->infinity);
+    for (j = 0; j < 4; j++) {
+        secp256k1_fe_from_storage(&r[j].x, &xs[j]);
+        secp256k1_fe_from_storage(&r[j].y, &ys[j]);
+        secp256k1_fe_from_storage(&r[j].z, &zs[j]);
+        r[j].infinity = (int)(infinity[j] & 1);
+    }
+}
+
+static void secp256k1_gej_x4_double(secp256k1_gej_x4 *r, const secp256k1_gej_x4 *a) {
+    /* The same operations as secp256k1_gej_double. */
+    secp256k1_fe_x4 l, s, t;
+
+    r->infinity = a->infinity;
+    secp256k1_fe_x4_mul(&r->z, &a->z, &a->y); /* Z3 = Y1*Z1 (1) */
+    secp256k1_fe_x4_sqr(&s, &a->y);           /* S = Y1^2 (1) */
+    secp256k1_fe_x4_sqr(&l, &a->x);           /* L = X1^2 (1) */
+    secp256k1_fe_x4_mul_int(&l, 3);           /* L = 3*X1^2 (3) */
+    secp256k1_fe_x4_half(&l);                 /* L = 3/2*X1^2 (2) */
+    secp256k1_fe_x4_negate(&t, &s, 1);        /* T = -S (2) */
+    secp256k1_fe_x4_mul(&t, &t, &a->x);       /* T = -X1*S (1) */
+    secp256k1_fe_x4_sqr(&r->x, &l);           /* X3 = L^2 (1) */
+    secp256k1_fe_x4_add(&r->x, &t);           /* X3 = L^2 + T (2) */
+    secp256k1_fe_x4_add(&r->x, &t);           /* X3 = L^2 + 2*T (3) */
+    secp256k1_fe_x4_sqr(&s, &s);              /* S' = S^2 (1) */
+    secp256k1_fe_x4_add(&t, &r->x);           /* T' = X3 + T (4) */
+    secp256k1_fe_x4_mul(&r->y, &t, &l);       /* Y3 = L*(X3 + T) (1) */
+    secp256k1_fe_x4_add(&r->y, &s);           /* Y3 = L*(X3 + T) + S^2 (2) */
+    secp256k1_fe_x4_negate(&r->y, &r->y, 2);  /* Y3 = -(L*(X3 + T) + S^2) (3) */
+}
+
+static void secp256k1_gej_x4_add_ge(secp256k1_gej_x4 *r, const secp256k1_gej_x4 *a, const secp256k1_ge_x4 *b) {
+    /* The same operations as secp256k1_gej_add_ge, see there for the formula and
+     * the handling of the degenerate cases. */
+    secp256k1_fe_x4 zz, u1, u2, s1, s2, t, tt, m, n, q, rr;
+    secp256k1_fe_x4 m_alt, rr_alt, one;
+    __m256i degenerate;
+
+    secp256k1_fe_x4_sqr(&zz, &a->z);                       /* z = Z1^2 */
+    u1 = a->x;                                             /* u1 = U1 = X1*Z2^2 (GEJ_X_M) */
+    secp256k1_fe_x4_mul(&u2, &b->x, &zz);                  /* u2 = U2 = X2*Z1^2 (1) */
+    s1 = a->y;                                             /* s1 = S1 = Y1*Z2^3 (GEJ_Y_M) */
+    secp256k1_fe_x4_mul(&s2, &b->y, &zz);                  /* s2 = Y2*Z1^2 (1) */
+    secp256k1_fe_x4_mul(&s2, &s2, &a->z);                  /* s2 = S2 = Y2*Z1^3 (1) */
+    t = u1; secp256k1_fe_x4_add(&t, &u2);                  /* t = T = U1+U2 (GEJ_X_M+1) */
+    m = s1; secp256k1_fe_x4_add(&m, &s2);                  /* m = M = S1+S2 (GEJ_Y_M+1) */
+    secp256k1_fe_x4_sqr(&rr, &t);                          /* rr = T^2 (1) */
+    secp256k1_fe_x4_negate(&m_alt, &u2, 1);                /* Malt = -X2*Z1^2 (2) */
+    secp256k1_fe_x4_mul(&tt, &u1, &m_alt);                 /* tt = -U1*U2 (1) */
+    secp256k1_fe_x4_add(&rr, &tt);                         /* rr = R = T^2-U1*U2 (2) */
+    degenerate = secp256k1_fe_x4_normalizes_to_zero(&m);
+    rr_alt = s1;
+    secp256k1_fe_x4_mul_int(&rr_alt, 2);                   /* rr_alt = Y1*Z2^3 - Y2*Z1^3 (GEJ_Y_M*2) */
+    secp256k1_fe_x4_add(&m_alt, &u1);                      /* Malt = X1*Z2^2 - X2*Z1^2 (GEJ_X_M+2) */
+    secp256k1_fe_x4_cmov(&rr_alt, &rr, _mm256_xor_si256(degenerate, _mm256_set1_epi64x(-1)));
+    secp256k1_fe_x4_cmov(&m_alt, &m, _mm256_xor_si256(degenerate, _mm256_set1_epi64x(-1)));
+    secp256k1_fe_x4_sqr(&n, &m_alt);                       /* n = Malt^2 (1) */
+    secp256k1_fe_x4_negate(&q, &t,
+        SECP256K1_GEJ_X_MAGNITUDE_MAX + 1);                /* q = -T (GEJ_X_M+2) */
+    secp256k1_fe_x4_mul(&q, &q, &n);                       /* q = Q = -T*Malt^2 (1) */
+    secp256k1_fe_x4_sqr(&n, &n);                           /* n = Malt^4 (1) */
+    secp256k1_fe_x4_cmov(&n, &m, degenerate);              /* n = M^3 * Malt (GEJ_Y_M+1) */
+    secp256k1_fe_x4_sqr(&t, &rr_alt);                      /* t = Ralt^2 (1) */
+    secp256k1_fe_x4_mul(&r->z, &a->z, &m_alt);             /* r->z = Z3 = Malt*Z (1) */
+    secp256k1_fe_x4_add(&t, &q);                           /* t = Ralt^2 + Q (2) */
+    r->x = t;                                              /* r->x = X3 = Ralt^2 + Q (2) */
+    secp256k1_fe_x4_mul_int(&t, 2);                        /* t = 2*X3 (4) */
+    secp256k1_fe_x4_add(&t, &q);                           /* t = 2*X3 + Q (5) */
+    secp256k1_fe_x4_mul(&t, &t, &rr_alt);                  /* t = Ralt*(2*X3 + Q) (1) */
+    secp256k1_fe_x4_add(&t, &n);                           /* t = Ralt*(2*X3 + Q) + M^3*Malt (GEJ_Y_M+2) */
+    secp256k1_fe_x4_negate(&r->y, &t,
+        SECP256K1_GEJ_Y_MAGNITUDE_MAX + 2);                /* r->y = -(Ralt*(2*X3 + Q) + M^3*Malt) (GEJ_Y_M+3) */
+    secp256k1_fe_x4_half(&r->y);                           /* r->y = Y3 = -(Ralt*(2*X3 + Q) + M^3*Malt)/2 ((GEJ_Y_M+3)/2 + 1) */
+
+    /* In the lanes in which a is infinity, set r to b. */
+    secp256k1_fe_x4_set_one(&one);
+    secp256k1_fe_x4_cmov(&r->x, &b->x, a->infinity);
+    secp256k1_fe_x4_cmov(&r->y, &b->y, a->infinity);
+    secp256k1_fe_x4_cmov(&r->z, &one, a->infinity);
+    r->infinity = secp256k1_fe_x4_normalizes_to_zero(&r->z);
+}
+
+static void secp256k1_gej_x4_rescale(secp256k1_gej_x4 *r, const secp256k1_fe_x4 *s) {
+    secp256k1_fe_x4 zz;
+    secp256k1_fe_x4_sqr(&zz, s);
+    secp256k1_fe_x4_mul(&r->x, &r->x, &zz);                /* r->x *= s^2 */
+    secp256k1_fe_x4_mul(&r->y, &r->y, &zz);
+    secp256k1_fe_x4_mul(&r->y, &r->y, s);                  /* r->y *= s^3 */
+    secp256k1_fe_x4_mul(&r->z, &r->z, s);                  /* r->z *= s   */
+}
+
+#endif
+
+#endif /* SECP256K1_GROUP_X4_IMPL_H */
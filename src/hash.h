@@ -10,16 +10,53 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+/* If the compiler targets the SHA extensions (and SSE4.1, which they are used
+ * with), secp256k1_sha256_transform uses them instead of the portable C code. */
+#if defined(__SHA__) && defined(__SSE4_1__)
+#define SECP256K1_SHA256_SHANI
+#endif
+
 typedef struct {
     uint32_t s[8];
     unsigned char buf[64];
     uint64_t bytes;
 } secp256k1_sha256;
 
+/** Perform one SHA-256 transformation of s, processing the 64-byte block buf. */
+static void secp256k1_sha256_transform(uint32_t *s, const unsigned char *buf);
+/** The same, always using the portable C code. */
+static void secp256k1_sha256_transform_portable(uint32_t *s, const unsigned char *buf);
+#ifdef SECP256K1_SHA256_SHANI
+/** The same, using the SHA extensions. */
+static void secp256k1_sha256_transform_shani(uint32_t *s, const unsigned char *buf);
+#endif
+
 static void secp256k1_sha256_initialize(secp256k1_sha256 *hash);
 static void secp256k1_sha256_write(secp256k1_sha256 *hash, const unsigned char *data, size_t size);
 static void secp256k1_sha256_finalize(secp256k1_sha256 *hash, unsigned char *out32);
 
+/* If the compiler targets AVX2, the eight lanes of secp256k1_sha256_x8 are
+ * processed in parallel in the 32-bit lanes of AVX2 registers. */
+#if defined(__AVX2__)
+#define SECP256K1_SHA256_X8_AVX2
+#endif
+
+/* Eight SHA-256 computations that continue from the same state and process
+ * messages of equal length. */
+typedef struct {
+    /* s[i][j] is word i of the state of lane j. */
+    uint32_t s[8][8];
+    unsigned char buf[8][64];
+    uint64_t bytes;
+} secp256k1_sha256_x8;
+
+/** Set every lane of hash to the state of a, into which a multiple of 64 bytes must have been written. */
+static void secp256k1_sha256_x8_initialize(secp256k1_sha256_x8 *hash, const secp256k1_sha256 *a);
+/** Write the size bytes at data[j] into lane j, for every j. */
+static void secp256k1_sha256_x8_write(secp256k1_sha256_x8 *hash, const unsigned char * const *data, size_t size);
+/** Write the hash of lane j to out32 + 32*j, for every j. */
+static void secp256k1_sha256_x8_finalize(secp256k1_sha256_x8 *hash, unsigned char *out32);
+
 typedef struct {
     secp256k1_sha256 inner, outer;
 } secp256k1_hmac_sha256;
@@ -35,6 +72,13 @@ typedef struct {
 } secp256k1_rfc6979_hmac_sha256;
 
 static void secp256k1_rfc6979_hmac_sha256_initialize(secp256k1_rfc6979_hmac_sha256 *rng, const unsigned char *key, size_t keylen);
+/** Compute the state of the first HMAC of secp256k1_rfc6979_hmac_sha256_initialize
+ *  after the first 32 bytes of the key. It can be reused for all keys that start
+ *  with these bytes. */
+static void secp256k1_rfc6979_hmac_sha256_prefix(secp256k1_hmac_sha256 *hmac, const unsigned char *prefix32);
+/** Same as secp256k1_rfc6979_hmac_sha256_initialize with key prefix32 || key, given
+ *  the output of secp256k1_rfc6979_hmac_sha256_prefix for prefix32. */
+static void secp256k1_rfc6979_hmac_sha256_initialize_prefixed(secp256k1_rfc6979_hmac_sha256 *rng, const secp256k1_hmac_sha256 *prefix_hmac, const unsigned char *prefix32, const unsigned char *key, size_t keylen);
 static void secp256k1_rfc6979_hmac_sha256_generate(secp256k1_rfc6979_hmac_sha256 *rng, unsigned char *out, size_t outlen);
 static void secp256k1_rfc6979_hmac_sha256_finalize(secp256k1_rfc6979_hmac_sha256 *rng);
 
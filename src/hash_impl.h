@@ -14,6 +14,10 @@
 #include <stdint.h>
 #include <string.h>
 
+#if defined(SECP256K1_SHA256_SHANI) || defined(SECP256K1_SHA256_X8_AVX2)
+#include <immintrin.h>
+#endif
+
 #define Ch(x,y,z) ((z) ^ ((x) & ((y) ^ (z))))
 #define Maj(x,y,z) (((x) & (y)) | ((z) & ((x) | (y))))
 #define Sigma0(x) (((x) >> 2 | (x) << 30) ^ ((x) >> 13 | (x) << 19) ^ ((x) >> 22 | (x) << 10))
@@ -41,7 +45,7 @@ static void secp256k1_sha256_initialize(secp256k1_sha256 *hash) {
 }
 
 /** Perform one SHA-256 transformation, processing 16 big endian 32-bit words. */
-static void secp256k1_sha256_transform(uint32_t* s, const unsigned char* buf) {
+static void secp256k1_sha256_transform_portable(uint32_t* s, const unsigned char* buf) {
     uint32_t a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
     uint32_t w0, w1, w2, w3, w4, w5, w6, w7, w8, w9, w10, w11, w12, w13, w14, w15;
 
@@ -123,6 +127,150 @@ static void secp256k1_sha256_transform(uint32_t* s, const unsigned char* buf) {
     s[7] += h;
 }
 
+#if defined(SECP256K1_SHA256_SHANI) || defined(SECP256K1_SHA256_X8_AVX2)
+static const uint32_t secp256k1_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+#endif
+
+#ifdef SECP256K1_SHA256_SHANI
+static void secp256k1_sha256_transform_shani(uint32_t* s, const unsigned char* buf) {
+    /* Byte order swap of every 32-bit word. */
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    __m128i state0, state1, abef, cdgh, msg, msg0, msg1, msg2, msg3, tmp;
+
+#ifdef __AVX__
+    /* The SHA instructions have no VEX encoding, but the compiler uses VEX
+     * encodings for the other instructions. Mixing them is very slow on some
+     * CPUs unless the upper halves of the ymm registers are clean. */
+    _mm256_zeroupper();
+#endif
+    /* The SHA-256 instructions keep the state in the order (a,b,e,f), (c,d,g,h). */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)&s[0]), 0xb1); /* (c,d,a,b) */
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(const void *)&s[4]), 0x1b); /* (h,g,f,e) */
+    state0 = _mm_alignr_epi8(tmp, state1, 8); /* (f,e,b,a) */
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0); /* (h,g,d,c) */
+    abef = state0;
+    cdgh = state1;
+
+    /* Rounds 0-3 */
+    msg0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)&buf[0]), mask);
+    msg = _mm_add_epi32(msg0, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[0]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    /* Rounds 4-7 */
+    msg1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)&buf[16]), mask);
+    msg = _mm_add_epi32(msg1, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[4]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+    /* Rounds 8-11 */
+    msg2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)&buf[32]), mask);
+    msg = _mm_add_epi32(msg2, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[8]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+    /* Rounds 12-15 */
+    msg3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)&buf[48]), mask);
+    msg = _mm_add_epi32(msg3, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[12]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg0 = _mm_sha256msg2_epu32(_mm_add_epi32(msg0, _mm_alignr_epi8(msg3, msg2, 4)), msg3);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+    /* Rounds 16-19 */
+    msg = _mm_add_epi32(msg0, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[16]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg1 = _mm_sha256msg2_epu32(_mm_add_epi32(msg1, _mm_alignr_epi8(msg0, msg3, 4)), msg0);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+    /* Rounds 20-23 */
+    msg = _mm_add_epi32(msg1, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[20]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg2 = _mm_sha256msg2_epu32(_mm_add_epi32(msg2, _mm_alignr_epi8(msg1, msg0, 4)), msg1);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+    /* Rounds 24-27 */
+    msg = _mm_add_epi32(msg2, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[24]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg3 = _mm_sha256msg2_epu32(_mm_add_epi32(msg3, _mm_alignr_epi8(msg2, msg1, 4)), msg2);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+    /* Rounds 28-31 */
+    msg = _mm_add_epi32(msg3, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[28]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg0 = _mm_sha256msg2_epu32(_mm_add_epi32(msg0, _mm_alignr_epi8(msg3, msg2, 4)), msg3);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+    /* Rounds 32-35 */
+    msg = _mm_add_epi32(msg0, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[32]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg1 = _mm_sha256msg2_epu32(_mm_add_epi32(msg1, _mm_alignr_epi8(msg0, msg3, 4)), msg0);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+    /* Rounds 36-39 */
+    msg = _mm_add_epi32(msg1, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[36]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg2 = _mm_sha256msg2_epu32(_mm_add_epi32(msg2, _mm_alignr_epi8(msg1, msg0, 4)), msg1);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+    /* Rounds 40-43 */
+    msg = _mm_add_epi32(msg2, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[40]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg3 = _mm_sha256msg2_epu32(_mm_add_epi32(msg3, _mm_alignr_epi8(msg2, msg1, 4)), msg2);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+    /* Rounds 44-47 */
+    msg = _mm_add_epi32(msg3, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[44]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg0 = _mm_sha256msg2_epu32(_mm_add_epi32(msg0, _mm_alignr_epi8(msg3, msg2, 4)), msg3);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+    /* Rounds 48-51 */
+    msg = _mm_add_epi32(msg0, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[48]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg1 = _mm_sha256msg2_epu32(_mm_add_epi32(msg1, _mm_alignr_epi8(msg0, msg3, 4)), msg0);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+    /* Rounds 52-55 */
+    msg = _mm_add_epi32(msg1, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[52]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg2 = _mm_sha256msg2_epu32(_mm_add_epi32(msg2, _mm_alignr_epi8(msg1, msg0, 4)), msg1);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    /* Rounds 56-59 */
+    msg = _mm_add_epi32(msg2, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[56]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    msg3 = _mm_sha256msg2_epu32(_mm_add_epi32(msg3, _mm_alignr_epi8(msg2, msg1, 4)), msg2);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+    /* Rounds 60-63 */
+    msg = _mm_add_epi32(msg3, _mm_loadu_si128((const __m128i *)(const void *)&secp256k1_sha256_k[60]));
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+
+    state0 = _mm_add_epi32(state0, abef);
+    state1 = _mm_add_epi32(state1, cdgh);
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b); /* (a,b,e,f) */
+    state1 = _mm_shuffle_epi32(state1, 0xb1); /* (g,h,c,d) */
+    _mm_storeu_si128((__m128i *)(void *)&s[0], _mm_blend_epi16(tmp, state1, 0xf0)); /* (a,b,c,d) */
+    _mm_storeu_si128((__m128i *)(void *)&s[4], _mm_alignr_epi8(state1, tmp, 8)); /* (e,f,g,h) */
+}
+#endif
+
+static void secp256k1_sha256_transform(uint32_t* s, const unsigned char* buf) {
+#ifdef SECP256K1_SHA256_SHANI
+    secp256k1_sha256_transform_shani(s, buf);
+#else
+    secp256k1_sha256_transform_portable(s, buf);
+#endif
+}
+
 static void secp256k1_sha256_write(secp256k1_sha256 *hash, const unsigned char *data, size_t len) {
     size_t bufsize = hash->bytes & 0x3F;
     hash->bytes += len;
@@ -171,6 +319,182 @@ static void secp256k1_sha256_initialize_tagged(secp256k1_sha256 *hash, const uns
     secp256k1_sha256_write(hash, buf, 32);
 }
 
+#ifdef SECP256K1_SHA256_X8_AVX2
+/* Transpose the 8x8 matrix of 32-bit words whose rows are r[0..7]. */
+static void secp256k1_sha256_x8_transpose(__m256i *r) {
+    __m256i t0, t1, t2, t3, t4, t5, t6, t7, u0, u1, u2, u3, u4, u5, u6, u7;
+    t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+    t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+    t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+    t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+    t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    u0 = _mm256_unpacklo_epi64(t0, t2);
+    u1 = _mm256_unpackhi_epi64(t0, t2);
+    u2 = _mm256_unpacklo_epi64(t1, t3);
+    u3 = _mm256_unpackhi_epi64(t1, t3);
+    u4 = _mm256_unpacklo_epi64(t4, t6);
+    u5 = _mm256_unpackhi_epi64(t4, t6);
+    u6 = _mm256_unpacklo_epi64(t5, t7);
+    u7 = _mm256_unpackhi_epi64(t5, t7);
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+#define ROR_X8(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define Ch_X8(x, y, z) _mm256_xor_si256((z), _mm256_and_si256((x), _mm256_xor_si256((y), (z))))
+#define Maj_X8(x, y, z) _mm256_or_si256(_mm256_and_si256((x), (y)), _mm256_and_si256((z), _mm256_or_si256((x), (y))))
+#define Sigma0_X8(x) _mm256_xor_si256(_mm256_xor_si256(ROR_X8((x), 2), ROR_X8((x), 13)), ROR_X8((x), 22))
+#define Sigma1_X8(x) _mm256_xor_si256(_mm256_xor_si256(ROR_X8((x), 6), ROR_X8((x), 11)), ROR_X8((x), 25))
+#define sigma0_X8(x) _mm256_xor_si256(_mm256_xor_si256(ROR_X8((x), 7), ROR_X8((x), 18)), _mm256_srli_epi32((x), 3))
+#define sigma1_X8(x) _mm256_xor_si256(_mm256_xor_si256(ROR_X8((x), 17), ROR_X8((x), 19)), _mm256_srli_epi32((x), 10))
+
+/* Perform one SHA-256 transformation of every lane of hash, processing the lane's buffer. */
+static void secp256k1_sha256_transform_x8(secp256k1_sha256_x8 *hash) {
+    /* Byte order swap of every 32-bit word. */
+    const __m256i mask = _mm256_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL, 0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    __m256i w[16], a, b, c, d, e, f, g, h, t1, t2;
+    int i, j;
+
+    /* Load the buffers and transpose them, so that w[i] holds word i of every lane. */
+    for (j = 0; j < 8; j++) {
+        w[j] = _mm256_loadu_si256((const __m256i *)(const void *)&hash->buf[j][0]);
+        w[j + 8] = _mm256_loadu_si256((const __m256i *)(const void *)&hash->buf[j][32]);
+    }
+    secp256k1_sha256_x8_transpose(&w[0]);
+    secp256k1_sha256_x8_transpose(&w[8]);
+    for (i = 0; i < 16; i++) {
+        w[i] = _mm256_shuffle_epi8(w[i], mask);
+    }
+
+    a = _mm256_loadu_si256((const __m256i *)(const void *)hash->s[0]);
+    b = _mm256_loadu_si256((const __m256i *)(const void *)hash->s[1]);
+    c = _mm256_loadu_si256((const __m256i *)(const void *)hash->s[2]);
+    d = _mm256_loadu_si256((const __m256i *)(const void *)hash->s[3]);
+    e = _mm256_loadu_si256((const __m256i *)(const void *)hash->s[4]);
+    f = _mm256_loadu_si256((const __m256i *)(const void *)hash->s[5]);
+    g = _mm256_loadu_si256((const __m256i *)(const void *)hash->s[6]);
+    h = _mm256_loadu_si256((const __m256i *)(const void *)hash->s[7]);
+    for (i = 0; i < 64; i++) {
+        if (i >= 16) {
+            /* Extend the message schedule in place. */
+            w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(sigma1_X8(w[(i - 2) & 15]), w[(i - 7) & 15]),
+                                         _mm256_add_epi32(sigma0_X8(w[(i - 15) & 15]), w[i & 15]));
+        }
+        t1 = _mm256_add_epi32(_mm256_add_epi32(h, Sigma1_X8(e)), _mm256_add_epi32(Ch_X8(e, f, g),
+             _mm256_add_epi32(_mm256_set1_epi32((int)secp256k1_sha256_k[i]), w[i & 15])));
+        t2 = _mm256_add_epi32(Sigma0_X8(a), Maj_X8(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+    _mm256_storeu_si256((__m256i *)(void *)hash->s[0], _mm256_add_epi32(a, _mm256_loadu_si256((const __m256i *)(const void *)hash->s[0])));
+    _mm256_storeu_si256((__m256i *)(void *)hash->s[1], _mm256_add_epi32(b, _mm256_loadu_si256((const __m256i *)(const void *)hash->s[1])));
+    _mm256_storeu_si256((__m256i *)(void *)hash->s[2], _mm256_add_epi32(c, _mm256_loadu_si256((const __m256i *)(const void *)hash->s[2])));
+    _mm256_storeu_si256((__m256i *)(void *)hash->s[3], _mm256_add_epi32(d, _mm256_loadu_si256((const __m256i *)(const void *)hash->s[3])));
+    _mm256_storeu_si256((__m256i *)(void *)hash->s[4], _mm256_add_epi32(e, _mm256_loadu_si256((const __m256i *)(const void *)hash->s[4])));
+    _mm256_storeu_si256((__m256i *)(void *)hash->s[5], _mm256_add_epi32(f, _mm256_loadu_si256((const __m256i *)(const void *)hash->s[5])));
+    _mm256_storeu_si256((__m256i *)(void *)hash->s[6], _mm256_add_epi32(g, _mm256_loadu_si256((const __m256i *)(const void *)hash->s[6])));
+    _mm256_storeu_si256((__m256i *)(void *)hash->s[7], _mm256_add_epi32(h, _mm256_loadu_si256((const __m256i *)(const void *)hash->s[7])));
+}
+
+#undef ROR_X8
+#undef Ch_X8
+#undef Maj_X8
+#undef Sigma0_X8
+#undef Sigma1_X8
+#undef sigma0_X8
+#undef sigma1_X8
+#else
+/* Perform one SHA-256 transformation of every lane of hash, processing the lane's buffer. */
+static void secp256k1_sha256_transform_x8(secp256k1_sha256_x8 *hash) {
+    uint32_t s[8];
+    int i, j;
+    for (j = 0; j < 8; j++) {
+        for (i = 0; i < 8; i++) {
+            s[i] = hash->s[i][j];
+        }
+        secp256k1_sha256_transform(s, hash->buf[j]);
+        for (i = 0; i < 8; i++) {
+            hash->s[i][j] = s[i];
+        }
+    }
+}
+#endif
+
+static void secp256k1_sha256_x8_initialize(secp256k1_sha256_x8 *hash, const secp256k1_sha256 *a) {
+    int i, j;
+    VERIFY_CHECK((a->bytes & 0x3F) == 0);
+    for (i = 0; i < 8; i++) {
+        for (j = 0; j < 8; j++) {
+            hash->s[i][j] = a->s[i];
+        }
+    }
+    hash->bytes = a->bytes;
+}
+
+static void secp256k1_sha256_x8_write(secp256k1_sha256_x8 *hash, const unsigned char * const *data, size_t len) {
+    size_t bufsize = hash->bytes & 0x3F;
+    size_t done = 0;
+    int j;
+    hash->bytes += len;
+    VERIFY_CHECK(hash->bytes >= len);
+    while (len - done >= 64 - bufsize) {
+        /* Fill the buffers, and process them. */
+        size_t chunk_len = 64 - bufsize;
+        for (j = 0; j < 8; j++) {
+            memcpy(hash->buf[j] + bufsize, data[j] + done, chunk_len);
+        }
+        done += chunk_len;
+        secp256k1_sha256_transform_x8(hash);
+        bufsize = 0;
+    }
+    if (len > done) {
+        /* Fill the buffers with what remains. */
+        for (j = 0; j < 8; j++) {
+            memcpy(hash->buf[j] + bufsize, data[j] + done, len - done);
+        }
+    }
+}
+
+static void secp256k1_sha256_x8_finalize(secp256k1_sha256_x8 *hash, unsigned char *out32) {
+    static const unsigned char pad[64] = {0x80};
+    unsigned char sizedesc[8];
+    const unsigned char *data[8];
+    int i, j;
+    /* The maximum message size of SHA256 is 2^64-1 bits. */
+    VERIFY_CHECK(hash->bytes < ((uint64_t)1 << 61));
+    secp256k1_write_be32(&sizedesc[0], hash->bytes >> 29);
+    secp256k1_write_be32(&sizedesc[4], hash->bytes << 3);
+    for (j = 0; j < 8; j++) {
+        data[j] = pad;
+    }
+    secp256k1_sha256_x8_write(hash, data, 1 + ((119 - (hash->bytes % 64)) % 64));
+    for (j = 0; j < 8; j++) {
+        data[j] = sizedesc;
+    }
+    secp256k1_sha256_x8_write(hash, data, 8);
+    for (j = 0; j < 8; j++) {
+        for (i = 0; i < 8; i++) {
+            secp256k1_write_be32(&out32[32*j + 4*i], hash->s[i][j]);
+            hash->s[i][j] = 0;
+        }
+    }
+}
+
 static void secp256k1_hmac_sha256_initialize(secp256k1_hmac_sha256 *hash, const unsigned char *key, size_t keylen) {
     size_t n;
     unsigned char rkey[64];
@@ -242,6 +566,46 @@ static void secp256k1_rfc6979_hmac_sha256_initialize(secp256k1_rfc6979_hmac_sha2
     rng->retry = 0;
 }
 
+static void secp256k1_rfc6979_hmac_sha256_prefix(secp256k1_hmac_sha256 *hmac, const unsigned char *prefix32) {
+    static const unsigned char zero[1] = {0x00};
+    unsigned char v[32], k[32];
+
+    memset(v, 0x01, 32); /* RFC6979 3.2.b. */
+    memset(k, 0x00, 32); /* RFC6979 3.2.c. */
+
+    /* The part of RFC6979 3.2.d. that does not depend on the rest of the key. */
+    secp256k1_hmac_sha256_initialize(hmac, k, 32);
+    secp256k1_hmac_sha256_write(hmac, v, 32);
+    secp256k1_hmac_sha256_write(hmac, zero, 1);
+    secp256k1_hmac_sha256_write(hmac, prefix32, 32);
+}
+
+static void secp256k1_rfc6979_hmac_sha256_initialize_prefixed(secp256k1_rfc6979_hmac_sha256 *rng, const secp256k1_hmac_sha256 *prefix_hmac, const unsigned char *prefix32, const unsigned char *key, size_t keylen) {
+    secp256k1_hmac_sha256 hmac = *prefix_hmac;
+    static const unsigned char one[1] = {0x01};
+
+    memset(rng->v, 0x01, 32); /* RFC6979 3.2.b. */
+
+    /* RFC6979 3.2.d., continued. */
+    secp256k1_hmac_sha256_write(&hmac, key, keylen);
+    secp256k1_hmac_sha256_finalize(&hmac, rng->k);
+    secp256k1_hmac_sha256_initialize(&hmac, rng->k, 32);
+    secp256k1_hmac_sha256_write(&hmac, rng->v, 32);
+    secp256k1_hmac_sha256_finalize(&hmac, rng->v);
+
+    /* RFC6979 3.2.f. */
+    secp256k1_hmac_sha256_initialize(&hmac, rng->k, 32);
+    secp256k1_hmac_sha256_write(&hmac, rng->v, 32);
+    secp256k1_hmac_sha256_write(&hmac, one, 1);
+    secp256k1_hmac_sha256_write(&hmac, prefix32, 32);
+    secp256k1_hmac_sha256_write(&hmac, key, keylen);
+    secp256k1_hmac_sha256_finalize(&hmac, rng->k);
+    secp256k1_hmac_sha256_initialize(&hmac, rng->k, 32);
+    secp256k1_hmac_sha256_write(&hmac, rng->v, 32);
+    secp256k1_hmac_sha256_finalize(&hmac, rng->v);
+    rng->retry = 0;
+}
+
 static void secp256k1_rfc6979_hmac_sha256_generate(secp256k1_rfc6979_hmac_sha256 *rng, unsigned char *out, size_t outlen) {
     /* RFC6979 3.2.h. */
     static const unsigned char zero[1] = {0x00};
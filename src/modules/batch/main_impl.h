@@ -0,0 +1,324 @@
+/***********************************************************************
+ * Distributed under the MIT software license, see the accompanying    *
+ * file COPYING or https://www.opensource.org/licenses/mit-license.php.*
+ ***********************************************************************/
+
+#ifndef SECP256K1_MODULE_BATCH_MAIN_H
+#define SECP256K1_MODULE_BATCH_MAIN_H
+
+#include "../../../include/secp256k1.h"
+#include "../../../include/secp256k1_extrakeys.h"
+#include "../../../include/secp256k1_batch.h"
+#include "../../hash.h"
+#include "../../scratch.h"
+#include "../../util.h"
+
+/* Every item is stored as an equation g_sc*G + sc[0]*pt[0] + sc[1]*pt[1] = 0.
+ *  - ECDSA:      m*G + r*P - s*R = 0, where R is lifted from r using recid.
+ *  - Schnorr:    s*G - R - e*P = 0, where R has even Y.
+ *  - tweak check: t*G + P - Q = 0.
+ * The randomizer a is assigned when the chunk containing the item is flushed.
+ */
+typedef struct {
+    secp256k1_scalar g_sc;
+    secp256k1_scalar sc[2];
+    secp256k1_ge pt[2];
+    secp256k1_scalar a;
+    /* Index of the item among all items added to the batch. */
+    size_t idx;
+    /* Set if a failing equation does not imply an invalid item, because R
+     * was lifted from a recid hint. The item is then verified individually. */
+    int ecdsa;
+} secp256k1_batch_item;
+
+struct secp256k1_batch_struct {
+    secp256k1_scratch *scratch;
+    secp256k1_batch_item *items;
+    /* Number of items after which the batch is flushed. */
+    size_t capacity;
+    /* Number of items waiting to be verified. */
+    size_t n_items;
+    /* Number of items added since creation, including those verified
+     * immediately. */
+    size_t n_added;
+    /* Commits to all items waiting to be verified. */
+    secp256k1_sha256 sha;
+    secp256k1_batch_invalid_callback invalid_fun;
+    void *invalid_data;
+    int result;
+};
+
+secp256k1_batch* secp256k1_batch_create(const secp256k1_context* ctx, secp256k1_scratch_space *scratch) {
+    const size_t base_alloc = ROUND_TO_ALIGN(sizeof(secp256k1_batch));
+    secp256k1_batch *batch;
+    size_t capacity;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(scratch != NULL);
+
+    /* Every item contributes two points to the multi-scalar multiplication. */
+    capacity = secp256k1_pippenger_max_points(&ctx->error_callback, scratch) / 2;
+    if (capacity == 0) {
+        capacity = 1;
+    }
+    batch = (secp256k1_batch *)checked_malloc(&ctx->error_callback, base_alloc + capacity * sizeof(secp256k1_batch_item));
+    if (batch == NULL) {
+        return NULL;
+    }
+    batch->scratch = scratch;
+    batch->items = (secp256k1_batch_item *)(void *)((unsigned char *)batch + base_alloc);
+    batch->capacity = capacity;
+    batch->n_items = 0;
+    batch->n_added = 0;
+    secp256k1_batch_sha256_tagged(&batch->sha);
+    batch->invalid_fun = NULL;
+    batch->invalid_data = NULL;
+    batch->result = 1;
+    return batch;
+}
+
+void secp256k1_batch_destroy(const secp256k1_context* ctx, secp256k1_batch *batch) {
+    VERIFY_CHECK(ctx != NULL);
+    (void)ctx;
+    if (batch != NULL) {
+        free(batch);
+    }
+}
+
+void secp256k1_batch_set_invalid_callback(const secp256k1_context* ctx, secp256k1_batch *batch, secp256k1_batch_invalid_callback fun, void *data) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK_VOID(batch != NULL);
+    batch->invalid_fun = fun;
+    batch->invalid_data = data;
+}
+
+static void secp256k1_batch_report_invalid(secp256k1_batch *batch, size_t idx) {
+    batch->result = 0;
+    if (batch->invalid_fun != NULL) {
+        batch->invalid_fun(idx, batch->invalid_data);
+    }
+}
+
+/* Provides the points a*sc[0]*pt[0], a*sc[1]*pt[1] of consecutive items. */
+static int secp256k1_batch_ecmult_callback(secp256k1_scalar *sc, secp256k1_ge *pt, size_t idx, void *cbdata) {
+    const secp256k1_batch_item *items = (const secp256k1_batch_item *)cbdata;
+    const secp256k1_batch_item *item = &items[idx / 2];
+
+    secp256k1_scalar_mul(sc, &item->sc[idx % 2], &item->a);
+    *pt = item->pt[idx % 2];
+    return 1;
+}
+
+/* Returns whether the randomized sum of the equations of items [lo, hi) is
+ * zero. */
+static int secp256k1_batch_range_is_zero(const secp256k1_context* ctx, secp256k1_batch *batch, size_t lo, size_t hi) {
+    secp256k1_scalar g_sc, t;
+    secp256k1_gej rj;
+    size_t i;
+
+    secp256k1_scalar_clear(&g_sc);
+    for (i = lo; i < hi; i++) {
+        secp256k1_scalar_mul(&t, &batch->items[i].g_sc, &batch->items[i].a);
+        secp256k1_scalar_add(&g_sc, &g_sc, &t);
+    }
+    if (!secp256k1_ecmult_multi_var(&ctx->error_callback, batch->scratch, &rj, &g_sc, secp256k1_batch_ecmult_callback, (void *)&batch->items[lo], 2 * (hi - lo))) {
+        return 0;
+    }
+    return secp256k1_gej_is_infinity(&rj);
+}
+
+/* Finds and reports the invalid items in [lo, hi). If known_nonzero is set,
+ * the caller has already established that the sum of the equations is not
+ * zero. Returns whether the sum is nonzero. Because the sums are linear, a
+ * zero left half implies a nonzero right half, which saves one check per
+ * level. */
+static int secp256k1_batch_bisect(const secp256k1_context* ctx, secp256k1_batch *batch, size_t lo, size_t hi, int known_nonzero) {
+    const secp256k1_batch_item *item;
+    size_t mid;
+    int left_nonzero;
+    secp256k1_scalar s;
+
+    if (!known_nonzero && secp256k1_batch_range_is_zero(ctx, batch, lo, hi)) {
+        return 0;
+    }
+    if (hi - lo > 1) {
+        mid = lo + (hi - lo) / 2;
+        left_nonzero = secp256k1_batch_bisect(ctx, batch, lo, mid, 0);
+        secp256k1_batch_bisect(ctx, batch, mid, hi, !left_nonzero);
+        return 1;
+    }
+
+    item = &batch->items[lo];
+    if (item->ecdsa) {
+        /* The recid hint may have been wrong. */
+        secp256k1_scalar_negate(&s, &item->sc[1]);
+        if (secp256k1_ecdsa_sig_verify(&ctx->ecmult_g, &item->sc[0], &s, &item->pt[0], &item->g_sc)) {
+            return 1;
+        }
+    }
+    secp256k1_batch_report_invalid(batch, item->idx);
+    return 1;
+}
+
+static void secp256k1_batch_flush(const secp256k1_context* ctx, secp256k1_batch *batch) {
+    unsigned char seed[32];
+    size_t i;
+
+    if (batch->n_items == 0) {
+        return;
+    }
+    secp256k1_sha256_finalize(&batch->sha, seed);
+    for (i = 0; i < batch->n_items; i += 8) {
+        secp256k1_scalar a[8];
+        size_t k;
+        secp256k1_batch_randomizers(a, seed, i, batch->n_items);
+        for (k = 0; k < 8 && i + k < batch->n_items; k++) {
+            batch->items[i + k].a = a[k];
+        }
+    }
+    secp256k1_batch_bisect(ctx, batch, 0, batch->n_items, 0);
+    batch->n_items = 0;
+    secp256k1_batch_sha256_tagged(&batch->sha);
+}
+
+static void secp256k1_batch_push(const secp256k1_context* ctx, secp256k1_batch *batch, secp256k1_batch_item *item) {
+    unsigned char buf[32];
+    int i;
+
+    secp256k1_scalar_get_b32(buf, &item->g_sc);
+    secp256k1_sha256_write(&batch->sha, buf, 32);
+    for (i = 0; i < 2; i++) {
+        secp256k1_scalar_get_b32(buf, &item->sc[i]);
+        secp256k1_sha256_write(&batch->sha, buf, 32);
+        secp256k1_fe_normalize_var(&item->pt[i].x);
+        secp256k1_fe_normalize_var(&item->pt[i].y);
+        secp256k1_fe_get_b32(buf, &item->pt[i].x);
+        secp256k1_sha256_write(&batch->sha, buf, 32);
+        secp256k1_fe_get_b32(buf, &item->pt[i].y);
+        secp256k1_sha256_write(&batch->sha, buf, 32);
+    }
+
+    item->idx = batch->n_added;
+    batch->items[batch->n_items] = *item;
+    batch->n_items++;
+    batch->n_added++;
+    if (batch->n_items == batch->capacity) {
+        secp256k1_batch_flush(ctx, batch);
+    }
+}
+
+/* Records the outcome of an item that was verified without being queued. */
+static void secp256k1_batch_add_checked(secp256k1_batch *batch, int valid) {
+    if (!valid) {
+        secp256k1_batch_report_invalid(batch, batch->n_added);
+    }
+    batch->n_added++;
+}
+
+int secp256k1_batch_add_ecdsa(const secp256k1_context* ctx, secp256k1_batch *batch, const secp256k1_ecdsa_signature *sig, const unsigned char *msghash32, const secp256k1_pubkey *pubkey, const int *recid) {
+    secp256k1_batch_item item;
+    secp256k1_scalar r, s, m;
+    secp256k1_ge q;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(batch != NULL);
+    ARG_CHECK(sig != NULL);
+    ARG_CHECK(msghash32 != NULL);
+    ARG_CHECK(pubkey != NULL);
+    ARG_CHECK(recid == NULL || (*recid >= 0 && *recid <= 3));
+
+    if (!secp256k1_pubkey_load(ctx, &q, pubkey)) {
+        return 0;
+    }
+    secp256k1_scalar_set_b32(&m, msghash32, NULL);
+    secp256k1_ecdsa_signature_load(ctx, &r, &s, sig);
+    if (secp256k1_scalar_is_zero(&r) || secp256k1_scalar_is_zero(&s) || secp256k1_scalar_is_high(&s)) {
+        secp256k1_batch_add_checked(batch, 0);
+        return 1;
+    }
+    if (recid == NULL || !secp256k1_ecdsa_sig_lift_r(&item.pt[1], &r, *recid)) {
+        secp256k1_batch_add_checked(batch, secp256k1_ecdsa_sig_verify(&ctx->ecmult_g, &r, &s, &q, &m));
+        return 1;
+    }
+
+    item.g_sc = m;
+    item.sc[0] = r;
+    item.pt[0] = q;
+    secp256k1_scalar_negate(&item.sc[1], &s);
+    item.ecdsa = 1;
+    secp256k1_batch_push(ctx, batch, &item);
+    return 1;
+}
+
+int secp256k1_batch_add_schnorrsig(const secp256k1_context* ctx, secp256k1_batch *batch, const unsigned char *sig64, const unsigned char *msg, size_t msglen, const secp256k1_xonly_pubkey *pubkey) {
+    secp256k1_batch_item item;
+    secp256k1_scalar e;
+    secp256k1_fe rx;
+    unsigned char buf[32];
+    int overflow;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(batch != NULL);
+    ARG_CHECK(sig64 != NULL);
+    ARG_CHECK(msg != NULL || msglen == 0);
+    ARG_CHECK(pubkey != NULL);
+
+    if (!secp256k1_xonly_pubkey_load(ctx, &item.pt[1], pubkey)) {
+        return 0;
+    }
+    secp256k1_scalar_set_b32(&item.g_sc, &sig64[32], &overflow);
+    if (overflow
+        || !secp256k1_fe_set_b32_limit(&rx, &sig64[0])
+        || !secp256k1_ge_set_xo_var(&item.pt[0], &rx, 0)) {
+        secp256k1_batch_add_checked(batch, 0);
+        return 1;
+    }
+
+    secp256k1_fe_get_b32(buf, &item.pt[1].x);
+    secp256k1_schnorrsig_challenge(&e, &sig64[0], msg, msglen, buf);
+    secp256k1_scalar_negate(&item.sc[0], &secp256k1_scalar_one);
+    secp256k1_scalar_negate(&item.sc[1], &e);
+    item.ecdsa = 0;
+    secp256k1_batch_push(ctx, batch, &item);
+    return 1;
+}
+
+int secp256k1_batch_add_xonlypub_tweak_check(const secp256k1_context* ctx, secp256k1_batch *batch, const unsigned char *tweaked_pubkey32, int tweaked_pk_parity, const secp256k1_xonly_pubkey *internal_pubkey, const unsigned char *tweak32) {
+    secp256k1_batch_item item;
+    secp256k1_fe qx;
+    int overflow;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(batch != NULL);
+    ARG_CHECK(tweaked_pubkey32 != NULL);
+    ARG_CHECK(internal_pubkey != NULL);
+    ARG_CHECK(tweak32 != NULL);
+
+    if (!secp256k1_xonly_pubkey_load(ctx, &item.pt[0], internal_pubkey)) {
+        return 0;
+    }
+    secp256k1_scalar_set_b32(&item.g_sc, tweak32, &overflow);
+    if (overflow
+        || (tweaked_pk_parity != 0 && tweaked_pk_parity != 1)
+        || !secp256k1_fe_set_b32_limit(&qx, tweaked_pubkey32)
+        || !secp256k1_ge_set_xo_var(&item.pt[1], &qx, tweaked_pk_parity)) {
+        secp256k1_batch_add_checked(batch, 0);
+        return 1;
+    }
+
+    item.sc[0] = secp256k1_scalar_one;
+    secp256k1_scalar_negate(&item.sc[1], &secp256k1_scalar_one);
+    item.ecdsa = 0;
+    secp256k1_batch_push(ctx, batch, &item);
+    return 1;
+}
+
+int secp256k1_batch_verify(const secp256k1_context* ctx, secp256k1_batch *batch) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(batch != NULL);
+
+    secp256k1_batch_flush(ctx, batch);
+    return batch->result;
+}
+
+#endif
@@ -0,0 +1,194 @@
+/***********************************************************************
+ * Distributed under the MIT software license, see the accompanying    *
+ * file COPYING or https://www.opensource.org/licenses/mit-license.php.*
+ ***********************************************************************/
+
+#ifndef SECP256K1_MODULE_BATCH_TESTS_H
+#define SECP256K1_MODULE_BATCH_TESTS_H
+
+#include "../../../include/secp256k1_batch.h"
+
+#define BATCH_TEST_MAX_ITEMS 96
+
+typedef struct {
+    int invalid[BATCH_TEST_MAX_ITEMS];
+    size_t n_invalid;
+} batch_test_invalid_data;
+
+static void batch_test_invalid_callback(size_t idx, void *data) {
+    batch_test_invalid_data *d = (batch_test_invalid_data *)data;
+    CHECK(idx < BATCH_TEST_MAX_ITEMS);
+    /* Every invalid item is reported exactly once. */
+    CHECK(d->invalid[idx] == 0);
+    d->invalid[idx] = 1;
+    d->n_invalid++;
+}
+
+static void test_batch_api(void) {
+    secp256k1_scratch_space *scratch = secp256k1_scratch_space_create(CTX, 4096);
+    secp256k1_batch *batch;
+    unsigned char sk[32];
+    unsigned char msg[32];
+    unsigned char sig64[64];
+    unsigned char tweaked_pk32[32];
+    secp256k1_keypair keypair;
+    secp256k1_xonly_pubkey xonly_pk, tweaked_xonly_pk;
+    secp256k1_pubkey pk, zero_pk, tweaked_pk;
+    secp256k1_ecdsa_signature sig;
+    int recid = 0, bad_recid = 4, pk_parity;
+
+    memset(&zero_pk, 0, sizeof(zero_pk));
+    secp256k1_testrand256(sk);
+    secp256k1_testrand256(msg);
+    CHECK(secp256k1_keypair_create(CTX, &keypair, sk) == 1);
+    CHECK(secp256k1_keypair_xonly_pub(CTX, &xonly_pk, NULL, &keypair) == 1);
+    CHECK(secp256k1_keypair_pub(CTX, &pk, &keypair) == 1);
+    CHECK(secp256k1_schnorrsig_sign32(CTX, sig64, msg, &keypair, NULL) == 1);
+    CHECK(secp256k1_ecdsa_sign(CTX, &sig, msg, sk, NULL, NULL) == 1);
+    CHECK(secp256k1_xonly_pubkey_tweak_add(CTX, &tweaked_pk, &xonly_pk, msg) == 1);
+    CHECK(secp256k1_xonly_pubkey_from_pubkey(CTX, &tweaked_xonly_pk, &pk_parity, &tweaked_pk) == 1);
+    CHECK(secp256k1_xonly_pubkey_serialize(CTX, tweaked_pk32, &tweaked_xonly_pk) == 1);
+
+    CHECK_ILLEGAL(CTX, secp256k1_batch_create(CTX, NULL));
+    batch = secp256k1_batch_create(CTX, scratch);
+    CHECK(batch != NULL);
+    CHECK(secp256k1_batch_verify(CTX, batch) == 1);
+
+    CHECK(secp256k1_batch_add_ecdsa(CTX, batch, &sig, msg, &pk, NULL) == 1);
+    CHECK(secp256k1_batch_add_ecdsa(CTX, batch, &sig, msg, &pk, &recid) == 1);
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_ecdsa(CTX, NULL, &sig, msg, &pk, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_ecdsa(CTX, batch, NULL, msg, &pk, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_ecdsa(CTX, batch, &sig, NULL, &pk, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_ecdsa(CTX, batch, &sig, msg, NULL, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_ecdsa(CTX, batch, &sig, msg, &zero_pk, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_ecdsa(CTX, batch, &sig, msg, &pk, &bad_recid));
+
+    CHECK(secp256k1_batch_add_schnorrsig(CTX, batch, sig64, msg, sizeof(msg), &xonly_pk) == 1);
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_schnorrsig(CTX, NULL, sig64, msg, sizeof(msg), &xonly_pk));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_schnorrsig(CTX, batch, NULL, msg, sizeof(msg), &xonly_pk));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_schnorrsig(CTX, batch, sig64, NULL, sizeof(msg), &xonly_pk));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_schnorrsig(CTX, batch, sig64, msg, sizeof(msg), NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_schnorrsig(CTX, batch, sig64, msg, sizeof(msg), (secp256k1_xonly_pubkey *)&zero_pk));
+
+    CHECK(secp256k1_batch_add_xonlypub_tweak_check(CTX, batch, tweaked_pk32, pk_parity, &xonly_pk, msg) == 1);
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_xonlypub_tweak_check(CTX, NULL, tweaked_pk32, pk_parity, &xonly_pk, msg));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_xonlypub_tweak_check(CTX, batch, NULL, pk_parity, &xonly_pk, msg));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_xonlypub_tweak_check(CTX, batch, tweaked_pk32, pk_parity, NULL, msg));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_add_xonlypub_tweak_check(CTX, batch, tweaked_pk32, pk_parity, &xonly_pk, NULL));
+
+    CHECK_ILLEGAL_VOID(CTX, secp256k1_batch_set_invalid_callback(CTX, NULL, NULL, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_batch_verify(CTX, NULL));
+    CHECK(secp256k1_batch_verify(CTX, batch) == 1);
+
+    /* An invalid pk_parity makes the batch fail. */
+    CHECK(secp256k1_batch_add_xonlypub_tweak_check(CTX, batch, tweaked_pk32, 2, &xonly_pk, msg) == 1);
+    CHECK(secp256k1_batch_verify(CTX, batch) == 0);
+    /* The result is sticky. */
+    CHECK(secp256k1_batch_add_schnorrsig(CTX, batch, sig64, msg, sizeof(msg), &xonly_pk) == 1);
+    CHECK(secp256k1_batch_verify(CTX, batch) == 0);
+
+    secp256k1_batch_destroy(CTX, batch);
+    secp256k1_batch_destroy(CTX, NULL);
+    secp256k1_scratch_space_destroy(CTX, scratch);
+}
+
+/* Adds a random mix of valid and invalid items to a batch created with a
+ * random scratch space size (forcing flushes at various points), and checks
+ * that exactly the invalid items are reported. */
+static void test_batch_random(void) {
+    secp256k1_scratch_space *scratch = secp256k1_scratch_space_create(CTX, secp256k1_testrand_int(1 << 15));
+    secp256k1_batch *batch = secp256k1_batch_create(CTX, scratch);
+    batch_test_invalid_data data;
+    int expected_invalid[BATCH_TEST_MAX_ITEMS];
+    size_t n = secp256k1_testrand_int(BATCH_TEST_MAX_ITEMS + 1);
+    size_t n_expected_invalid = 0;
+    size_t i;
+
+    CHECK(batch != NULL);
+    memset(&data, 0, sizeof(data));
+    secp256k1_batch_set_invalid_callback(CTX, batch, batch_test_invalid_callback, &data);
+
+    for (i = 0; i < n; i++) {
+        unsigned char sk[32];
+        unsigned char msg[32];
+        secp256k1_keypair keypair;
+        secp256k1_xonly_pubkey xonly_pk;
+        int invalid = secp256k1_testrand_int(8) == 0;
+
+        secp256k1_testrand256(sk);
+        secp256k1_testrand256(msg);
+        CHECK(secp256k1_keypair_create(CTX, &keypair, sk) == 1);
+        CHECK(secp256k1_keypair_xonly_pub(CTX, &xonly_pk, NULL, &keypair) == 1);
+        switch (secp256k1_testrand_int(3)) {
+        case 0: {
+            secp256k1_scalar key, m, sigr, sigs;
+            secp256k1_ecdsa_signature sig;
+            secp256k1_pubkey pk;
+            int recid;
+            secp256k1_scalar_set_b32(&key, sk, NULL);
+            secp256k1_scalar_set_b32(&m, msg, NULL);
+            random_sign(&sigr, &sigs, &key, &m, &recid);
+            secp256k1_ecdsa_signature_save(&sig, &sigr, &sigs);
+            CHECK(secp256k1_keypair_pub(CTX, &pk, &keypair) == 1);
+            if (secp256k1_testrand_int(4) == 0) {
+                /* A wrong hint does not make the signature invalid. */
+                recid ^= 1 + secp256k1_testrand_int(3);
+            }
+            if (invalid) {
+                msg[secp256k1_testrand_int(32)] ^= 1 + secp256k1_testrand_int(255);
+            }
+            CHECK(secp256k1_batch_add_ecdsa(CTX, batch, &sig, msg, &pk, secp256k1_testrand_int(8) == 0 ? NULL : &recid) == 1);
+            break;
+        }
+        case 1: {
+            unsigned char sig64[64];
+            CHECK(secp256k1_schnorrsig_sign32(CTX, sig64, msg, &keypair, NULL) == 1);
+            if (invalid) {
+                sig64[secp256k1_testrand_int(64)] ^= 1 + secp256k1_testrand_int(255);
+            }
+            CHECK(secp256k1_batch_add_schnorrsig(CTX, batch, sig64, msg, sizeof(msg), &xonly_pk) == 1);
+            break;
+        }
+        default: {
+            secp256k1_pubkey tweaked_pk;
+            secp256k1_xonly_pubkey tweaked_xonly_pk;
+            unsigned char tweaked_pk32[32];
+            int pk_parity;
+            CHECK(secp256k1_xonly_pubkey_tweak_add(CTX, &tweaked_pk, &xonly_pk, msg) == 1);
+            CHECK(secp256k1_xonly_pubkey_from_pubkey(CTX, &tweaked_xonly_pk, &pk_parity, &tweaked_pk) == 1);
+            CHECK(secp256k1_xonly_pubkey_serialize(CTX, tweaked_pk32, &tweaked_xonly_pk) == 1);
+            if (invalid) {
+                pk_parity = !pk_parity;
+            }
+            CHECK(secp256k1_batch_add_xonlypub_tweak_check(CTX, batch, tweaked_pk32, pk_parity, &xonly_pk, msg) == 1);
+        }
+        }
+        expected_invalid[i] = invalid;
+        n_expected_invalid += invalid;
+
+        if (secp256k1_testrand_int(16) == 0) {
+            CHECK(secp256k1_batch_verify(CTX, batch) == (n_expected_invalid == 0));
+        }
+    }
+    CHECK(secp256k1_batch_verify(CTX, batch) == (n_expected_invalid == 0));
+    CHECK(data.n_invalid == n_expected_invalid);
+    for (i = 0; i < n; i++) {
+        CHECK(data.invalid[i] == expected_invalid[i]);
+    }
+
+    secp256k1_batch_destroy(CTX, batch);
+    secp256k1_scratch_space_destroy(CTX, scratch);
+}
+
+static void run_batch_tests(void) {
+    int i;
+
+    test_batch_api();
+    for (i = 0; i < COUNT; i++) {
+        test_batch_random();
+    }
+}
+
+#undef BATCH_TEST_MAX_ITEMS
+
+#endif
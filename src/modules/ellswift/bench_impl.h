@@ -12,6 +12,11 @@ typedef struct {
     secp256k1_context *ctx;
     secp256k1_pubkey point[256];
     unsigned char rnd64[64];
+    const secp256k1_pubkey *point_ptrs[256];
+    const unsigned char *rnd32_ptrs[256];
+    const unsigned char *ell64_ptrs[256];
+    unsigned char ell64s[256 * 64];
+    size_t batch_size;
 } bench_ellswift_data;
 
 static void bench_ellswift_setup(void *arg) {
@@ -71,6 +76,40 @@ static void bench_ellswift_decode(void *arg, int iters) {
     }
 }
 
+static void bench_ellswift_batch_setup(void *arg) {
+    int i;
+    bench_ellswift_data *data = (bench_ellswift_data*)arg;
+
+    bench_ellswift_setup(arg);
+    for (i = 0; i < 256; ++i) {
+        data->point_ptrs[i] = &data->point[i];
+        data->rnd32_ptrs[i] = data->rnd64 + (i % 33);
+        data->ell64_ptrs[i] = &data->ell64s[64 * i];
+    }
+    CHECK(secp256k1_ellswift_encode_batch(data->ctx, data->ell64s, data->point_ptrs, data->rnd32_ptrs, 256));
+}
+
+static void bench_ellswift_encode_batch(void *arg, int iters) {
+    size_t i;
+    bench_ellswift_data *data = (bench_ellswift_data*)arg;
+
+    /* The batch size divides 256, so batches never wrap around. */
+    for (i = 0; i < (size_t)iters; i += data->batch_size) {
+        size_t n = (size_t)iters - i < data->batch_size ? (size_t)iters - i : data->batch_size;
+        CHECK(secp256k1_ellswift_encode_batch(data->ctx, data->ell64s, &data->point_ptrs[i & 255], &data->rnd32_ptrs[i & 255], n));
+    }
+}
+
+static void bench_ellswift_decode_batch(void *arg, int iters) {
+    size_t i;
+    bench_ellswift_data *data = (bench_ellswift_data*)arg;
+
+    for (i = 0; i < (size_t)iters; i += data->batch_size) {
+        size_t n = (size_t)iters - i < data->batch_size ? (size_t)iters - i : data->batch_size;
+        CHECK(secp256k1_ellswift_decode_batch(data->ctx, data->point, &data->ell64_ptrs[i & 255], n) == 1);
+    }
+}
+
 static void bench_ellswift_xdh(void *arg, int iters) {
     int i;
     bench_ellswift_data *data = (bench_ellswift_data*)arg;
@@ -100,6 +139,23 @@ void run_ellswift_bench(int iters, int argc, char **argv) {
     if (d || have_flag(argc, argv, "ellswift") || have_flag(argc, argv, "keygen") || have_flag(argc, argv, "ellswift_keygen")) run_benchmark("ellswift_keygen", bench_ellswift_create, bench_ellswift_setup, NULL, &data, 10, iters);
     if (d || have_flag(argc, argv, "ellswift") || have_flag(argc, argv, "ecdh") || have_flag(argc, argv, "ellswift_ecdh")) run_benchmark("ellswift_ecdh", bench_ellswift_xdh, bench_ellswift_setup, NULL, &data, 10, iters);
 
+    if (d || have_flag(argc, argv, "ellswift") || have_flag(argc, argv, "ellswift_encode_batch")) {
+        /* Reports the time per key for increasing batch sizes. */
+        for (data.batch_size = 1; data.batch_size <= 256; data.batch_size *= 2) {
+            char name[64];
+            sprintf(name, "ellswift_encode_batch_%d", (int)data.batch_size);
+            run_benchmark(name, bench_ellswift_encode_batch, bench_ellswift_batch_setup, NULL, &data, 10, iters);
+        }
+    }
+    if (d || have_flag(argc, argv, "ellswift") || have_flag(argc, argv, "ellswift_decode_batch")) {
+        /* Reports the time per key for increasing batch sizes. */
+        for (data.batch_size = 1; data.batch_size <= 256; data.batch_size *= 2) {
+            char name[64];
+            sprintf(name, "ellswift_decode_batch_%d", (int)data.batch_size);
+            run_benchmark(name, bench_ellswift_decode_batch, bench_ellswift_batch_setup, NULL, &data, 10, iters);
+        }
+    }
+
     secp256k1_context_destroy(data.ctx);
 }
 
@@ -146,26 +146,21 @@ static void secp256k1_ellswift_swiftec_var(secp256k1_ge *p, const secp256k1_fe *
     secp256k1_ge_set_xo_var(p, &x, secp256k1_fe_is_odd(t));
 }
 
-/* Try to complete an ElligatorSwift encoding (u, t) for X coordinate x, given u and x.
- *
- * There may be up to 8 distinct t values such that (u, t) decodes back to x, but also
- * fewer, or none at all. Each such partial inverse can be accessed individually using a
- * distinct input argument c (in range 0-7), and some or all of these may return failure.
- * The following guarantees exist:
- * - Given (x, u), no two distinct c values give the same successful result t.
- * - Every successful result maps back to x through secp256k1_ellswift_xswiftec_var.
- * - Given (x, u), all t values that map back to x can be reached by combining the
- *   successful results from this function over all c values, with the exception of:
- *   - this function cannot be called with u=0
- *   - no result with t=0 will be returned
- *   - no result for which u^3 + t^2 + 7 = 0 will be returned.
- *
- * The rather unusual encoding of bits in c (a large "if" based on the middle bit, and then
- * using the low and high bits to pick signs of square roots) is to match the paper's
- * encoding more closely: c=0 through c=3 match branches 1..4 in the paper, while c=4 through
- * c=7 are copies of those with an additional negation of sqrt(w).
- */
-static int secp256k1_ellswift_xswiftec_inv_var(secp256k1_fe *t, const secp256k1_fe *x_in, const secp256k1_fe *u_in, int c) {
+/* State of secp256k1_ellswift_xswiftec_inv_var before its field inversion, which
+ * makes it possible to share that inversion between several encodings. */
+typedef struct {
+    secp256k1_fe x, u;
+    /* The field element to invert (nonzero). */
+    secp256k1_fe s;
+    /* u^3+7 if (c & 2) = 0, r otherwise. */
+    secp256k1_fe n;
+    int c;
+} secp256k1_ellswift_xswiftec_inv_state;
+
+/* The part of secp256k1_ellswift_xswiftec_inv_var that decides whether it succeeds.
+ * If it returns 1, st holds the state that secp256k1_ellswift_xswiftec_inv_finish_var
+ * completes into t. */
+static int secp256k1_ellswift_xswiftec_inv_prepare_var(secp256k1_ellswift_xswiftec_inv_state *st, const secp256k1_fe *x_in, const secp256k1_fe *u_in, int c) {
     /* The implemented algorithm is this (all arithmetic, except involving c, is mod p):
      *
      * - If (c & 2) = 0:
@@ -186,7 +181,7 @@ static int secp256k1_ellswift_xswiftec_inv_var(secp256k1_fe *t, const secp256k1_
      * - If (c & 5) = 4: return  w*(c3*u + v).
      * - If (c & 5) = 5: return -w*(c4*u + v).
      */
-    secp256k1_fe x = *x_in, u = *u_in, g, v, s, m, r, q;
+    secp256k1_fe x = *x_in, u = *u_in, g, s, m, r, q;
     int ret;
 
     secp256k1_fe_normalize_weak(&x);
@@ -238,12 +233,8 @@ static int secp256k1_ellswift_xswiftec_inv_var(secp256k1_fe *t, const secp256k1_
         secp256k1_fe_mul(&m, &s, &g);                   /* m = -(u^3 + 7)*(u^2 + u*x + x^2) */
         if (!secp256k1_fe_is_square_var(&m)) return 0;
 
-        /* Let s = -(u^3 + 7)/(u^2 + u*x + x^2) [second part] */
-        secp256k1_fe_inv_var(&s, &s);                   /* s = -1/(u^2 + u*x + x^2) [no div by 0] */
-        secp256k1_fe_mul(&s, &s, &g);                   /* s = -(u^3 + 7)/(u^2 + u*x + x^2) */
-
-        /* Let v = x. */
-        v = x;
+        /* The second part of s is computed after the inversion. */
+        st->n = g;
     } else {
         /* c is in {2, 3, 6, 7}. In this case we look for an inverse under the x3 formula. */
 
@@ -279,26 +270,83 @@ static int secp256k1_ellswift_xswiftec_inv_var(secp256k1_fe *t, const secp256k1_
         /* If s = 0, fail. */
         if (EXPECT(secp256k1_fe_normalizes_to_zero_var(&s), 0)) return 0;
 
+        /* v is computed after the inversion. */
+        st->n = r;
+    }
+
+    st->x = x;
+    st->u = u;
+    st->s = s;
+    st->c = c;
+    return 1;
+}
+
+/* Complete secp256k1_ellswift_xswiftec_inv_prepare_var, given sinv = 1/st->s. */
+static void secp256k1_ellswift_xswiftec_inv_finish_var(secp256k1_fe *t, const secp256k1_ellswift_xswiftec_inv_state *st, const secp256k1_fe *sinv) {
+    secp256k1_fe u = st->u, v, s, m;
+    int ret;
+
+    if (!(st->c & 2)) {
+        /* Let s = -(u^3 + 7)/(u^2 + u*x + x^2) [second part] */
+        secp256k1_fe_mul(&s, sinv, &st->n);             /* s = -(u^3 + 7)/(u^2 + u*x + x^2) */
+
+        /* Let v = x. */
+        v = st->x;
+    } else {
+        s = st->s;
+
         /* Let v = (r/s-u)/2. */
-        secp256k1_fe_inv_var(&v, &s);                   /* v = 1/s [no div by 0] */
-        secp256k1_fe_mul(&v, &v, &r);                   /* v = r/s */
+        secp256k1_fe_mul(&v, sinv, &st->n);             /* v = r/s */
+        secp256k1_fe_negate(&m, &u, 1);                 /* m = -u */
         secp256k1_fe_add(&v, &m);                       /* v = r/s-u */
         secp256k1_fe_half(&v);                          /* v = (r/s-u)/2 */
     }
 
     /* Let w = sqrt(s). */
     ret = secp256k1_fe_sqrt(&m, &s);                    /* m = sqrt(s) = w */
+#ifdef VERIFY
     VERIFY_CHECK(ret);
+#else
+    (void)ret;
+#endif
 
     /* Return logic. */
-    if ((c & 5) == 0 || (c & 5) == 5) {
+    if ((st->c & 5) == 0 || (st->c & 5) == 5) {
         secp256k1_fe_negate(&m, &m, 1);                 /* m = -w */
     }
     /* Now m = {-w if c&5=0 or c&5=5; w otherwise}. */
-    secp256k1_fe_mul(&u, &u, c&1 ? &secp256k1_ellswift_c4 : &secp256k1_ellswift_c3);
+    secp256k1_fe_mul(&u, &u, st->c&1 ? &secp256k1_ellswift_c4 : &secp256k1_ellswift_c3);
     /* u = {c4 if c&1=1; c3 otherwise}*u */
     secp256k1_fe_add(&u, &v);                           /* u = {c4 if c&1=1; c3 otherwise}*u + v */
     secp256k1_fe_mul(t, &m, &u);
+}
+
+/* Try to complete an ElligatorSwift encoding (u, t) for X coordinate x, given u and x.
+ *
+ * There may be up to 8 distinct t values such that (u, t) decodes back to x, but also
+ * fewer, or none at all. Each such partial inverse can be accessed individually using a
+ * distinct input argument c (in range 0-7), and some or all of these may return failure.
+ * The following guarantees exist:
+ * - Given (x, u), no two distinct c values give the same successful result t.
+ * - Every successful result maps back to x through secp256k1_ellswift_xswiftec_var.
+ * - Given (x, u), all t values that map back to x can be reached by combining the
+ *   successful results from this function over all c values, with the exception of:
+ *   - this function cannot be called with u=0
+ *   - no result with t=0 will be returned
+ *   - no result for which u^3 + t^2 + 7 = 0 will be returned.
+ *
+ * The rather unusual encoding of bits in c (a large "if" based on the middle bit, and then
+ * using the low and high bits to pick signs of square roots) is to match the paper's
+ * encoding more closely: c=0 through c=3 match branches 1..4 in the paper, while c=4 through
+ * c=7 are copies of those with an additional negation of sqrt(w).
+ */
+static int secp256k1_ellswift_xswiftec_inv_var(secp256k1_fe *t, const secp256k1_fe *x_in, const secp256k1_fe *u_in, int c) {
+    secp256k1_ellswift_xswiftec_inv_state st;
+    secp256k1_fe sinv;
+
+    if (!secp256k1_ellswift_xswiftec_inv_prepare_var(&st, x_in, u_in, c)) return 0;
+    secp256k1_fe_inv_var(&sinv, &st.s);
+    secp256k1_ellswift_xswiftec_inv_finish_var(t, &st, &sinv);
     return 1;
 }
 
@@ -324,13 +372,14 @@ static void secp256k1_ellswift_prng(unsigned char* out32, const secp256k1_sha256
     VERIFY_CHECK(((hash.bytes) >> 6) == (blocks + 1));
 }
 
-/** Find an ElligatorSwift encoding (u, t) for X coordinate x, and random Y coordinate.
+/** Find an ElligatorSwift encoding (u, t) for X coordinate x, and random Y coordinate, up to
+ * the field inversion in the computation of t.
  *
- * u32 is the 32-byte big endian encoding of u; t is the output field element t that still
- * needs encoding.
+ * u32 is the 32-byte big endian encoding of u; st is the state from which
+ * secp256k1_ellswift_xswiftec_inv_finish_var computes t.
  *
  * hasher is a hasher in the secp256k1_ellswift_prng sense, with the same restrictions. */
-static void secp256k1_ellswift_xelligatorswift_var(unsigned char *u32, secp256k1_fe *t, const secp256k1_fe *x, const secp256k1_sha256 *hasher) {
+static void secp256k1_ellswift_xelligatorswift_prepare_var(unsigned char *u32, secp256k1_ellswift_xswiftec_inv_state *st, const secp256k1_fe *x, const secp256k1_sha256 *hasher) {
     /* Pool of 3-bit branch values. */
     unsigned char branch_hash[32];
     /* Number of 3-bit values in branch_hash left. */
@@ -361,11 +410,26 @@ static void secp256k1_ellswift_xelligatorswift_var(unsigned char *u32, secp256k1
          * probability event that we do not bother. */
         VERIFY_CHECK(!secp256k1_fe_normalizes_to_zero_var(&u));
 
-        /* Find a remainder t, and return it if found. */
-        if (EXPECT(secp256k1_ellswift_xswiftec_inv_var(t, x, &u, branch), 0)) break;
+        /* Find a remainder t, and return (the state for computing) it if found. */
+        if (EXPECT(secp256k1_ellswift_xswiftec_inv_prepare_var(st, x, &u, branch), 0)) break;
     }
 }
 
+/** Find an ElligatorSwift encoding (u, t) for X coordinate x, and random Y coordinate.
+ *
+ * u32 is the 32-byte big endian encoding of u; t is the output field element t that still
+ * needs encoding.
+ *
+ * hasher is a hasher in the secp256k1_ellswift_prng sense, with the same restrictions. */
+static void secp256k1_ellswift_xelligatorswift_var(unsigned char *u32, secp256k1_fe *t, const secp256k1_fe *x, const secp256k1_sha256 *hasher) {
+    secp256k1_ellswift_xswiftec_inv_state st;
+    secp256k1_fe sinv;
+
+    secp256k1_ellswift_xelligatorswift_prepare_var(u32, &st, x, hasher);
+    secp256k1_fe_inv_var(&sinv, &st.s);
+    secp256k1_ellswift_xswiftec_inv_finish_var(t, &st, &sinv);
+}
+
 /** Find an ElligatorSwift encoding (u, t) for point P.
  *
  * This is similar secp256k1_ellswift_xelligatorswift_var, except it takes a full group element p
@@ -396,6 +460,25 @@ static void secp256k1_ellswift_sha256_init_encode(secp256k1_sha256* hash) {
     hash->bytes = 64;
 }
 
+/** Set up the hasher state for encoding pubkey p with randomness rnd32. */
+static void secp256k1_ellswift_encode_hasher(secp256k1_sha256 *hash, secp256k1_ge *p, const unsigned char *rnd32) {
+    unsigned char p64[64] = {0};
+    size_t ser_size;
+    int ser_ret;
+
+    /* The used RNG is H(pubkey || "\x00"*31 || rnd32 || cnt++), using BIP340 tagged hash with
+     * tag "secp256k1_ellswift_encode". */
+    secp256k1_ellswift_sha256_init_encode(hash);
+    ser_ret = secp256k1_eckey_pubkey_serialize(p, p64, &ser_size, 1);
+#ifdef VERIFY
+    VERIFY_CHECK(ser_ret && ser_size == 33);
+#else
+    (void)ser_ret;
+#endif
+    secp256k1_sha256_write(hash, p64, sizeof(p64));
+    secp256k1_sha256_write(hash, rnd32, 32);
+}
+
 int secp256k1_ellswift_encode(const secp256k1_context *ctx, unsigned char *ell64, const secp256k1_pubkey *pubkey, const unsigned char *rnd32) {
     secp256k1_ge p;
     VERIFY_CHECK(ctx != NULL);
@@ -405,22 +488,10 @@ int secp256k1_ellswift_encode(const secp256k1_context *ctx, unsigned char *ell64
 
     if (secp256k1_pubkey_load(ctx, &p, pubkey)) {
         secp256k1_fe t;
-        unsigned char p64[64] = {0};
-        size_t ser_size;
-        int ser_ret;
         secp256k1_sha256 hash;
 
-        /* Set up hasher state; the used RNG is H(pubkey || "\x00"*31 || rnd32 || cnt++), using
-         * BIP340 tagged hash with tag "secp256k1_ellswift_encode". */
-        secp256k1_ellswift_sha256_init_encode(&hash);
-        ser_ret = secp256k1_eckey_pubkey_serialize(&p, p64, &ser_size, 1);
-#ifdef VERIFY
-        VERIFY_CHECK(ser_ret && ser_size == 33);
-#else
-        (void)ser_ret;
-#endif
-        secp256k1_sha256_write(&hash, p64, sizeof(p64));
-        secp256k1_sha256_write(&hash, rnd32, 32);
+        /* Set up hasher state. */
+        secp256k1_ellswift_encode_hasher(&hash, &p, rnd32);
 
         /* Compute ElligatorSwift encoding and construct output. */
         secp256k1_ellswift_elligatorswift_var(ell64, &t, &p, &hash); /* puts u in ell64[0..32] */
@@ -501,6 +572,121 @@ int secp256k1_ellswift_decode(const secp256k1_context *ctx, secp256k1_pubkey *pu
     return 1;
 }
 
+/* Number of keys whose field inversions are shared in secp256k1_ellswift_encode_batch and
+ * secp256k1_ellswift_decode_batch. */
+#define SECP256K1_ELLSWIFT_BATCH_SIZE 32
+
+/** Set r[i] = 1/a[i] for all i < n, using a single field inversion (Montgomery's trick).
+ *  The a[i] must be nonzero, and r and a must not overlap. */
+static void secp256k1_ellswift_inv_all_var(secp256k1_fe *r, const secp256k1_fe *a, size_t n) {
+    secp256k1_fe u;
+    size_t i;
+
+    if (n == 0) {
+        return;
+    }
+    r[0] = a[0];
+    for (i = 1; i < n; i++) {
+        secp256k1_fe_mul(&r[i], &r[i - 1], &a[i]);
+    }
+    secp256k1_fe_inv_var(&u, &r[n - 1]);
+    for (i = n - 1; i > 0; i--) {
+        secp256k1_fe_mul(&r[i], &r[i - 1], &u);
+        secp256k1_fe_mul(&u, &u, &a[i]);
+    }
+    r[0] = u;
+}
+
+int secp256k1_ellswift_encode_batch(const secp256k1_context *ctx, unsigned char *ell64s, const secp256k1_pubkey * const *pubkeys, const unsigned char * const *rnd32s, size_t n_keys) {
+    secp256k1_ellswift_xswiftec_inv_state st[SECP256K1_ELLSWIFT_BATCH_SIZE];
+    secp256k1_fe s[SECP256K1_ELLSWIFT_BATCH_SIZE], sinv[SECP256K1_ELLSWIFT_BATCH_SIZE];
+    secp256k1_ge p[SECP256K1_ELLSWIFT_BATCH_SIZE];
+    size_t idx[SECP256K1_ELLSWIFT_BATCH_SIZE];
+    size_t i, j, n, n_valid;
+    int ret = 1;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(n_keys == 0 || ell64s != NULL);
+    if (n_keys > 0) {
+        memset(ell64s, 0, n_keys * 64);
+    }
+    ARG_CHECK(n_keys == 0 || pubkeys != NULL);
+    ARG_CHECK(n_keys == 0 || rnd32s != NULL);
+    for (i = 0; i < n_keys; i++) {
+        ARG_CHECK(pubkeys[i] != NULL);
+        ARG_CHECK(rnd32s[i] != NULL);
+    }
+
+    for (i = 0; i < n_keys; i += n) {
+        n = n_keys - i < SECP256K1_ELLSWIFT_BATCH_SIZE ? n_keys - i : SECP256K1_ELLSWIFT_BATCH_SIZE;
+        /* Find u and everything up to the inversion in the computation of t for every key, in
+         * the same way as secp256k1_ellswift_encode. Only successful attempts get that far, so
+         * every key needs exactly one inversion. */
+        n_valid = 0;
+        for (j = 0; j < n; j++) {
+            secp256k1_sha256 hash;
+            if (!secp256k1_pubkey_load(ctx, &p[n_valid], pubkeys[i + j])) {
+                ret = 0;
+                continue;
+            }
+            secp256k1_ellswift_encode_hasher(&hash, &p[n_valid], rnd32s[i + j]);
+            secp256k1_ellswift_xelligatorswift_prepare_var(ell64s + 64 * (i + j), &st[n_valid], &p[n_valid].x, &hash);
+            s[n_valid] = st[n_valid].s;
+            idx[n_valid] = i + j;
+            n_valid++;
+        }
+        secp256k1_ellswift_inv_all_var(sinv, s, n_valid);
+        for (j = 0; j < n_valid; j++) {
+            secp256k1_fe t;
+            secp256k1_ellswift_xswiftec_inv_finish_var(&t, &st[j], &sinv[j]);
+            /* Match the Y coordinate, as in secp256k1_ellswift_elligatorswift_var. */
+            secp256k1_fe_normalize_var(&t);
+            if (secp256k1_fe_is_odd(&t) != secp256k1_fe_is_odd(&p[j].y)) {
+                secp256k1_fe_negate(&t, &t, 1);
+                secp256k1_fe_normalize_var(&t);
+            }
+            secp256k1_fe_get_b32(ell64s + 64 * idx[j] + 32, &t);
+        }
+    }
+    return ret;
+}
+
+int secp256k1_ellswift_decode_batch(const secp256k1_context *ctx, secp256k1_pubkey *pubkeys, const unsigned char * const *ell64s, size_t n_keys) {
+    secp256k1_fe xn[SECP256K1_ELLSWIFT_BATCH_SIZE], xd[SECP256K1_ELLSWIFT_BATCH_SIZE], xdinv[SECP256K1_ELLSWIFT_BATCH_SIZE];
+    int odd[SECP256K1_ELLSWIFT_BATCH_SIZE];
+    size_t i, j, n;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(n_keys == 0 || pubkeys != NULL);
+    if (n_keys > 0) {
+        memset(pubkeys, 0, n_keys * sizeof(*pubkeys));
+    }
+    ARG_CHECK(n_keys == 0 || ell64s != NULL);
+    for (i = 0; i < n_keys; i++) {
+        ARG_CHECK(ell64s[i] != NULL);
+    }
+
+    for (i = 0; i < n_keys; i += n) {
+        n = n_keys - i < SECP256K1_ELLSWIFT_BATCH_SIZE ? n_keys - i : SECP256K1_ELLSWIFT_BATCH_SIZE;
+        for (j = 0; j < n; j++) {
+            secp256k1_fe u, t;
+            secp256k1_fe_set_b32_mod(&u, ell64s[i + j]);
+            secp256k1_fe_set_b32_mod(&t, ell64s[i + j] + 32);
+            secp256k1_fe_normalize_var(&t);
+            secp256k1_ellswift_xswiftec_frac_var(&xn[j], &xd[j], &u, &t);
+            odd[j] = secp256k1_fe_is_odd(&t);
+        }
+        /* The denominators are never zero. */
+        secp256k1_ellswift_inv_all_var(xdinv, xd, n);
+        for (j = 0; j < n; j++) {
+            secp256k1_fe x;
+            secp256k1_ge p;
+            secp256k1_fe_mul(&x, &xn[j], &xdinv[j]);
+            secp256k1_ge_set_xo_var(&p, &x, odd[j]);
+            secp256k1_pubkey_save(&pubkeys[i + j], &p);
+        }
+    }
+    return 1;
+}
+
 static int ellswift_xdh_hash_function_prefix(unsigned char *output, const unsigned char *x32, const unsigned char *ell_a64, const unsigned char *ell_b64, void *data) {
     secp256k1_sha256 sha;
 
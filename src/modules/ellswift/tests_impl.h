@@ -239,6 +239,93 @@ void run_ellswift_tests(void) {
         /* Compare with original. */
         CHECK(secp256k1_ge_eq_var(&g, &g2));
     }
+    /* Verify that secp256k1_ellswift_encode_batch and decode_batch give the same results
+     * as secp256k1_ellswift_encode and decode. */
+    {
+        size_t n_tests = sizeof(ellswift_decode_tests) / sizeof(ellswift_decode_tests[0]);
+        secp256k1_pubkey pubkeys[80], pubkeys2[80], pubkey;
+        const secp256k1_pubkey *pubkey_ptrs[80];
+        unsigned char rnd32s[80][32], ell64s[80 * 64], ell64[64];
+        const unsigned char *rnd32_ptrs[80], *ell64_ptrs[80];
+        secp256k1_ge g;
+        size_t j, n;
+
+        CHECK(n_tests <= 80);
+        for (j = 0; j < n_tests; j++) {
+            ell64_ptrs[j] = ellswift_decode_tests[j].enc;
+        }
+        CHECK(secp256k1_ellswift_decode_batch(CTX, pubkeys, ell64_ptrs, n_tests));
+        for (j = 0; j < n_tests; j++) {
+            CHECK(secp256k1_pubkey_load(CTX, &g, &pubkeys[j]));
+            CHECK(fe_equal(&ellswift_decode_tests[j].x, &g.x));
+            CHECK(secp256k1_fe_is_odd(&g.y) == ellswift_decode_tests[j].odd_y);
+        }
+
+        for (i = 0; i < 2 * COUNT; i++) {
+            n = secp256k1_testrand_int(81);
+            for (j = 0; j < n; j++) {
+                random_group_element_test(&g);
+                secp256k1_pubkey_save(&pubkeys[j], &g);
+                secp256k1_testrand256(rnd32s[j]);
+                pubkey_ptrs[j] = &pubkeys[j];
+                rnd32_ptrs[j] = rnd32s[j];
+                ell64_ptrs[j] = &ell64s[64 * j];
+            }
+            CHECK(secp256k1_ellswift_encode_batch(CTX, ell64s, pubkey_ptrs, rnd32_ptrs, n));
+            CHECK(secp256k1_ellswift_decode_batch(CTX, pubkeys2, ell64_ptrs, n));
+            for (j = 0; j < n; j++) {
+                CHECK(secp256k1_ellswift_encode(CTX, ell64, &pubkeys[j], rnd32s[j]));
+                CHECK(secp256k1_memcmp_var(ell64, &ell64s[64 * j], 64) == 0);
+                CHECK(secp256k1_memcmp_var(&pubkeys[j], &pubkeys2[j], sizeof(pubkeys[j])) == 0);
+            }
+
+            /* Random encodings */
+            for (j = 0; j < n; j++) {
+                secp256k1_testrand256_test(&ell64s[64 * j]);
+                secp256k1_testrand256_test(&ell64s[64 * j + 32]);
+            }
+            CHECK(secp256k1_ellswift_decode_batch(CTX, pubkeys2, ell64_ptrs, n));
+            for (j = 0; j < n; j++) {
+                CHECK(secp256k1_ellswift_decode(CTX, &pubkey, &ell64s[64 * j]));
+                CHECK(secp256k1_memcmp_var(&pubkey, &pubkeys2[j], sizeof(pubkey)) == 0);
+            }
+        }
+
+        /* An invalid pubkey gives a zeroed encoding, and the others are unaffected. */
+        n = 40;
+        for (j = 0; j < n; j++) {
+            random_group_element_test(&g);
+            secp256k1_pubkey_save(&pubkeys[j], &g);
+            secp256k1_testrand256(rnd32s[j]);
+            pubkey_ptrs[j] = &pubkeys[j];
+            rnd32_ptrs[j] = rnd32s[j];
+        }
+        memset(&pubkeys[33], 0, sizeof(pubkeys[33]));
+        CHECK_ILLEGAL(CTX, secp256k1_ellswift_encode_batch(CTX, ell64s, pubkey_ptrs, rnd32_ptrs, n));
+        memset(ell64, 0, sizeof(ell64));
+        CHECK(secp256k1_memcmp_var(ell64, &ell64s[64 * 33], 64) == 0);
+        for (j = 0; j < n; j++) {
+            if (j == 33) continue;
+            CHECK(secp256k1_ellswift_encode(CTX, ell64, &pubkeys[j], rnd32s[j]));
+            CHECK(secp256k1_memcmp_var(ell64, &ell64s[64 * j], 64) == 0);
+        }
+
+        /* API test */
+        CHECK(secp256k1_ellswift_encode_batch(CTX, NULL, NULL, NULL, 0));
+        CHECK(secp256k1_ellswift_decode_batch(CTX, NULL, NULL, 0));
+        CHECK_ILLEGAL(CTX, secp256k1_ellswift_encode_batch(CTX, NULL, pubkey_ptrs, rnd32_ptrs, 1));
+        CHECK_ILLEGAL(CTX, secp256k1_ellswift_encode_batch(CTX, ell64s, NULL, rnd32_ptrs, 1));
+        CHECK_ILLEGAL(CTX, secp256k1_ellswift_encode_batch(CTX, ell64s, pubkey_ptrs, NULL, 1));
+        pubkey_ptrs[1] = NULL;
+        CHECK_ILLEGAL(CTX, secp256k1_ellswift_encode_batch(CTX, ell64s, pubkey_ptrs, rnd32_ptrs, 2));
+        pubkey_ptrs[1] = &pubkeys[1];
+        rnd32_ptrs[1] = NULL;
+        CHECK_ILLEGAL(CTX, secp256k1_ellswift_encode_batch(CTX, ell64s, pubkey_ptrs, rnd32_ptrs, 2));
+        CHECK_ILLEGAL(CTX, secp256k1_ellswift_decode_batch(CTX, NULL, ell64_ptrs, 1));
+        CHECK_ILLEGAL(CTX, secp256k1_ellswift_decode_batch(CTX, pubkeys2, NULL, 1));
+        ell64_ptrs[1] = NULL;
+        CHECK_ILLEGAL(CTX, secp256k1_ellswift_decode_batch(CTX, pubkeys2, ell64_ptrs, 2));
+    }
     /* Verify the behavior of secp256k1_ellswift_create */
     for (i = 0; i < 400 * COUNT; i++) {
         unsigned char auxrnd32[32], sec32[32];
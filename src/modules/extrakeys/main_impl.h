@@ -153,6 +153,107 @@ int secp256k1_xonly_pubkey_tweak_add_check(const secp256k1_context* ctx, const u
             && secp256k1_fe_is_odd(&pk.y) == tweaked_pk_parity;
 }
 
+typedef struct {
+    const secp256k1_context *ctx;
+    const unsigned char * const *tweaked_pubkey32;
+    const int *tweaked_pk_parity;
+    const secp256k1_xonly_pubkey * const *internal_pubkey;
+    size_t n;
+    unsigned char seed[32];
+    /* The randomizers of the group of eight checks that starts at randomizer_idx. */
+    secp256k1_scalar randomizer[8];
+    size_t randomizer_idx;
+} secp256k1_xonly_pubkey_tweak_add_check_batch_data;
+
+/* Provides the points of the batch equation
+ *   (sum a_i*t_i)*G + sum a_i*P_i - sum a_i*Q_i = 0
+ * in the order P_0, Q_0, P_1, Q_1, ... The scalar of G is computed upfront. */
+static int secp256k1_xonly_pubkey_tweak_add_check_batch_ecmult_callback(secp256k1_scalar *sc, secp256k1_ge *pt, size_t idx, void *cbdata) {
+    secp256k1_xonly_pubkey_tweak_add_check_batch_data *data = (secp256k1_xonly_pubkey_tweak_add_check_batch_data *)cbdata;
+    size_t i = idx / 2;
+
+    if (data->randomizer_idx != i - i % 8) {
+        data->randomizer_idx = i - i % 8;
+        secp256k1_batch_randomizers(data->randomizer, data->seed, data->randomizer_idx, data->n);
+    }
+
+    if (idx % 2 == 0) {
+        if (!secp256k1_xonly_pubkey_load(data->ctx, pt, data->internal_pubkey[i])) {
+            return 0;
+        }
+        *sc = data->randomizer[i % 8];
+    } else {
+        secp256k1_fe qx;
+        if (!secp256k1_fe_set_b32_limit(&qx, data->tweaked_pubkey32[i])) {
+            return 0;
+        }
+        if (!secp256k1_ge_set_xo_var(pt, &qx, data->tweaked_pk_parity[i])) {
+            return 0;
+        }
+        secp256k1_scalar_negate(sc, &data->randomizer[i % 8]);
+    }
+    return 1;
+}
+
+int secp256k1_xonly_pubkey_tweak_add_check_batch(const secp256k1_context* ctx, secp256k1_scratch_space *scratch, const unsigned char * const *tweaked_pubkey32, const int *tweaked_pk_parity, const secp256k1_xonly_pubkey * const *internal_pubkey, const unsigned char * const *tweak32, size_t n) {
+    secp256k1_xonly_pubkey_tweak_add_check_batch_data data;
+    secp256k1_sha256 sha;
+    secp256k1_scalar t, g_sc;
+    secp256k1_gej rj;
+    size_t i;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(tweaked_pubkey32 != NULL || n == 0);
+    ARG_CHECK(tweaked_pk_parity != NULL || n == 0);
+    ARG_CHECK(internal_pubkey != NULL || n == 0);
+    ARG_CHECK(tweak32 != NULL || n == 0);
+    /* The ecmult_multi callback addresses 2*n points. */
+    ARG_CHECK(n <= SIZE_MAX / 2);
+
+    /* Commit to all inputs before deriving the randomizers. */
+    secp256k1_batch_sha256_tagged(&sha);
+    for (i = 0; i < n; i++) {
+        unsigned char parity;
+        ARG_CHECK(tweaked_pubkey32[i] != NULL);
+        ARG_CHECK(internal_pubkey[i] != NULL);
+        ARG_CHECK(tweak32[i] != NULL);
+        if (tweaked_pk_parity[i] != 0 && tweaked_pk_parity[i] != 1) {
+            return 0;
+        }
+        parity = tweaked_pk_parity[i];
+        secp256k1_sha256_write(&sha, tweaked_pubkey32[i], 32);
+        secp256k1_sha256_write(&sha, &parity, 1);
+        secp256k1_sha256_write(&sha, internal_pubkey[i]->data, sizeof(internal_pubkey[i]->data));
+        secp256k1_sha256_write(&sha, tweak32[i], 32);
+    }
+    secp256k1_sha256_finalize(&sha, data.seed);
+
+    secp256k1_scalar_clear(&g_sc);
+    for (i = 0; i < n; i++) {
+        int overflow;
+        secp256k1_scalar_set_b32(&t, tweak32[i], &overflow);
+        if (overflow) {
+            return 0;
+        }
+        if (i % 8 == 0) {
+            secp256k1_batch_randomizers(data.randomizer, data.seed, i, n);
+        }
+        secp256k1_scalar_mul(&t, &t, &data.randomizer[i % 8]);
+        secp256k1_scalar_add(&g_sc, &g_sc, &t);
+    }
+
+    data.ctx = ctx;
+    data.tweaked_pubkey32 = tweaked_pubkey32;
+    data.tweaked_pk_parity = tweaked_pk_parity;
+    data.internal_pubkey = internal_pubkey;
+    data.n = n;
+    data.randomizer_idx = SIZE_MAX;
+    if (!secp256k1_ecmult_multi_var(&ctx->error_callback, scratch, &rj, &g_sc, secp256k1_xonly_pubkey_tweak_add_check_batch_ecmult_callback, (void *)&data, 2 * n)) {
+        return 0;
+    }
+    return secp256k1_gej_is_infinity(&rj);
+}
+
 static void secp256k1_keypair_save(secp256k1_keypair *keypair, const secp256k1_scalar *sk, secp256k1_ge *pk) {
     secp256k1_scalar_get_b32(&keypair->data[0], sk);
     secp256k1_pubkey_save((secp256k1_pubkey *)&keypair->data[32], pk);
@@ -245,6 +245,80 @@ static void test_xonly_pubkey_tweak_check(void) {
     CHECK(secp256k1_memcmp_var(&output_pk, zeros64, sizeof(output_pk)) == 0);
 }
 
+/* Checks that tweak_add_check_batch agrees with tweak_add_check on batches of
+ * random sizes containing at most one incorrect entry. */
+#define N_MAX 32
+static void test_xonly_pubkey_tweak_check_batch(void) {
+    unsigned char tweaked_pk32[N_MAX][32];
+    int pk_parity[N_MAX];
+    secp256k1_xonly_pubkey internal_pk[N_MAX];
+    unsigned char tweak[N_MAX][32];
+    const unsigned char *tweaked_pk32_ptr[N_MAX];
+    const secp256k1_xonly_pubkey *internal_pk_ptr[N_MAX];
+    const unsigned char *tweak_ptr[N_MAX];
+    const unsigned char *null_ptr = NULL;
+    secp256k1_scratch_space *scratch;
+    size_t n = 1 + secp256k1_testrand_int(N_MAX);
+    size_t i, bad;
+    int expected;
+
+    for (i = 0; i < n; i++) {
+        unsigned char sk[32];
+        secp256k1_pubkey pk, output_pk;
+        secp256k1_xonly_pubkey output_xonly_pk;
+        secp256k1_testrand256(sk);
+        secp256k1_testrand256(tweak[i]);
+        CHECK(secp256k1_ec_pubkey_create(CTX, &pk, sk) == 1);
+        CHECK(secp256k1_xonly_pubkey_from_pubkey(CTX, &internal_pk[i], NULL, &pk) == 1);
+        CHECK(secp256k1_xonly_pubkey_tweak_add(CTX, &output_pk, &internal_pk[i], tweak[i]) == 1);
+        CHECK(secp256k1_xonly_pubkey_from_pubkey(CTX, &output_xonly_pk, &pk_parity[i], &output_pk) == 1);
+        CHECK(secp256k1_xonly_pubkey_serialize(CTX, tweaked_pk32[i], &output_xonly_pk) == 1);
+        tweaked_pk32_ptr[i] = tweaked_pk32[i];
+        internal_pk_ptr[i] = &internal_pk[i];
+        tweak_ptr[i] = tweak[i];
+    }
+    scratch = secp256k1_scratch_space_create(CTX, secp256k1_testrand_int(1 << 16));
+
+    CHECK(secp256k1_xonly_pubkey_tweak_add_check_batch(CTX, scratch, NULL, NULL, NULL, NULL, 0) == 1);
+    CHECK_ILLEGAL(CTX, secp256k1_xonly_pubkey_tweak_add_check_batch(CTX, scratch, NULL, pk_parity, internal_pk_ptr, tweak_ptr, n));
+    CHECK_ILLEGAL(CTX, secp256k1_xonly_pubkey_tweak_add_check_batch(CTX, scratch, tweaked_pk32_ptr, NULL, internal_pk_ptr, tweak_ptr, n));
+    CHECK_ILLEGAL(CTX, secp256k1_xonly_pubkey_tweak_add_check_batch(CTX, scratch, tweaked_pk32_ptr, pk_parity, NULL, tweak_ptr, n));
+    CHECK_ILLEGAL(CTX, secp256k1_xonly_pubkey_tweak_add_check_batch(CTX, scratch, tweaked_pk32_ptr, pk_parity, internal_pk_ptr, NULL, n));
+    CHECK_ILLEGAL(CTX, secp256k1_xonly_pubkey_tweak_add_check_batch(CTX, scratch, &null_ptr, pk_parity, internal_pk_ptr, tweak_ptr, 1));
+    CHECK_ILLEGAL(CTX, secp256k1_xonly_pubkey_tweak_add_check_batch(CTX, scratch, tweaked_pk32_ptr, pk_parity, internal_pk_ptr, &null_ptr, 1));
+
+    bad = secp256k1_testrand_int(n);
+    expected = 0;
+    switch (secp256k1_testrand_int(6)) {
+        case 0:
+            /* Wrong pk_parity */
+            pk_parity[bad] = !pk_parity[bad];
+            break;
+        case 1:
+            /* Invalid pk_parity value */
+            pk_parity[bad] = 2;
+            break;
+        case 2:
+            /* Wrong tweak, including overflowing ones */
+            tweak[bad][secp256k1_testrand_int(32)] ^= 1 + secp256k1_testrand_int(255);
+            break;
+        case 3:
+            /* Wrong tweaked pubkey */
+            tweaked_pk32[bad][secp256k1_testrand_int(32)] ^= 1 + secp256k1_testrand_int(255);
+            break;
+        default:
+            expected = 1;
+    }
+    CHECK(secp256k1_xonly_pubkey_tweak_add_check_batch(CTX, scratch, tweaked_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, n) == expected);
+    CHECK(secp256k1_xonly_pubkey_tweak_add_check_batch(CTX, NULL, tweaked_pk32_ptr, pk_parity, internal_pk_ptr, tweak_ptr, n) == expected);
+    for (i = 0; i < n; i++) {
+        CHECK(secp256k1_xonly_pubkey_tweak_add_check(CTX, tweaked_pk32[i], pk_parity[i], &internal_pk[i], tweak[i]) == (expected || i != bad));
+    }
+
+    secp256k1_scratch_space_destroy(CTX, scratch);
+}
+#undef N_MAX
+
 /* Starts with an initial pubkey and recursively creates N_PUBKEYS - 1
  * additional pubkeys by calling tweak_add. Then verifies every tweak starting
  * from the last pubkey. */
@@ -468,10 +542,15 @@ static void test_keypair_add(void) {
 }
 
 static void run_extrakeys_tests(void) {
+    int i;
+
     /* xonly key test cases */
     test_xonly_pubkey();
     test_xonly_pubkey_tweak();
     test_xonly_pubkey_tweak_check();
+    for (i = 0; i < COUNT; i++) {
+        test_xonly_pubkey_tweak_check_batch();
+    }
     test_xonly_pubkey_tweak_recursive();
     test_xonly_pubkey_comparison();
 
@@ -10,6 +10,7 @@
 #include "../../../include/secp256k1_schnorrsig.h"
 
 #define MSGLEN 32
+#define BENCH_SCHNORRSIG_SCRATCH_SIZE (32 << 20)
 
 typedef struct {
     secp256k1_context *ctx;
@@ -19,6 +20,11 @@ typedef struct {
     const unsigned char **pk;
     const unsigned char **sigs;
     const unsigned char **msgs;
+    size_t *msglens;
+    const secp256k1_xonly_pubkey **xonly_pks;
+    secp256k1_scratch_space *scratch;
+    size_t batch_size;
+    secp256k1_pubkey_prepared *prepared;
 } bench_schnorrsig_data;
 
 static void bench_schnorrsig_sign(void* arg, int iters) {
@@ -45,6 +51,25 @@ static void bench_schnorrsig_verify(void* arg, int iters) {
     }
 }
 
+static void bench_schnorrsig_verify_prepared(void* arg, int iters) {
+    bench_schnorrsig_data *data = (bench_schnorrsig_data *)arg;
+    int i;
+
+    for (i = 0; i < iters; i++) {
+        CHECK(secp256k1_schnorrsig_verify_prepared(data->ctx, data->sigs[0], data->msgs[0], MSGLEN, data->prepared));
+    }
+}
+
+static void bench_schnorrsig_verify_batch(void* arg, int iters) {
+    bench_schnorrsig_data *data = (bench_schnorrsig_data *)arg;
+    size_t i;
+
+    for (i = 0; i < (size_t)iters; i += data->batch_size) {
+        size_t n = (size_t)iters - i < data->batch_size ? (size_t)iters - i : data->batch_size;
+        CHECK(secp256k1_schnorrsig_verify_batch(data->ctx, data->scratch, &data->sigs[i], &data->msgs[i], &data->msglens[i], &data->xonly_pks[i], n));
+    }
+}
+
 static void run_schnorrsig_bench(int iters, int argc, char** argv) {
     int i;
     bench_schnorrsig_data data;
@@ -55,6 +80,8 @@ static void run_schnorrsig_bench(int iters, int argc, char** argv) {
     data.pk = (const unsigned char **)malloc(iters * sizeof(unsigned char *));
     data.msgs = (const unsigned char **)malloc(iters * sizeof(unsigned char *));
     data.sigs = (const unsigned char **)malloc(iters * sizeof(unsigned char *));
+    data.msglens = (size_t *)malloc(iters * sizeof(size_t));
+    data.xonly_pks = (const secp256k1_xonly_pubkey **)malloc(iters * sizeof(secp256k1_xonly_pubkey *));
 
     CHECK(MSGLEN >= 4);
     for (i = 0; i < iters; i++) {
@@ -63,7 +90,7 @@ static void run_schnorrsig_bench(int iters, int argc, char** argv) {
         unsigned char *sig = (unsigned char *)malloc(64);
         secp256k1_keypair *keypair = (secp256k1_keypair *)malloc(sizeof(*keypair));
         unsigned char *pk_char = (unsigned char *)malloc(32);
-        secp256k1_xonly_pubkey pk;
+        secp256k1_xonly_pubkey *pk = (secp256k1_xonly_pubkey *)malloc(sizeof(*pk));
         msg[0] = sk[0] = i;
         msg[1] = sk[1] = i >> 8;
         msg[2] = sk[2] = i >> 16;
@@ -75,21 +102,43 @@ static void run_schnorrsig_bench(int iters, int argc, char** argv) {
         data.pk[i] = pk_char;
         data.msgs[i] = msg;
         data.sigs[i] = sig;
+        data.msglens[i] = MSGLEN;
+        data.xonly_pks[i] = pk;
 
         CHECK(secp256k1_keypair_create(data.ctx, keypair, sk));
         CHECK(secp256k1_schnorrsig_sign_custom(data.ctx, sig, msg, MSGLEN, keypair, NULL));
-        CHECK(secp256k1_keypair_xonly_pub(data.ctx, &pk, NULL, keypair));
-        CHECK(secp256k1_xonly_pubkey_serialize(data.ctx, pk_char, &pk) == 1);
+        CHECK(secp256k1_keypair_xonly_pub(data.ctx, pk, NULL, keypair));
+        CHECK(secp256k1_xonly_pubkey_serialize(data.ctx, pk_char, pk) == 1);
     }
 
     if (d || have_flag(argc, argv, "schnorrsig") || have_flag(argc, argv, "sign") || have_flag(argc, argv, "schnorrsig_sign")) run_benchmark("schnorrsig_sign", bench_schnorrsig_sign, NULL, NULL, (void *) &data, 10, iters);
     if (d || have_flag(argc, argv, "schnorrsig") || have_flag(argc, argv, "verify") || have_flag(argc, argv, "schnorrsig_verify")) run_benchmark("schnorrsig_verify", bench_schnorrsig_verify, NULL, NULL, (void *) &data, 10, iters);
+    if (d || have_flag(argc, argv, "schnorrsig") || have_flag(argc, argv, "verify") || have_flag(argc, argv, "schnorrsig_verify_prepared")) {
+        /* Verifies the same signature repeatedly. */
+        secp256k1_pubkey pubkey;
+        CHECK(secp256k1_keypair_pub(data.ctx, &pubkey, data.keypairs[0]));
+        data.prepared = secp256k1_pubkey_prepared_create(data.ctx, &pubkey);
+        CHECK(data.prepared != NULL);
+        run_benchmark("schnorrsig_verify_prepared", bench_schnorrsig_verify_prepared, NULL, NULL, (void *) &data, 10, iters);
+        secp256k1_pubkey_prepared_destroy(data.ctx, data.prepared);
+    }
+    if (d || have_flag(argc, argv, "schnorrsig") || have_flag(argc, argv, "schnorrsig_verify_batch")) {
+        /* Reports the time per signature for increasing batch sizes. */
+        data.scratch = secp256k1_scratch_space_create(data.ctx, BENCH_SCHNORRSIG_SCRATCH_SIZE);
+        for (data.batch_size = 1; data.batch_size <= (size_t)iters; data.batch_size *= 2) {
+            char name[64];
+            sprintf(name, "schnorrsig_verify_batch_%d", (int)data.batch_size);
+            run_benchmark(name, bench_schnorrsig_verify_batch, NULL, NULL, (void *) &data, 10, iters);
+        }
+        secp256k1_scratch_space_destroy(data.ctx, data.scratch);
+    }
 
     for (i = 0; i < iters; i++) {
         free((void *)data.keypairs[i]);
         free((void *)data.pk[i]);
         free((void *)data.msgs[i]);
         free((void *)data.sigs[i]);
+        free((void *)data.xonly_pks[i]);
     }
 
     /* Casting to (void *) avoids a stupid warning in MSVC. */
@@ -97,6 +146,8 @@ static void run_schnorrsig_bench(int iters, int argc, char** argv) {
     free((void *)data.pk);
     free((void *)data.msgs);
     free((void *)data.sigs);
+    free(data.msglens);
+    free((void *)data.xonly_pks);
 
     secp256k1_context_destroy(data.ctx);
 }
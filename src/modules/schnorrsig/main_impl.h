@@ -129,7 +129,29 @@ static void secp256k1_schnorrsig_challenge(secp256k1_scalar* e, const unsigned c
     secp256k1_scalar_set_b32(e, buf, NULL);
 }
 
-static int secp256k1_schnorrsig_sign_internal(const secp256k1_context* ctx, unsigned char *sig64, const unsigned char *msg, size_t msglen, const secp256k1_keypair *keypair, secp256k1_nonce_function_hardened noncefp, void *ndata) {
+/* Computes the challenges e[k] of eight signatures with messages of equal length
+ * at once, using secp256k1_sha256_x8. */
+static void secp256k1_schnorrsig_challenge_x8(secp256k1_scalar *e, const unsigned char * const *r32, const unsigned char * const *msg, size_t msglen, const unsigned char * const *pubkey32)
+{
+    unsigned char buf[8 * 32];
+    secp256k1_sha256 sha;
+    secp256k1_sha256_x8 sha_x8;
+    int k;
+
+    secp256k1_schnorrsig_sha256_tagged(&sha);
+    secp256k1_sha256_x8_initialize(&sha_x8, &sha);
+    secp256k1_sha256_x8_write(&sha_x8, r32, 32);
+    secp256k1_sha256_x8_write(&sha_x8, pubkey32, 32);
+    secp256k1_sha256_x8_write(&sha_x8, msg, msglen);
+    secp256k1_sha256_x8_finalize(&sha_x8, buf);
+    for (k = 0; k < 8; k++) {
+        secp256k1_scalar_set_b32(&e[k], &buf[32 * k], NULL);
+    }
+}
+
+/* Sign with a nonce from the pool if it is not NULL, and otherwise with the
+ * nonce from noncefp. */
+static int secp256k1_schnorrsig_sign_internal(const secp256k1_context* ctx, unsigned char *sig64, const unsigned char *msg, size_t msglen, const secp256k1_keypair *keypair, const secp256k1_signer *signer, secp256k1_nonce_function_hardened noncefp, void *ndata, secp256k1_sign_pool *pool) {
     secp256k1_scalar sk;
     secp256k1_scalar e;
     secp256k1_scalar k;
@@ -142,32 +164,46 @@ static int secp256k1_schnorrsig_sign_internal(const secp256k1_context* ctx, unsi
     int ret = 1;
 
     VERIFY_CHECK(ctx != NULL);
-    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(pool != NULL || secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
     ARG_CHECK(sig64 != NULL);
     ARG_CHECK(msg != NULL || msglen == 0);
-    ARG_CHECK(keypair != NULL);
+    ARG_CHECK(keypair != NULL || signer != NULL);
 
     if (noncefp == NULL) {
         noncefp = secp256k1_nonce_function_bip340;
     }
 
-    ret &= secp256k1_keypair_load(ctx, &sk, &pk, keypair);
-    /* Because we are signing for a x-only pubkey, the secret key is negated
-     * before signing if the point corresponding to the secret key does not
-     * have an even Y. */
-    if (secp256k1_fe_is_odd(&pk.y)) {
-        secp256k1_scalar_negate(&sk, &sk);
-    }
+    if (signer != NULL) {
+        sk = signer->sk_even;
+        memcpy(seckey, signer->seckey_even, sizeof(seckey));
+        memcpy(pk_buf, signer->xonly_pk, sizeof(pk_buf));
+    } else {
+        ret &= secp256k1_keypair_load(ctx, &sk, &pk, keypair);
+        /* Because we are signing for a x-only pubkey, the secret key is negated
+         * before signing if the point corresponding to the secret key does not
+         * have an even Y. */
+        if (secp256k1_fe_is_odd(&pk.y)) {
+            secp256k1_scalar_negate(&sk, &sk);
+        }
 
-    secp256k1_scalar_get_b32(seckey, &sk);
-    secp256k1_fe_get_b32(pk_buf, &pk.x);
-    ret &= !!noncefp(buf, msg, msglen, seckey, pk_buf, bip340_algo, sizeof(bip340_algo), ndata);
-    secp256k1_scalar_set_b32(&k, buf, NULL);
-    ret &= !secp256k1_scalar_is_zero(&k);
-    secp256k1_scalar_cmov(&k, &secp256k1_scalar_one, !ret);
+        secp256k1_fe_get_b32(pk_buf, &pk.x);
+        secp256k1_scalar_get_b32(seckey, &sk);
+    }
+    if (pool != NULL) {
+        if (!secp256k1_sign_pool_take(pool, &k, &r)) {
+            ret = 0;
+            secp256k1_scalar_set_int(&k, 1);
+            r = secp256k1_ge_const_g;
+        }
+    } else {
+        ret &= !!noncefp(buf, msg, msglen, seckey, pk_buf, bip340_algo, sizeof(bip340_algo), ndata);
+        secp256k1_scalar_set_b32(&k, buf, NULL);
+        ret &= !secp256k1_scalar_is_zero(&k);
+        secp256k1_scalar_cmov(&k, &secp256k1_scalar_one, !ret);
 
-    secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &rj, &k);
-    secp256k1_ge_set_gej(&r, &rj);
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &rj, &k);
+        secp256k1_ge_set_gej(&r, &rj);
+    }
 
     /* We declassify r to allow using it as a branch point. This is fine
      * because r is not a secret. */
@@ -194,7 +230,7 @@ static int secp256k1_schnorrsig_sign_internal(const secp256k1_context* ctx, unsi
 
 int secp256k1_schnorrsig_sign32(const secp256k1_context* ctx, unsigned char *sig64, const unsigned char *msg32, const secp256k1_keypair *keypair, const unsigned char *aux_rand32) {
     /* We cast away const from the passed aux_rand32 argument since we know the default nonce function does not modify it. */
-    return secp256k1_schnorrsig_sign_internal(ctx, sig64, msg32, 32, keypair, secp256k1_nonce_function_bip340, (unsigned char*)aux_rand32);
+    return secp256k1_schnorrsig_sign_internal(ctx, sig64, msg32, 32, keypair, NULL, secp256k1_nonce_function_bip340, (unsigned char*)aux_rand32, NULL);
 }
 
 int secp256k1_schnorrsig_sign(const secp256k1_context* ctx, unsigned char *sig64, const unsigned char *msg32, const secp256k1_keypair *keypair, const unsigned char *aux_rand32) {
@@ -213,7 +249,33 @@ int secp256k1_schnorrsig_sign_custom(const secp256k1_context* ctx, unsigned char
         noncefp = extraparams->noncefp;
         ndata = extraparams->ndata;
     }
-    return secp256k1_schnorrsig_sign_internal(ctx, sig64, msg, msglen, keypair, noncefp, ndata);
+    return secp256k1_schnorrsig_sign_internal(ctx, sig64, msg, msglen, keypair, NULL, noncefp, ndata, NULL);
+}
+
+int secp256k1_schnorrsig_sign_pool(const secp256k1_context* ctx, unsigned char *sig64, const unsigned char *msg, size_t msglen, const secp256k1_keypair *keypair, secp256k1_sign_pool *pool) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pool != NULL);
+    return secp256k1_schnorrsig_sign_internal(ctx, sig64, msg, msglen, keypair, NULL, NULL, NULL, pool);
+}
+
+int secp256k1_schnorrsig_sign_signer(const secp256k1_context* ctx, unsigned char *sig64, const unsigned char *msg, size_t msglen, const secp256k1_signer *signer, const unsigned char *aux_rand32) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(signer != NULL);
+    return secp256k1_schnorrsig_sign_internal(ctx, sig64, msg, msglen, NULL, signer, secp256k1_nonce_function_bip340, (unsigned char*)aux_rand32, NULL);
+}
+
+/* Checks whether rj is a point with even y coordinate and x coordinate rx. */
+static int secp256k1_schnorrsig_check_r(const secp256k1_fe *rx, secp256k1_gej *rj) {
+    secp256k1_ge r;
+
+    secp256k1_ge_set_gej_var(&r, rj);
+    if (secp256k1_ge_is_infinity(&r)) {
+        return 0;
+    }
+
+    secp256k1_fe_normalize_var(&r.y);
+    return !secp256k1_fe_is_odd(&r.y) &&
+           secp256k1_fe_equal(rx, &r.x);
 }
 
 int secp256k1_schnorrsig_verify(const secp256k1_context* ctx, const unsigned char *sig64, const unsigned char *msg, size_t msglen, const secp256k1_xonly_pubkey *pubkey) {
@@ -223,7 +285,6 @@ int secp256k1_schnorrsig_verify(const secp256k1_context* ctx, const unsigned cha
     secp256k1_ge pk;
     secp256k1_gej pkj;
     secp256k1_fe rx;
-    secp256k1_ge r;
     unsigned char buf[32];
     int overflow;
 
@@ -252,16 +313,203 @@ int secp256k1_schnorrsig_verify(const secp256k1_context* ctx, const unsigned cha
     /* Compute rj =  s*G + (-e)*pkj */
     secp256k1_scalar_negate(&e, &e);
     secp256k1_gej_set_ge(&pkj, &pk);
-    secp256k1_ecmult(&rj, &pkj, &e, &s);
+    secp256k1_ecmult_tables(&ctx->ecmult_g, &rj, &pkj, &e, &s);
 
-    secp256k1_ge_set_gej_var(&r, &rj);
-    if (secp256k1_ge_is_infinity(&r)) {
+    return secp256k1_schnorrsig_check_r(&rx, &rj);
+}
+
+int secp256k1_schnorrsig_verify_prepared(const secp256k1_context* ctx, const unsigned char *sig64, const unsigned char *msg, size_t msglen, const secp256k1_pubkey_prepared *pubkey) {
+    secp256k1_scalar s;
+    secp256k1_scalar e;
+    secp256k1_gej rj;
+    secp256k1_ge pk;
+    secp256k1_fe rx;
+    unsigned char buf[32];
+    int overflow;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(sig64 != NULL);
+    ARG_CHECK(msg != NULL || msglen == 0);
+    ARG_CHECK(pubkey != NULL);
+
+    if (!secp256k1_fe_set_b32_limit(&rx, &sig64[0])) {
         return 0;
     }
 
-    secp256k1_fe_normalize_var(&r.y);
-    return !secp256k1_fe_is_odd(&r.y) &&
-           secp256k1_fe_equal(&rx, &r.x);
+    secp256k1_scalar_set_b32(&s, &sig64[32], &overflow);
+    if (overflow) {
+        return 0;
+    }
+
+    /* The key was validated when it was prepared. */
+    secp256k1_pubkey_load(ctx, &pk, &pubkey->pubkey);
+
+    /* Compute e. */
+    secp256k1_fe_get_b32(buf, &pk.x);
+    secp256k1_schnorrsig_challenge(&e, &sig64[0], msg, msglen, buf);
+
+    /* Compute rj = s*G + (-e)*pkj, where pkj is the prepared point with its y
+     * coordinate made even. */
+    if (!secp256k1_fe_is_odd(&pk.y)) {
+        secp256k1_scalar_negate(&e, &e);
+    }
+    secp256k1_ecmult_prepared(&ctx->ecmult_g, &rj, &pubkey->table, &e, &s);
+
+    return secp256k1_schnorrsig_check_r(&rx, &rj);
+}
+
+typedef struct {
+    const secp256k1_context *ctx;
+    const unsigned char * const *sig64;
+    const unsigned char * const *msg;
+    const size_t *msglen;
+    const secp256k1_xonly_pubkey * const *pubkey;
+    size_t n_sigs;
+    unsigned char seed[32];
+    /* The randomizers of the group of eight signatures that starts at randomizer_idx. */
+    size_t randomizer_idx;
+    secp256k1_scalar randomizer[8];
+    /* The challenges of the group of eight signatures that starts at
+     * challenge_idx, if challenge_x8 is set. */
+    size_t challenge_idx;
+    int challenge_x8;
+    secp256k1_scalar challenge[8];
+} secp256k1_schnorrsig_verify_batch_data;
+
+/* Sets e to the challenge of signature i, whose public key has the serialized x
+ * coordinate pk32. The challenges of groups of eight signatures with messages
+ * of equal length are computed together. */
+static void secp256k1_schnorrsig_verify_batch_challenge(secp256k1_scalar *e, secp256k1_schnorrsig_verify_batch_data *data, size_t i, const unsigned char *pk32) {
+    size_t base = i - i % 8;
+
+    if (data->challenge_idx != base) {
+        data->challenge_idx = base;
+        data->challenge_x8 = base + 8 <= data->n_sigs;
+        if (data->challenge_x8) {
+            const unsigned char *r32[8];
+            const unsigned char *pubkey32[8];
+            unsigned char buf[8][32];
+            secp256k1_ge_storage pk_storage;
+            secp256k1_ge pk;
+            int k;
+            for (k = 0; k < 8 && data->challenge_x8; k++) {
+                /* Load the public keys without secp256k1_xonly_pubkey_load, which
+                 * would call the illegal callback for invalid public keys. Those
+                 * are left to the caller, which fails on them. */
+                memcpy(&pk_storage, data->pubkey[base + k]->data, sizeof(pk_storage));
+                secp256k1_ge_from_storage(&pk, &pk_storage);
+                data->challenge_x8 = data->msglen[base + k] == data->msglen[base] && !secp256k1_fe_is_zero(&pk.x);
+                if (data->challenge_x8) {
+                    secp256k1_fe_get_b32(buf[k], &pk.x);
+                    r32[k] = &data->sig64[base + k][0];
+                    pubkey32[k] = buf[k];
+                }
+            }
+            if (data->challenge_x8) {
+                secp256k1_schnorrsig_challenge_x8(data->challenge, r32, &data->msg[base], data->msglen[base], pubkey32);
+            }
+        }
+    }
+    if (data->challenge_x8) {
+        *e = data->challenge[i % 8];
+    } else {
+        secp256k1_schnorrsig_challenge(e, &data->sig64[i][0], data->msg[i], data->msglen[i], pk32);
+    }
+}
+
+/* Provides the points of the batch equation
+ *   (sum a_i*s_i)*G - sum a_i*R_i - sum (a_i*e_i)*P_i = 0
+ * in the order R_0, P_0, R_1, P_1, ... The scalar of G is computed upfront. */
+static int secp256k1_schnorrsig_verify_batch_ecmult_callback(secp256k1_scalar *sc, secp256k1_ge *pt, size_t idx, void *cbdata) {
+    secp256k1_schnorrsig_verify_batch_data *data = (secp256k1_schnorrsig_verify_batch_data *)cbdata;
+    size_t i = idx / 2;
+
+    if (data->randomizer_idx != i - i % 8) {
+        data->randomizer_idx = i - i % 8;
+        secp256k1_batch_randomizers(data->randomizer, data->seed, data->randomizer_idx, data->n_sigs);
+    }
+
+    if (idx % 2 == 0) {
+        secp256k1_fe rx;
+        if (!secp256k1_fe_set_b32_limit(&rx, &data->sig64[i][0])) {
+            return 0;
+        }
+        if (!secp256k1_ge_set_xo_var(pt, &rx, 0)) {
+            return 0;
+        }
+        secp256k1_scalar_negate(sc, &data->randomizer[i % 8]);
+    } else {
+        secp256k1_scalar e;
+        unsigned char buf[32];
+        if (!secp256k1_xonly_pubkey_load(data->ctx, pt, data->pubkey[i])) {
+            return 0;
+        }
+        secp256k1_fe_get_b32(buf, &pt->x);
+        secp256k1_schnorrsig_verify_batch_challenge(&e, data, i, buf);
+        secp256k1_scalar_mul(sc, &e, &data->randomizer[i % 8]);
+        secp256k1_scalar_negate(sc, sc);
+    }
+    return 1;
+}
+
+int secp256k1_schnorrsig_verify_batch(const secp256k1_context* ctx, secp256k1_scratch_space *scratch, const unsigned char * const *sig64, const unsigned char * const *msg, const size_t *msglen, const secp256k1_xonly_pubkey * const *pubkey, size_t n_sigs) {
+    secp256k1_schnorrsig_verify_batch_data data;
+    secp256k1_sha256 sha;
+    secp256k1_scalar s, g_sc;
+    secp256k1_gej rj;
+    size_t i;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(sig64 != NULL || n_sigs == 0);
+    ARG_CHECK(msg != NULL || n_sigs == 0);
+    ARG_CHECK(msglen != NULL || n_sigs == 0);
+    ARG_CHECK(pubkey != NULL || n_sigs == 0);
+    /* The ecmult_multi callback addresses 2*n_sigs points. */
+    ARG_CHECK(n_sigs <= SIZE_MAX / 2);
+
+    /* Commit to all inputs before deriving the randomizers. */
+    secp256k1_batch_sha256_tagged(&sha);
+    for (i = 0; i < n_sigs; i++) {
+        unsigned char len[8];
+        ARG_CHECK(sig64[i] != NULL);
+        ARG_CHECK(msg[i] != NULL || msglen[i] == 0);
+        ARG_CHECK(pubkey[i] != NULL);
+        secp256k1_write_be64(len, (uint64_t)msglen[i]);
+        secp256k1_sha256_write(&sha, sig64[i], 64);
+        secp256k1_sha256_write(&sha, pubkey[i]->data, sizeof(pubkey[i]->data));
+        secp256k1_sha256_write(&sha, len, sizeof(len));
+        if (msglen[i] > 0) {
+            secp256k1_sha256_write(&sha, msg[i], msglen[i]);
+        }
+    }
+    secp256k1_sha256_finalize(&sha, data.seed);
+
+    secp256k1_scalar_clear(&g_sc);
+    for (i = 0; i < n_sigs; i++) {
+        int overflow;
+        secp256k1_scalar_set_b32(&s, &sig64[i][32], &overflow);
+        if (overflow) {
+            return 0;
+        }
+        if (i % 8 == 0) {
+            secp256k1_batch_randomizers(data.randomizer, data.seed, i, n_sigs);
+        }
+        secp256k1_scalar_mul(&s, &s, &data.randomizer[i % 8]);
+        secp256k1_scalar_add(&g_sc, &g_sc, &s);
+    }
+
+    data.ctx = ctx;
+    data.sig64 = sig64;
+    data.msg = msg;
+    data.msglen = msglen;
+    data.pubkey = pubkey;
+    data.n_sigs = n_sigs;
+    data.randomizer_idx = SIZE_MAX;
+    data.challenge_idx = SIZE_MAX;
+    if (!secp256k1_ecmult_multi_var(&ctx->error_callback, scratch, &rj, &g_sc, secp256k1_schnorrsig_verify_batch_ecmult_callback, (void *)&data, 2 * n_sigs)) {
+        return 0;
+    }
+    return secp256k1_gej_is_infinity(&rj);
 }
 
 #endif
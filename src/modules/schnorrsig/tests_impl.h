@@ -153,6 +153,46 @@ static void test_schnorrsig_api(void) {
     CHECK(secp256k1_schnorrsig_verify(CTX, sig, NULL, 0, &pk[0]) == 0);
     CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify(CTX, sig, msg, sizeof(msg), NULL));
     CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify(CTX, sig, msg, sizeof(msg), &zero_pk));
+
+    {
+        secp256k1_pubkey full_pk;
+        secp256k1_pubkey_prepared *prepared;
+        CHECK(secp256k1_keypair_pub(CTX, &full_pk, &keypairs[0]) == 1);
+        prepared = secp256k1_pubkey_prepared_create(CTX, &full_pk);
+        CHECK(prepared != NULL);
+        CHECK(secp256k1_schnorrsig_verify_prepared(CTX, sig, msg, sizeof(msg), prepared) == 1);
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_prepared(CTX, NULL, msg, sizeof(msg), prepared));
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_prepared(CTX, sig, NULL, sizeof(msg), prepared));
+        CHECK(secp256k1_schnorrsig_verify_prepared(CTX, sig, NULL, 0, prepared) == 0);
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_prepared(CTX, sig, msg, sizeof(msg), NULL));
+        secp256k1_pubkey_prepared_destroy(CTX, prepared);
+    }
+
+    {
+        const unsigned char *sigptr = sig;
+        const unsigned char *msgptr = msg;
+        const unsigned char *null_ptr = NULL;
+        const size_t msglen = sizeof(msg);
+        const size_t zerolen = 0;
+        const secp256k1_xonly_pubkey *pkptr = &pk[0];
+        const secp256k1_xonly_pubkey *zero_pkptr = &zero_pk;
+        const secp256k1_xonly_pubkey *null_pkptr = NULL;
+        secp256k1_scratch_space *scratch = secp256k1_scratch_space_create(CTX, 4096);
+
+        CHECK(secp256k1_schnorrsig_verify_batch(CTX, scratch, &sigptr, &msgptr, &msglen, &pkptr, 1) == 1);
+        CHECK(secp256k1_schnorrsig_verify_batch(CTX, NULL, &sigptr, &msgptr, &msglen, &pkptr, 1) == 1);
+        CHECK(secp256k1_schnorrsig_verify_batch(CTX, scratch, NULL, NULL, NULL, NULL, 0) == 1);
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_batch(CTX, scratch, NULL, &msgptr, &msglen, &pkptr, 1));
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_batch(CTX, scratch, &sigptr, NULL, &msglen, &pkptr, 1));
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_batch(CTX, scratch, &sigptr, &msgptr, NULL, &pkptr, 1));
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_batch(CTX, scratch, &sigptr, &msgptr, &msglen, NULL, 1));
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_batch(CTX, scratch, &null_ptr, &msgptr, &msglen, &pkptr, 1));
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_batch(CTX, scratch, &sigptr, &null_ptr, &msglen, &pkptr, 1));
+        CHECK(secp256k1_schnorrsig_verify_batch(CTX, scratch, &sigptr, &null_ptr, &zerolen, &pkptr, 1) == 0);
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_batch(CTX, scratch, &sigptr, &msgptr, &msglen, &null_pkptr, 1));
+        CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_verify_batch(CTX, scratch, &sigptr, &msgptr, &msglen, &zero_pkptr, 1));
+        secp256k1_scratch_space_destroy(CTX, scratch);
+    }
 }
 
 /* Checks that hash initialized by secp256k1_schnorrsig_sha256_tagged has the
@@ -848,51 +888,158 @@ static void test_schnorrsig_sign(void) {
     CHECK(secp256k1_memcmp_var(sig, sig2, sizeof(sig)) == 0);
 }
 
+static int nonce_function_ndata(unsigned char *nonce32, const unsigned char *msg, size_t msglen, const unsigned char *key32, const unsigned char *xonly_pk32, const unsigned char *algo, size_t algolen, void *data) {
+    (void)msg;
+    (void)msglen;
+    (void)key32;
+    (void)xonly_pk32;
+    (void)algo;
+    (void)algolen;
+    memcpy(nonce32, data, 32);
+    return 1;
+}
+
+static void test_schnorrsig_sign_pool(void) {
+    unsigned char sk[32], seed[32], nonce[32];
+    secp256k1_xonly_pubkey pk;
+    secp256k1_keypair keypair;
+    const unsigned char msg[32] = "this is a msg for a schnorrsig..";
+    unsigned char sig[64];
+    unsigned char sig2[64];
+    unsigned char zeros64[64] = { 0 };
+    secp256k1_schnorrsig_extraparams extraparams = SECP256K1_SCHNORRSIG_EXTRAPARAMS_INIT;
+    secp256k1_sign_pool *pool = secp256k1_sign_pool_create(CTX, 2);
+
+    CHECK(pool != NULL);
+    secp256k1_testrand256(sk);
+    secp256k1_testrand256(seed);
+    CHECK(secp256k1_keypair_create(CTX, &keypair, sk));
+    CHECK(secp256k1_keypair_xonly_pub(CTX, &pk, NULL, &keypair));
+    CHECK(secp256k1_sign_pool_fill(CTX, pool, seed) == 1);
+    CHECK(secp256k1_schnorrsig_sign_pool(CTX, sig, msg, sizeof(msg), &keypair, pool) == 1);
+    CHECK(secp256k1_schnorrsig_verify(CTX, sig, msg, sizeof(msg), &pk));
+    CHECK(secp256k1_schnorrsig_sign_pool(CTX, sig2, msg, sizeof(msg), &keypair, pool) == 1);
+    CHECK(secp256k1_schnorrsig_verify(CTX, sig2, msg, sizeof(msg), &pk));
+    CHECK(secp256k1_memcmp_var(sig, sig2, sizeof(sig)) != 0);
+    CHECK(secp256k1_schnorrsig_sign_pool(CTX, sig, msg, sizeof(msg), &keypair, pool) == 0);
+    CHECK(secp256k1_memcmp_var(sig, zeros64, sizeof(sig)) == 0);
+
+    /* An external nonce gives the same signature as a nonce function that
+     * returns it. */
+    random_scalar_order_b32(nonce);
+    CHECK(secp256k1_sign_pool_add_nonce(CTX, pool, nonce) == 1);
+    CHECK(secp256k1_schnorrsig_sign_pool(STATIC_CTX, sig, NULL, 0, &keypair, pool) == 1);
+    extraparams.noncefp = nonce_function_ndata;
+    extraparams.ndata = nonce;
+    CHECK(secp256k1_schnorrsig_sign_custom(CTX, sig2, NULL, 0, &keypair, &extraparams) == 1);
+    CHECK(secp256k1_memcmp_var(sig, sig2, sizeof(sig)) == 0);
+
+    CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_sign_pool(CTX, sig, msg, sizeof(msg), &keypair, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_sign_pool(CTX, sig, NULL, 1, &keypair, pool));
+    secp256k1_sign_pool_destroy(CTX, pool);
+}
+
+static void test_schnorrsig_sign_signer(void) {
+    unsigned char sk[32], aux_rand[32];
+    secp256k1_keypair keypair;
+    secp256k1_signer *signer;
+    unsigned char msg[40];
+    unsigned char sig[64];
+    unsigned char sig2[64];
+    secp256k1_schnorrsig_extraparams extraparams = SECP256K1_SCHNORRSIG_EXTRAPARAMS_INIT;
+
+    /* The key is random, so across runs both parities of its Y coordinate are covered. */
+    random_scalar_order_b32(sk);
+    CHECK(secp256k1_keypair_create(CTX, &keypair, sk));
+    signer = secp256k1_signer_create(CTX, sk);
+    CHECK(signer != NULL);
+    secp256k1_testrand256(aux_rand);
+    secp256k1_testrand_bytes_test(msg, sizeof(msg));
+    CHECK(secp256k1_schnorrsig_sign_signer(CTX, sig, msg, 32, signer, aux_rand) == 1);
+    CHECK(secp256k1_schnorrsig_sign32(CTX, sig2, msg, &keypair, aux_rand) == 1);
+    CHECK(secp256k1_memcmp_var(sig, sig2, sizeof(sig)) == 0);
+    CHECK(secp256k1_schnorrsig_sign_signer(CTX, sig, msg, sizeof(msg), signer, NULL) == 1);
+    CHECK(secp256k1_schnorrsig_sign_custom(CTX, sig2, msg, sizeof(msg), &keypair, &extraparams) == 1);
+    CHECK(secp256k1_memcmp_var(sig, sig2, sizeof(sig)) == 0);
+    CHECK(secp256k1_schnorrsig_sign_signer(CTX, sig, NULL, 0, signer, aux_rand) == 1);
+    extraparams.ndata = aux_rand;
+    CHECK(secp256k1_schnorrsig_sign_custom(CTX, sig2, NULL, 0, &keypair, &extraparams) == 1);
+    CHECK(secp256k1_memcmp_var(sig, sig2, sizeof(sig)) == 0);
+
+    CHECK_ILLEGAL(STATIC_CTX, secp256k1_schnorrsig_sign_signer(STATIC_CTX, sig, msg, 32, signer, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_sign_signer(CTX, sig, msg, 32, NULL, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_schnorrsig_sign_signer(CTX, sig, NULL, 1, signer, NULL));
+    secp256k1_signer_destroy(CTX, signer);
+}
+
 #define N_SIGS 3
 /* Creates N_SIGS valid signatures and verifies them with verify and
- * verify_batch (TODO). Then flips some bits and checks that verification now
+ * verify_batch. Then flips some bits and checks that verification now
  * fails. */
 static void test_schnorrsig_sign_verify(void) {
     unsigned char sk[32];
     unsigned char msg[N_SIGS][32];
     unsigned char sig[N_SIGS][64];
+    const unsigned char *sig_ptr[N_SIGS];
+    const unsigned char *msg_ptr[N_SIGS];
+    size_t msglen_arr[N_SIGS];
+    const secp256k1_xonly_pubkey *pk_ptr[N_SIGS];
     size_t i;
     secp256k1_keypair keypair;
     secp256k1_xonly_pubkey pk;
+    secp256k1_pubkey full_pk;
+    secp256k1_pubkey_prepared *prepared;
     secp256k1_scalar s;
 
     secp256k1_testrand256(sk);
     CHECK(secp256k1_keypair_create(CTX, &keypair, sk));
     CHECK(secp256k1_keypair_xonly_pub(CTX, &pk, NULL, &keypair));
+    /* The full public key has an odd y coordinate about half of the time. */
+    CHECK(secp256k1_keypair_pub(CTX, &full_pk, &keypair));
+    prepared = secp256k1_pubkey_prepared_create(CTX, &full_pk);
+    CHECK(prepared != NULL);
 
     for (i = 0; i < N_SIGS; i++) {
         secp256k1_testrand256(msg[i]);
         CHECK(secp256k1_schnorrsig_sign32(CTX, sig[i], msg[i], &keypair, NULL));
         CHECK(secp256k1_schnorrsig_verify(CTX, sig[i], msg[i], sizeof(msg[i]), &pk));
+        CHECK(secp256k1_schnorrsig_verify_prepared(CTX, sig[i], msg[i], sizeof(msg[i]), prepared));
+        sig_ptr[i] = sig[i];
+        msg_ptr[i] = msg[i];
+        msglen_arr[i] = sizeof(msg[i]);
+        pk_ptr[i] = &pk;
     }
+    CHECK(secp256k1_schnorrsig_verify_batch(CTX, NULL, sig_ptr, msg_ptr, msglen_arr, pk_ptr, N_SIGS));
 
     {
         /* Flip a few bits in the signature and in the message and check that
-         * verify and verify_batch (TODO) fail */
+         * verify, verify_prepared and verify_batch fail */
         size_t sig_idx = secp256k1_testrand_int(N_SIGS);
         size_t byte_idx = secp256k1_testrand_bits(5);
         unsigned char xorbyte = secp256k1_testrand_int(254)+1;
         sig[sig_idx][byte_idx] ^= xorbyte;
         CHECK(!secp256k1_schnorrsig_verify(CTX, sig[sig_idx], msg[sig_idx], sizeof(msg[sig_idx]), &pk));
+        CHECK(!secp256k1_schnorrsig_verify_prepared(CTX, sig[sig_idx], msg[sig_idx], sizeof(msg[sig_idx]), prepared));
+        CHECK(!secp256k1_schnorrsig_verify_batch(CTX, NULL, sig_ptr, msg_ptr, msglen_arr, pk_ptr, N_SIGS));
         sig[sig_idx][byte_idx] ^= xorbyte;
 
         byte_idx = secp256k1_testrand_bits(5);
         sig[sig_idx][32+byte_idx] ^= xorbyte;
         CHECK(!secp256k1_schnorrsig_verify(CTX, sig[sig_idx], msg[sig_idx], sizeof(msg[sig_idx]), &pk));
+        CHECK(!secp256k1_schnorrsig_verify_prepared(CTX, sig[sig_idx], msg[sig_idx], sizeof(msg[sig_idx]), prepared));
+        CHECK(!secp256k1_schnorrsig_verify_batch(CTX, NULL, sig_ptr, msg_ptr, msglen_arr, pk_ptr, N_SIGS));
         sig[sig_idx][32+byte_idx] ^= xorbyte;
 
         byte_idx = secp256k1_testrand_bits(5);
         msg[sig_idx][byte_idx] ^= xorbyte;
         CHECK(!secp256k1_schnorrsig_verify(CTX, sig[sig_idx], msg[sig_idx], sizeof(msg[sig_idx]), &pk));
+        CHECK(!secp256k1_schnorrsig_verify_prepared(CTX, sig[sig_idx], msg[sig_idx], sizeof(msg[sig_idx]), prepared));
+        CHECK(!secp256k1_schnorrsig_verify_batch(CTX, NULL, sig_ptr, msg_ptr, msglen_arr, pk_ptr, N_SIGS));
         msg[sig_idx][byte_idx] ^= xorbyte;
 
         /* Check that above bitflips have been reversed correctly */
         CHECK(secp256k1_schnorrsig_verify(CTX, sig[sig_idx], msg[sig_idx], sizeof(msg[sig_idx]), &pk));
+        CHECK(secp256k1_schnorrsig_verify_batch(CTX, NULL, sig_ptr, msg_ptr, msglen_arr, pk_ptr, N_SIGS));
     }
 
     /* Test overflowing s */
@@ -900,6 +1047,7 @@ static void test_schnorrsig_sign_verify(void) {
     CHECK(secp256k1_schnorrsig_verify(CTX, sig[0], msg[0], sizeof(msg[0]), &pk));
     memset(&sig[0][32], 0xFF, 32);
     CHECK(!secp256k1_schnorrsig_verify(CTX, sig[0], msg[0], sizeof(msg[0]), &pk));
+    CHECK(!secp256k1_schnorrsig_verify_prepared(CTX, sig[0], msg[0], sizeof(msg[0]), prepared));
 
     /* Test negative s */
     CHECK(secp256k1_schnorrsig_sign32(CTX, sig[0], msg[0], &keypair, NULL));
@@ -908,6 +1056,7 @@ static void test_schnorrsig_sign_verify(void) {
     secp256k1_scalar_negate(&s, &s);
     secp256k1_scalar_get_b32(&sig[0][32], &s);
     CHECK(!secp256k1_schnorrsig_verify(CTX, sig[0], msg[0], sizeof(msg[0]), &pk));
+    CHECK(!secp256k1_schnorrsig_verify_prepared(CTX, sig[0], msg[0], sizeof(msg[0]), prepared));
 
     /* The empty message can be signed & verified */
     CHECK(secp256k1_schnorrsig_sign_custom(CTX, sig[0], NULL, 0, &keypair, NULL) == 1);
@@ -922,13 +1071,84 @@ static void test_schnorrsig_sign_verify(void) {
         }
         CHECK(secp256k1_schnorrsig_sign_custom(CTX, sig[0], msg_large, msglen, &keypair, NULL) == 1);
         CHECK(secp256k1_schnorrsig_verify(CTX, sig[0], msg_large, msglen, &pk) == 1);
+        CHECK(secp256k1_schnorrsig_verify_prepared(CTX, sig[0], msg_large, msglen, prepared) == 1);
         /* Verification for a random wrong message length fails */
         msglen = (msglen + (sizeof(msg_large) - 1)) % sizeof(msg_large);
         CHECK(secp256k1_schnorrsig_verify(CTX, sig[0], msg_large, msglen, &pk) == 0);
+        CHECK(secp256k1_schnorrsig_verify_prepared(CTX, sig[0], msg_large, msglen, prepared) == 0);
     }
+    secp256k1_pubkey_prepared_destroy(CTX, prepared);
 }
 #undef N_SIGS
 
+/* Checks that verify_batch agrees with verify on batches of random sizes with
+ * at most one invalid signature, for various scratch space sizes. Half of the
+ * batches have messages of equal length, whose challenges are computed in
+ * groups of eight. */
+static void test_schnorrsig_verify_batch(void) {
+    enum { N_MAX = 40 };
+    unsigned char sk[32];
+    unsigned char msg[N_MAX][32];
+    unsigned char sig[N_MAX][64];
+    const unsigned char *sig_ptr[N_MAX];
+    const unsigned char *msg_ptr[N_MAX];
+    size_t msglen[N_MAX];
+    secp256k1_xonly_pubkey pk[N_MAX];
+    const secp256k1_xonly_pubkey *pk_ptr[N_MAX];
+    secp256k1_keypair keypair;
+    secp256k1_scratch_space *scratch;
+    size_t n = 1 + secp256k1_testrand_int(N_MAX);
+    size_t i, bad;
+    int expected;
+    int equal_msglen = secp256k1_testrand_bits(1);
+    size_t common_msglen = secp256k1_testrand_int(33);
+
+    for (i = 0; i < n; i++) {
+        secp256k1_testrand256(sk);
+        CHECK(secp256k1_keypair_create(CTX, &keypair, sk));
+        CHECK(secp256k1_keypair_xonly_pub(CTX, &pk[i], NULL, &keypair));
+        secp256k1_testrand256(msg[i]);
+        msglen[i] = equal_msglen ? common_msglen : secp256k1_testrand_int(33);
+        CHECK(secp256k1_schnorrsig_sign_custom(CTX, sig[i], msg[i], msglen[i], &keypair, NULL));
+        sig_ptr[i] = sig[i];
+        msg_ptr[i] = msg[i];
+        pk_ptr[i] = &pk[i];
+    }
+    scratch = secp256k1_scratch_space_create(CTX, secp256k1_testrand_int(1 << 16));
+
+    /* Either leave the batch intact or invalidate one signature in one of
+     * several ways. */
+    bad = secp256k1_testrand_int(n);
+    expected = 0;
+    switch (secp256k1_testrand_int(6)) {
+        case 0:
+            /* R is not a valid x coordinate. */
+            memset(sig[bad], 0xFF, 32);
+            break;
+        case 1:
+            /* s overflows */
+            memset(&sig[bad][32], 0xFF, 32);
+            break;
+        case 2:
+            sig[bad][secp256k1_testrand_int(64)] ^= 1 + secp256k1_testrand_int(255);
+            break;
+        case 3:
+            /* Signature of a different key. */
+            pk_ptr[bad] = &pk[(bad + 1) % n];
+            expected = (n == 1);
+            break;
+        default:
+            expected = 1;
+    }
+    CHECK(secp256k1_schnorrsig_verify_batch(CTX, scratch, sig_ptr, msg_ptr, msglen, pk_ptr, n) == expected);
+    CHECK(secp256k1_schnorrsig_verify_batch(CTX, NULL, sig_ptr, msg_ptr, msglen, pk_ptr, n) == expected);
+    for (i = 0; i < n; i++) {
+        CHECK(secp256k1_schnorrsig_verify(CTX, sig_ptr[i], msg_ptr[i], msglen[i], pk_ptr[i]) == (expected || i != bad));
+    }
+
+    secp256k1_scratch_space_destroy(CTX, scratch);
+}
+
 static void test_schnorrsig_taproot(void) {
     unsigned char sk[32];
     secp256k1_keypair keypair;
@@ -974,7 +1194,10 @@ static void run_schnorrsig_tests(void) {
     test_schnorrsig_bip_vectors();
     for (i = 0; i < COUNT; i++) {
         test_schnorrsig_sign();
+        test_schnorrsig_sign_pool();
+        test_schnorrsig_sign_signer();
         test_schnorrsig_sign_verify();
+        test_schnorrsig_verify_batch();
     }
     test_schnorrsig_taproot();
 }
@@ -6,6 +6,7 @@
 
 #include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include "../include/secp256k1.h"
 
@@ -17,6 +18,8 @@
 #include "int128_impl.h"
 #include "ecmult.h"
 #include "ecmult_compute_table_impl.h"
+#include "ecmult_gen_compute_table_impl.h"
+#include "table_file_impl.h"
 
 static void print_table(FILE *fp, const char *name, int window_g, const secp256k1_ge_storage* table) {
     int j;
@@ -53,12 +56,77 @@ static void print_two_tables(FILE *fp, int window_g) {
     free(table_128);
 }
 
-int main(void) {
+/* Writes a table file (see table_file.h) with G tables for the given window
+ * size (if window_g > 0) and a comb table for the given parameters (if
+ * comb_blocks > 0). */
+static int write_table_file(const char *outfile, int window_g, int comb_blocks, int comb_teeth) {
+    size_t payload_len = secp256k1_table_file_payload_len(window_g, comb_blocks, comb_teeth);
+    unsigned char* file = malloc(SECP256K1_TABLE_FILE_HEADER_SIZE + payload_len);
+    secp256k1_ge_storage* table;
+    FILE* fp;
+    int ret = 0;
+
+    if (file == NULL) {
+        fprintf(stderr, "Could not allocate %lu bytes!\n", (unsigned long)payload_len);
+        return -1;
+    }
+    table = (secp256k1_ge_storage *)(void *)(file + SECP256K1_TABLE_FILE_HEADER_SIZE);
+    if (window_g > 0) {
+        secp256k1_ecmult_compute_two_tables(table, table + ECMULT_TABLE_SIZE(window_g), window_g, &secp256k1_ge_const_g);
+        table += 2 * ECMULT_TABLE_SIZE(window_g);
+    }
+    if (comb_blocks > 0) {
+        secp256k1_ecmult_gen_compute_table(table, &secp256k1_ge_const_g, comb_blocks, comb_teeth, CEIL_DIV(256, comb_blocks * comb_teeth));
+    }
+    secp256k1_table_file_write_header(file, window_g, comb_blocks, comb_teeth, file + SECP256K1_TABLE_FILE_HEADER_SIZE, payload_len);
+
+    fp = fopen(outfile, "wb");
+    if (fp == NULL) {
+        fprintf(stderr, "Could not open %s for writing!\n", outfile);
+        ret = -1;
+    } else {
+        if (fwrite(file, 1, SECP256K1_TABLE_FILE_HEADER_SIZE + payload_len, fp) != SECP256K1_TABLE_FILE_HEADER_SIZE + payload_len) {
+            fprintf(stderr, "Could not write %s!\n", outfile);
+            ret = -1;
+        }
+        if (fclose(fp) != 0) {
+            ret = -1;
+        }
+    }
+    free(file);
+    return ret;
+}
+
+int main(int argc, char** argv) {
     /* Always compute all tables for window sizes up to 15. */
     int window_g = (ECMULT_WINDOW_SIZE < 15) ? 15 : ECMULT_WINDOW_SIZE;
     const char outfile[] = "src/precomputed_ecmult.c";
     FILE* fp;
 
+    if (argc == 3 || argc == 5) {
+        /* Write a table file, to be used at runtime with
+         * secp256k1_context_set_ecmult_tables. */
+        int comb_blocks = 0, comb_teeth = 0;
+        window_g = atoi(argv[1]);
+        if (argc == 5) {
+            comb_blocks = atoi(argv[3]);
+            comb_teeth = atoi(argv[4]);
+            if (comb_blocks < 1 || comb_blocks > 256 || comb_teeth < 1 || comb_teeth > 8
+                || comb_blocks * comb_teeth * CEIL_DIV(256, comb_blocks * comb_teeth) < 256) {
+                fprintf(stderr, "Comb blocks must be in range [1..256] and teeth in range [1..8].\n");
+                return -1;
+            }
+        }
+        if ((window_g < 2 && !(window_g == 0 && comb_blocks > 0)) || window_g > 24) {
+            fprintf(stderr, "Window size must be in range [2..24] (or 0 if a comb table is written).\n");
+            return -1;
+        }
+        return write_table_file(argv[2], window_g, comb_blocks, comb_teeth);
+    } else if (argc != 1) {
+        fprintf(stderr, "Usage: %s [WINDOW FILE [BLOCKS TEETH]]\n", argv[0]);
+        return -1;
+    }
+
     fp = fopen(outfile, "w");
     if (fp == NULL) {
         fprintf(stderr, "Could not open %s for writing!\n", outfile);
@@ -358,6 +358,71 @@ static void secp256k1_scalar_reduce_512(secp256k1_scalar *r, const uint64_t *l)
     uint64_t p0, p1, p2, p3, p4;
     uint64_t c;
 
+#if defined(__BMI2__) && defined(__ADX__)
+    /* MULX leaves the flags alone, so the low and high halves of the
+     * products by c0 (and c1) can be accumulated in two independent carry
+     * chains, using ADCX (carry flag) and ADOX (overflow flag). */
+    __asm__ __volatile__(
+    /* Initialize (r8,r9,r10,r11) = l[0..3] */
+    "movq 0(%%rsi), %%r8\n"
+    "movq 8(%%rsi), %%r9\n"
+    "movq 16(%%rsi), %%r10\n"
+    "movq 24(%%rsi), %%r11\n"
+    /* (r8,r9,r10,r11,r12) += n0..n3 * c0 */
+    "xorl %%eax, %%eax\n"
+    "movq %8, %%rdx\n"
+    "movq %%rax, %%r12\n"
+    "mulxq 32(%%rsi), %%rax, %%rcx\n"
+    "adcxq %%rax, %%r8\n"
+    "adoxq %%rcx, %%r9\n"
+    "mulxq 40(%%rsi), %%rax, %%rcx\n"
+    "adcxq %%rax, %%r9\n"
+    "adoxq %%rcx, %%r10\n"
+    "mulxq 48(%%rsi), %%rax, %%rcx\n"
+    "adcxq %%rax, %%r10\n"
+    "adoxq %%rcx, %%r11\n"
+    "mulxq 56(%%rsi), %%rax, %%rcx\n"
+    "adcxq %%rax, %%r11\n"
+    "adoxq %%rcx, %%r12\n"
+    "adcq $0, %%r12\n"
+    /* extract m0 */
+    "movq %%r8, %q0\n"
+    /* (r9,r10,r11,r12,r13) += n0..n3 * c1 */
+    "xorl %%eax, %%eax\n"
+    "movq %9, %%rdx\n"
+    "movq %%rax, %%r13\n"
+    "mulxq 32(%%rsi), %%rax, %%rcx\n"
+    "adcxq %%rax, %%r9\n"
+    "adoxq %%rcx, %%r10\n"
+    "mulxq 40(%%rsi), %%rax, %%rcx\n"
+    "adcxq %%rax, %%r10\n"
+    "adoxq %%rcx, %%r11\n"
+    "mulxq 48(%%rsi), %%rax, %%rcx\n"
+    "adcxq %%rax, %%r11\n"
+    "adoxq %%rcx, %%r12\n"
+    "mulxq 56(%%rsi), %%rax, %%rcx\n"
+    "adcxq %%rax, %%r12\n"
+    "adoxq %%rcx, %%r13\n"
+    "adcq $0, %%r13\n"
+    /* extract m1 */
+    "movq %%r9, %q1\n"
+    /* (r10,r11,r12,r13,r14) += n0..n3 << 128 */
+    "xorl %%r14d, %%r14d\n"
+    "addq 32(%%rsi), %%r10\n"
+    "adcq 40(%%rsi), %%r11\n"
+    "adcq 48(%%rsi), %%r12\n"
+    "adcq 56(%%rsi), %%r13\n"
+    "adcq $0, %%r14\n"
+    /* extract m2..m6 */
+    "movq %%r10, %q2\n"
+    "movq %%r11, %q3\n"
+    "movq %%r12, %q4\n"
+    "movq %%r13, %q5\n"
+    "movq %%r14, %q6\n"
+    : "=&g"(m0), "=&g"(m1), "=&g"(m2), "=g"(m3), "=g"(m4), "=g"(m5), "=g"(m6)
+    : "S"(l), "i"(SECP256K1_N_C_0), "i"(SECP256K1_N_C_1)
+    : "rax", "rcx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "cc");
+#else
     __asm__ __volatile__(
     /* Preload. */
     "movq 32(%%rsi), %%r11\n"
@@ -462,6 +527,7 @@ static void secp256k1_scalar_reduce_512(secp256k1_scalar *r, const uint64_t *l)
     : "=&g"(m0), "=&g"(m1), "=&g"(m2), "=g"(m3), "=g"(m4), "=g"(m5), "=g"(m6)
     : "S"(l), "i"(SECP256K1_N_C_0), "i"(SECP256K1_N_C_1)
     : "rax", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "cc");
+#endif
 
     SECP256K1_CHECKMEM_MSAN_DEFINE(&m0, sizeof(m0));
     SECP256K1_CHECKMEM_MSAN_DEFINE(&m1, sizeof(m1));
@@ -472,6 +538,62 @@ static void secp256k1_scalar_reduce_512(secp256k1_scalar *r, const uint64_t *l)
     SECP256K1_CHECKMEM_MSAN_DEFINE(&m6, sizeof(m6));
 
     /* Reduce 385 bits into 258. */
+#if defined(__BMI2__) && defined(__ADX__)
+    __asm__ __volatile__(
+    /* Preload m4..m6 */
+    "movq %q9, %%r13\n"
+    "movq %q10, %%r14\n"
+    "movq %q11, %%r15\n"
+    /* Initialize (r8,r9,r10,r11) = m0..m3 */
+    "movq %q5, %%r8\n"
+    "movq %q6, %%r9\n"
+    "movq %q7, %%r10\n"
+    "movq %q8, %%r11\n"
+    /* (r8,r9,r10,r11,r12) += m4..m6 * c0 */
+    "xorl %%ebx, %%ebx\n"
+    "movq %12, %%rdx\n"
+    "movq %%rbx, %%r12\n"
+    "mulxq %%r13, %%rax, %%rcx\n"
+    "adcxq %%rax, %%r8\n"
+    "adoxq %%rcx, %%r9\n"
+    "mulxq %%r14, %%rax, %%rcx\n"
+    "adcxq %%rax, %%r9\n"
+    "adoxq %%rcx, %%r10\n"
+    "mulxq %%r15, %%rax, %%rcx\n"
+    "adcxq %%rax, %%r10\n"
+    "adoxq %%rcx, %%r11\n"
+    "adcxq %%rbx, %%r11\n"
+    "adoxq %%rbx, %%r12\n"
+    "adcxq %%rbx, %%r12\n"
+    /* extract p0 */
+    "movq %%r8, %q0\n"
+    /* (r9,r10,r11,r12) += m4..m6 * c1 */
+    "xorl %%ebx, %%ebx\n"
+    "movq %13, %%rdx\n"
+    "mulxq %%r13, %%rax, %%rcx\n"
+    "adcxq %%rax, %%r9\n"
+    "adoxq %%rcx, %%r10\n"
+    "mulxq %%r14, %%rax, %%rcx\n"
+    "adcxq %%rax, %%r10\n"
+    "adoxq %%rcx, %%r11\n"
+    "mulxq %%r15, %%rax, %%rcx\n"
+    "adcxq %%rax, %%r11\n"
+    "adoxq %%rcx, %%r12\n"
+    "adcxq %%rbx, %%r12\n"
+    /* extract p1 */
+    "movq %%r9, %q1\n"
+    /* (r10,r11,r12) += m4..m6 << 128 */
+    "addq %%r13, %%r10\n"
+    "adcq %%r14, %%r11\n"
+    "adcq %%r15, %%r12\n"
+    /* extract p2..p4 */
+    "movq %%r10, %q2\n"
+    "movq %%r11, %q3\n"
+    "movq %%r12, %q4\n"
+    : "=&g"(p0), "=&g"(p1), "=&g"(p2), "=g"(p3), "=g"(p4)
+    : "g"(m0), "g"(m1), "g"(m2), "g"(m3), "g"(m4), "g"(m5), "g"(m6), "i"(SECP256K1_N_C_0), "i"(SECP256K1_N_C_1)
+    : "rax", "rbx", "rcx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15", "cc");
+#else
     __asm__ __volatile__(
     /* Preload */
     "movq %q9, %%r11\n"
@@ -549,6 +671,7 @@ static void secp256k1_scalar_reduce_512(secp256k1_scalar *r, const uint64_t *l)
     : "=&g"(p0), "=&g"(p1), "=&g"(p2), "=g"(p3), "=g"(p4)
     : "g"(m0), "g"(m1), "g"(m2), "g"(m3), "g"(m4), "g"(m5), "g"(m6), "i"(SECP256K1_N_C_0), "i"(SECP256K1_N_C_1)
     : "rax", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "cc");
+#endif
 
     SECP256K1_CHECKMEM_MSAN_DEFINE(&p0, sizeof(p0));
     SECP256K1_CHECKMEM_MSAN_DEFINE(&p1, sizeof(p1));
@@ -683,7 +806,92 @@ static void secp256k1_scalar_reduce_512(secp256k1_scalar *r, const uint64_t *l)
 }
 
 static void secp256k1_scalar_mul_512(uint64_t *l8, const secp256k1_scalar *a, const secp256k1_scalar *b) {
-#ifdef USE_ASM_X86_64
+#if defined(USE_ASM_X86_64) && defined(__BMI2__) && defined(__ADX__)
+    /* Row by row: MULX leaves the flags alone, so the low halves of the
+     * products of a row can be accumulated with ADCX (carry flag) and the
+     * high halves with ADOX (overflow flag) as two independent chains. */
+    __asm__ __volatile__(
+    /* (r8,r9,r10,r11,r12) = a * b0 */
+    "movq 0(%%rcx), %%rdx\n"
+    "mulxq 0(%%rdi), %%r8, %%r9\n"
+    "mulxq 8(%%rdi), %%r13, %%r10\n"
+    "addq %%r13, %%r9\n"
+    "mulxq 16(%%rdi), %%r13, %%r11\n"
+    "adcq %%r13, %%r10\n"
+    "mulxq 24(%%rdi), %%r13, %%r12\n"
+    "adcq %%r13, %%r11\n"
+    "adcq $0, %%r12\n"
+    /* Extract l8[0] */
+    "movq %%r8, 0(%%rsi)\n"
+    /* (r9,r10,r11,r12,r8) += a * b1 */
+    "xorl %%eax, %%eax\n"
+    "movq 8(%%rcx), %%rdx\n"
+    "movq %%rax, %%r8\n"
+    "mulxq 0(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r9\n"
+    "adoxq %%r14, %%r10\n"
+    "mulxq 8(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r10\n"
+    "adoxq %%r14, %%r11\n"
+    "mulxq 16(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r11\n"
+    "adoxq %%r14, %%r12\n"
+    "mulxq 24(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r12\n"
+    "adoxq %%r14, %%r8\n"
+    "adcxq %%rax, %%r8\n"
+    /* Extract l8[1] */
+    "movq %%r9, 8(%%rsi)\n"
+    /* (r10,r11,r12,r8,r9) += a * b2 */
+    "xorl %%eax, %%eax\n"
+    "movq 16(%%rcx), %%rdx\n"
+    "movq %%rax, %%r9\n"
+    "mulxq 0(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r10\n"
+    "adoxq %%r14, %%r11\n"
+    "mulxq 8(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r11\n"
+    "adoxq %%r14, %%r12\n"
+    "mulxq 16(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r12\n"
+    "adoxq %%r14, %%r8\n"
+    "mulxq 24(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r8\n"
+    "adoxq %%r14, %%r9\n"
+    "adcxq %%rax, %%r9\n"
+    /* Extract l8[2] */
+    "movq %%r10, 16(%%rsi)\n"
+    /* (r11,r12,r8,r9,r10) += a * b3 */
+    "xorl %%eax, %%eax\n"
+    "movq 24(%%rcx), %%rdx\n"
+    "movq %%rax, %%r10\n"
+    "mulxq 0(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r11\n"
+    "adoxq %%r14, %%r12\n"
+    "mulxq 8(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r12\n"
+    "adoxq %%r14, %%r8\n"
+    "mulxq 16(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r8\n"
+    "adoxq %%r14, %%r9\n"
+    "mulxq 24(%%rdi), %%r13, %%r14\n"
+    "adcxq %%r13, %%r9\n"
+    "adoxq %%r14, %%r10\n"
+    "adcxq %%rax, %%r10\n"
+    /* Extract l8[3..7] */
+    "movq %%r11, 24(%%rsi)\n"
+    "movq %%r12, 32(%%rsi)\n"
+    "movq %%r8, 40(%%rsi)\n"
+    "movq %%r9, 48(%%rsi)\n"
+    "movq %%r10, 56(%%rsi)\n"
+
+    :
+    : "S"(l8), "D"(a->d), "c"(b->d)
+    : "rax", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "cc", "memory");
+
+    SECP256K1_CHECKMEM_MSAN_DEFINE(l8, sizeof(*l8) * 8);
+
+#elif defined(USE_ASM_X86_64)
     const uint64_t *pb = b->d;
     __asm__ __volatile__(
     /* Preload */
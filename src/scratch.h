@@ -19,12 +19,37 @@ typedef struct secp256k1_scratch_space_struct {
     size_t alloc_size;
     /** maximum size available to allocate */
     size_t max_size;
+    /** runs independent tasks of a computation, or NULL */
+    secp256k1_executor executor;
+    void *executor_data;
+    /** maximum number of tasks to hand to the executor (at least 1) */
+    size_t n_tasks;
+    /** selects the multi-scalar multiplication algorithm, if has_tuning */
+    secp256k1_ecmult_multi_tuning tuning;
+    int has_tuning;
+    /** whether multi-scalar multiplications coalesce repeated points */
+    int dedup;
 } secp256k1_scratch;
 
 static secp256k1_scratch* secp256k1_scratch_create(const secp256k1_callback* error_callback, size_t max_size);
 
 static void secp256k1_scratch_destroy(const secp256k1_callback* error_callback, secp256k1_scratch* scratch);
 
+/** Sets the executor used to run independent tasks of computations that use
+ *  this scratch space. A NULL executor or n_tasks <= 1 disables it. */
+static void secp256k1_scratch_set_executor(const secp256k1_callback* error_callback, secp256k1_scratch* scratch, secp256k1_executor executor, void *executor_data, size_t n_tasks);
+
+/** Returns the maximum number of tasks a computation may be split into. */
+static size_t secp256k1_scratch_n_tasks(const secp256k1_scratch* scratch);
+
+/** Sets the tuning of multi-scalar multiplications that use this scratch
+ *  space. A NULL tuning restores the defaults. */
+static void secp256k1_scratch_set_tuning(const secp256k1_callback* error_callback, secp256k1_scratch* scratch, const secp256k1_ecmult_multi_tuning *tuning);
+
+/** Sets whether multi-scalar multiplications that use this scratch space
+ *  coalesce repeated points before multiplying. */
+static void secp256k1_scratch_set_dedup(const secp256k1_callback* error_callback, secp256k1_scratch* scratch, int dedup);
+
 /** Returns an opaque object used to "checkpoint" a scratch space. Used
  *  with `secp256k1_scratch_apply_checkpoint` to undo allocations. */
 static size_t secp256k1_scratch_checkpoint(const secp256k1_callback* error_callback, const secp256k1_scratch* scratch);
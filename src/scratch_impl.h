@@ -19,6 +19,11 @@ static secp256k1_scratch* secp256k1_scratch_create(const secp256k1_callback* err
         memcpy(ret->magic, "scratch", 8);
         ret->data = (void *) ((char *) alloc + base_alloc);
         ret->max_size = size;
+        ret->executor = NULL;
+        ret->executor_data = NULL;
+        ret->n_tasks = 1;
+        ret->has_tuning = 0;
+        ret->dedup = 0;
     }
     return ret;
 }
@@ -35,6 +40,44 @@ static void secp256k1_scratch_destroy(const secp256k1_callback* error_callback,
     }
 }
 
+static void secp256k1_scratch_set_executor(const secp256k1_callback* error_callback, secp256k1_scratch* scratch, secp256k1_executor executor, void *executor_data, size_t n_tasks) {
+    if (secp256k1_memcmp_var(scratch->magic, "scratch", 8) != 0) {
+        secp256k1_callback_call(error_callback, "invalid scratch space");
+        return;
+    }
+    if (executor == NULL || n_tasks <= 1) {
+        executor = NULL;
+        executor_data = NULL;
+        n_tasks = 1;
+    }
+    scratch->executor = executor;
+    scratch->executor_data = executor_data;
+    scratch->n_tasks = n_tasks;
+}
+
+static size_t secp256k1_scratch_n_tasks(const secp256k1_scratch* scratch) {
+    return scratch->n_tasks;
+}
+
+static void secp256k1_scratch_set_tuning(const secp256k1_callback* error_callback, secp256k1_scratch* scratch, const secp256k1_ecmult_multi_tuning *tuning) {
+    if (secp256k1_memcmp_var(scratch->magic, "scratch", 8) != 0) {
+        secp256k1_callback_call(error_callback, "invalid scratch space");
+        return;
+    }
+    scratch->has_tuning = tuning != NULL;
+    if (tuning != NULL) {
+        scratch->tuning = *tuning;
+    }
+}
+
+static void secp256k1_scratch_set_dedup(const secp256k1_callback* error_callback, secp256k1_scratch* scratch, int dedup) {
+    if (secp256k1_memcmp_var(scratch->magic, "scratch", 8) != 0) {
+        secp256k1_callback_call(error_callback, "invalid scratch space");
+        return;
+    }
+    scratch->dedup = !!dedup;
+}
+
 static size_t secp256k1_scratch_checkpoint(const secp256k1_callback* error_callback, const secp256k1_scratch* scratch) {
     if (secp256k1_memcmp_var(scratch->magic, "scratch", 8) != 0) {
         secp256k1_callback_call(error_callback, "invalid scratch space");
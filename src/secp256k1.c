@@ -30,6 +30,7 @@
 #include "ecmult_impl.h"
 #include "ecmult_const_impl.h"
 #include "ecmult_gen_impl.h"
+#include "ecmult_gen_compute_table_impl.h"
 #include "ecdsa_impl.h"
 #include "eckey_impl.h"
 #include "hash_impl.h"
@@ -37,6 +38,7 @@
 #include "scratch_impl.h"
 #include "selftest.h"
 #include "hsort_impl.h"
+#include "table_file_impl.h"
 
 #ifdef SECP256K1_NO_BUILD
 # error "secp256k1.h processed without SECP256K1_BUILD defined while building secp256k1.c"
@@ -60,15 +62,22 @@
  * context_eq function. */
 struct secp256k1_context_struct {
     secp256k1_ecmult_gen_context ecmult_gen_ctx;
+    secp256k1_ecmult_g_tables ecmult_g;
     secp256k1_callback illegal_callback;
     secp256k1_callback error_callback;
     int declassify;
+    /* The SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_* flag the context was
+     * created with. If it selects a comb table other than the built-in one,
+     * that table is stored right after the context. */
+    unsigned int ecmult_gen_flags;
 };
 
 static const secp256k1_context secp256k1_context_static_ = {
     { 0 },
+    { secp256k1_pre_g, secp256k1_pre_g_128, WINDOW_G },
     { secp256k1_default_illegal_callback_fn, 0 },
     { secp256k1_default_error_callback_fn, 0 },
+    0,
     0
 };
 const secp256k1_context *secp256k1_context_static = &secp256k1_context_static_;
@@ -83,6 +92,59 @@ static int secp256k1_context_is_proper(const secp256k1_context* ctx) {
     return secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx);
 }
 
+/* Get the comb parameters selected by a SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_*
+ * flag, or the built-in ones if there is none. */
+static void secp256k1_context_comb_params(int *blocks, int *teeth, unsigned int ecmult_gen_flags) {
+    switch (ecmult_gen_flags) {
+    case SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_2:
+        *blocks = 2;
+        *teeth = 5;
+        break;
+    case SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_22:
+        *blocks = 11;
+        *teeth = 6;
+        break;
+    case SECP256K1_FLAGS_BIT_CONTEXT_ECMULT_GEN_KB_86:
+        *blocks = 43;
+        *teeth = 6;
+        break;
+    default:
+        *blocks = COMB_BLOCKS;
+        *teeth = COMB_TEETH;
+    }
+}
+
+/* Returns the size of the comb table stored after a context created with the
+ * given flag (0 if the context uses the built-in table). */
+static size_t secp256k1_context_comb_table_size(unsigned int ecmult_gen_flags) {
+    int blocks, teeth;
+    secp256k1_context_comb_params(&blocks, &teeth, ecmult_gen_flags);
+    if (blocks == COMB_BLOCKS && teeth == COMB_TEETH) {
+        return 0;
+    }
+    return ((size_t)blocks << (teeth - 1)) * sizeof(secp256k1_ge_storage);
+}
+
+static size_t secp256k1_context_size(unsigned int ecmult_gen_flags) {
+    size_t comb_size = secp256k1_context_comb_table_size(ecmult_gen_flags);
+    return comb_size == 0 ? sizeof(secp256k1_context) : ROUND_TO_ALIGN(sizeof(secp256k1_context)) + comb_size;
+}
+
+static secp256k1_ge_storage *secp256k1_context_comb_table(secp256k1_context *ctx) {
+    return (secp256k1_ge_storage *)(void *)((unsigned char *)ctx + ROUND_TO_ALIGN(sizeof(secp256k1_context)));
+}
+
+/* Make the context use the comb table selected at its creation. */
+static void secp256k1_context_reset_comb_table(secp256k1_context *ctx) {
+    int blocks, teeth;
+    if (secp256k1_context_comb_table_size(ctx->ecmult_gen_flags) == 0) {
+        secp256k1_ecmult_gen_context_set_table(&ctx->ecmult_gen_ctx, NULL, 0, 0);
+        return;
+    }
+    secp256k1_context_comb_params(&blocks, &teeth, ctx->ecmult_gen_flags);
+    secp256k1_ecmult_gen_context_set_table(&ctx->ecmult_gen_ctx, secp256k1_context_comb_table(ctx), blocks, teeth);
+}
+
 void secp256k1_selftest(void) {
     if (!secp256k1_selftest_passes()) {
         secp256k1_callback_call(&default_error_callback, "self test failed");
@@ -90,9 +152,8 @@ void secp256k1_selftest(void) {
 }
 
 size_t secp256k1_context_preallocated_size(unsigned int flags) {
-    size_t ret = sizeof(secp256k1_context);
-    /* A return value of 0 is reserved as an indicator for errors when we call this function internally. */
-    VERIFY_CHECK(ret != 0);
+    size_t ret;
+    int blocks, teeth;
 
     if (EXPECT((flags & SECP256K1_FLAGS_TYPE_MASK) != SECP256K1_FLAGS_TYPE_CONTEXT, 0)) {
             secp256k1_callback_call(&default_illegal_callback,
@@ -106,13 +167,23 @@ size_t secp256k1_context_preallocated_size(unsigned int flags) {
             return 0;
     }
 
+    secp256k1_context_comb_params(&blocks, &teeth, flags & SECP256K1_FLAGS_MASK_CONTEXT_ECMULT_GEN);
+    if (EXPECT(!secp256k1_ecmult_gen_comb_params_valid(blocks, teeth), 0)) {
+            secp256k1_callback_call(&default_illegal_callback,
+                                    "Invalid flags");
+            return 0;
+    }
+
+    ret = secp256k1_context_size(flags & SECP256K1_FLAGS_MASK_CONTEXT_ECMULT_GEN);
+    /* A return value of 0 is reserved as an indicator for errors when we call this function internally. */
+    VERIFY_CHECK(ret != 0);
     return ret;
 }
 
 size_t secp256k1_context_preallocated_clone_size(const secp256k1_context* ctx) {
     VERIFY_CHECK(ctx != NULL);
     ARG_CHECK(secp256k1_context_is_proper(ctx));
-    return sizeof(secp256k1_context);
+    return secp256k1_context_size(ctx->ecmult_gen_flags);
 }
 
 secp256k1_context* secp256k1_context_preallocated_create(void* prealloc, unsigned int flags) {
@@ -133,7 +204,15 @@ secp256k1_context* secp256k1_context_preallocated_create(void* prealloc, unsigne
     /* Flags have been checked by secp256k1_context_preallocated_size. */
     VERIFY_CHECK((flags & SECP256K1_FLAGS_TYPE_MASK) == SECP256K1_FLAGS_TYPE_CONTEXT);
     secp256k1_ecmult_gen_context_build(&ret->ecmult_gen_ctx);
+    ret->ecmult_g = secp256k1_ecmult_g_tables_default;
     ret->declassify = !!(flags & SECP256K1_FLAGS_BIT_CONTEXT_DECLASSIFY);
+    ret->ecmult_gen_flags = flags & SECP256K1_FLAGS_MASK_CONTEXT_ECMULT_GEN;
+    if (secp256k1_context_comb_table_size(ret->ecmult_gen_flags) != 0) {
+        int blocks, teeth;
+        secp256k1_context_comb_params(&blocks, &teeth, ret->ecmult_gen_flags);
+        secp256k1_ecmult_gen_compute_table(secp256k1_context_comb_table(ret), &secp256k1_ge_const_g, blocks, teeth, CEIL_DIV(COMB_RANGE, blocks * teeth));
+        secp256k1_context_reset_comb_table(ret);
+    }
 
     return ret;
 }
@@ -157,6 +236,14 @@ secp256k1_context* secp256k1_context_preallocated_clone(const secp256k1_context*
 
     ret = (secp256k1_context*)prealloc;
     *ret = *ctx;
+    if (secp256k1_context_comb_table_size(ctx->ecmult_gen_flags) != 0) {
+        /* The clone has its own copy of the comb table stored after it. */
+        const secp256k1_ge_storage *src = secp256k1_context_comb_table((secp256k1_context *)ctx);
+        memcpy(secp256k1_context_comb_table(ret), src, secp256k1_context_comb_table_size(ctx->ecmult_gen_flags));
+        if (ctx->ecmult_gen_ctx.prec == src) {
+            ret->ecmult_gen_ctx.prec = secp256k1_context_comb_table(ret);
+        }
+    }
     return ret;
 }
 
@@ -220,6 +307,37 @@ void secp256k1_context_set_error_callback(secp256k1_context* ctx, void (*fun)(co
     ctx->error_callback.data = data;
 }
 
+int secp256k1_context_set_ecmult_tables(secp256k1_context* ctx, const unsigned char *tables, size_t tables_len) {
+    secp256k1_table_file tf;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_context_is_proper(ctx));
+
+    if (tables == NULL) {
+        tf.g.window_g = 0;
+        tf.comb = NULL;
+    } else if (!secp256k1_table_file_load(&tf, tables, tables_len)) {
+        return 0;
+    }
+    ctx->ecmult_g = tf.g.window_g > 0 ? tf.g : secp256k1_ecmult_g_tables_default;
+    if (tf.comb != NULL) {
+        secp256k1_ecmult_gen_context_set_table(&ctx->ecmult_gen_ctx, tf.comb, tf.comb_blocks, tf.comb_teeth);
+    } else {
+        secp256k1_context_reset_comb_table(ctx);
+    }
+    return 1;
+}
+
+int secp256k1_ecmult_tables_check(const secp256k1_context* ctx, const unsigned char *tables, size_t tables_len) {
+    secp256k1_table_file tf;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(tables != NULL);
+
+    return secp256k1_table_file_load(&tf, tables, tables_len)
+        && secp256k1_table_file_check_payload(tables, tables_len);
+}
+
 secp256k1_scratch_space* secp256k1_scratch_space_create(const secp256k1_context* ctx, size_t max_size) {
     VERIFY_CHECK(ctx != NULL);
     return secp256k1_scratch_create(&ctx->error_callback, max_size);
@@ -230,6 +348,28 @@ void secp256k1_scratch_space_destroy(const secp256k1_context *ctx, secp256k1_scr
     secp256k1_scratch_destroy(&ctx->error_callback, scratch);
 }
 
+void secp256k1_scratch_space_set_executor(const secp256k1_context *ctx, secp256k1_scratch_space* scratch, secp256k1_executor executor, void *executor_data, size_t n_tasks) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK_VOID(scratch != NULL);
+    secp256k1_scratch_set_executor(&ctx->error_callback, scratch, executor, executor_data, n_tasks);
+}
+
+int secp256k1_scratch_space_set_tuning(const secp256k1_context *ctx, secp256k1_scratch_space* scratch, const secp256k1_ecmult_multi_tuning *tuning) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(scratch != NULL);
+    if (tuning != NULL && !secp256k1_ecmult_multi_tuning_is_valid(tuning)) {
+        return 0;
+    }
+    secp256k1_scratch_set_tuning(&ctx->error_callback, scratch, tuning);
+    return 1;
+}
+
+void secp256k1_scratch_space_set_dedup(const secp256k1_context *ctx, secp256k1_scratch_space* scratch, int enable) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK_VOID(scratch != NULL);
+    secp256k1_scratch_set_dedup(&ctx->error_callback, scratch, enable);
+}
+
 /* Mark memory as no-longer-secret for the purpose of analysing constant-time behaviour
  *  of the software.
  */
@@ -237,6 +377,68 @@ static SECP256K1_INLINE void secp256k1_declassify(const secp256k1_context* ctx,
     if (EXPECT(ctx->declassify, 0)) SECP256K1_CHECKMEM_DEFINE(p, len);
 }
 
+/* Batch verification replaces n checks of the form X_i = 0 by the single check
+ * sum(a_i * X_i) = 0 with randomizers a_i. The randomizers are derived from a
+ * hash of all inputs, so they are only known after the inputs are fixed. The
+ * first randomizer is always 1, which saves one scalar multiplication. */
+static void secp256k1_batch_sha256_tagged(secp256k1_sha256 *sha) {
+    static const unsigned char tag[15] = "secp256k1/batch";
+    secp256k1_sha256_initialize_tagged(sha, tag, sizeof(tag));
+}
+
+static void secp256k1_batch_randomizer(secp256k1_scalar *r, const unsigned char *seed32, size_t idx) {
+    secp256k1_sha256 sha;
+    unsigned char buf[32];
+
+    if (idx == 0) {
+        *r = secp256k1_scalar_one;
+        return;
+    }
+    secp256k1_write_be64(buf, (uint64_t)idx);
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, seed32, 32);
+    secp256k1_sha256_write(&sha, buf, 8);
+    secp256k1_sha256_finalize(&sha, buf);
+    secp256k1_scalar_set_b32(r, buf, NULL);
+}
+
+/* Sets r[k] to the randomizer with index idx + k, for all k < 8 with idx + k < n.
+ * Groups of eight randomizers are hashed together with secp256k1_sha256_x8. */
+static void secp256k1_batch_randomizers(secp256k1_scalar *r, const unsigned char *seed32, size_t idx, size_t n) {
+    secp256k1_sha256 sha;
+    secp256k1_sha256_x8 sha_x8;
+    unsigned char buf[8][8];
+    unsigned char out[8 * 32];
+    const unsigned char *data[8];
+    size_t k;
+
+    VERIFY_CHECK(idx < n);
+    if (n - idx < 8) {
+        for (k = 0; k < n - idx; k++) {
+            secp256k1_batch_randomizer(&r[k], seed32, idx + k);
+        }
+        return;
+    }
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_x8_initialize(&sha_x8, &sha);
+    for (k = 0; k < 8; k++) {
+        data[k] = seed32;
+    }
+    secp256k1_sha256_x8_write(&sha_x8, data, 32);
+    for (k = 0; k < 8; k++) {
+        secp256k1_write_be64(buf[k], (uint64_t)(idx + k));
+        data[k] = buf[k];
+    }
+    secp256k1_sha256_x8_write(&sha_x8, data, 8);
+    secp256k1_sha256_x8_finalize(&sha_x8, out);
+    for (k = 0; k < 8; k++) {
+        secp256k1_scalar_set_b32(&r[k], &out[32 * k], NULL);
+    }
+    if (idx == 0) {
+        r[0] = secp256k1_scalar_one;
+    }
+}
+
 static int secp256k1_pubkey_load(const secp256k1_context* ctx, secp256k1_ge* ge, const secp256k1_pubkey* pubkey) {
     secp256k1_ge_storage s;
 
@@ -472,7 +674,171 @@ int secp256k1_ecdsa_verify(const secp256k1_context* ctx, const secp256k1_ecdsa_s
     secp256k1_ecdsa_signature_load(ctx, &r, &s, sig);
     return (!secp256k1_scalar_is_high(&s) &&
             secp256k1_pubkey_load(ctx, &q, pubkey) &&
-            secp256k1_ecdsa_sig_verify(&r, &s, &q, &m));
+            secp256k1_ecdsa_sig_verify(&ctx->ecmult_g, &r, &s, &q, &m));
+}
+
+struct secp256k1_pubkey_prepared_struct {
+    secp256k1_pubkey pubkey;
+    secp256k1_ecmult_prepared_table table;
+};
+
+secp256k1_pubkey_prepared *secp256k1_pubkey_prepared_create(const secp256k1_context* ctx, const secp256k1_pubkey *pubkey) {
+    secp256k1_pubkey_prepared *prepared;
+    secp256k1_ge q;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pubkey != NULL);
+
+    if (!secp256k1_pubkey_load(ctx, &q, pubkey)) {
+        return NULL;
+    }
+    prepared = (secp256k1_pubkey_prepared *)checked_malloc(&ctx->error_callback, sizeof(*prepared));
+    if (prepared == NULL) {
+        return NULL;
+    }
+    prepared->pubkey = *pubkey;
+    secp256k1_ecmult_prepared_table_build(&prepared->table, &q);
+    return prepared;
+}
+
+void secp256k1_pubkey_prepared_destroy(const secp256k1_context* ctx, secp256k1_pubkey_prepared *prepared) {
+    VERIFY_CHECK(ctx != NULL);
+    (void)ctx;
+    if (prepared != NULL) {
+        free(prepared);
+    }
+}
+
+int secp256k1_ecdsa_verify_prepared(const secp256k1_context* ctx, const secp256k1_ecdsa_signature *sig, const unsigned char *msghash32, const secp256k1_pubkey_prepared *pubkey) {
+    secp256k1_scalar r, s;
+    secp256k1_scalar m;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(msghash32 != NULL);
+    ARG_CHECK(sig != NULL);
+    ARG_CHECK(pubkey != NULL);
+
+    secp256k1_scalar_set_b32(&m, msghash32, NULL);
+    secp256k1_ecdsa_signature_load(ctx, &r, &s, sig);
+    return (!secp256k1_scalar_is_high(&s) &&
+            secp256k1_ecdsa_sig_verify_prepared(&ctx->ecmult_g, &r, &s, &pubkey->table, &m));
+}
+
+typedef struct {
+    const secp256k1_context *ctx;
+    const secp256k1_ecdsa_signature * const *sig;
+    const secp256k1_pubkey * const *pubkey;
+    const int *recid;
+    size_t n_sigs;
+    unsigned char seed[32];
+    /* The randomizers of the group of eight signatures that starts at randomizer_idx. */
+    size_t randomizer_idx;
+    secp256k1_scalar randomizer[8];
+} secp256k1_ecdsa_verify_batch_data;
+
+/* Provides the points of the batch equation
+ *   (sum a_i*m_i)*G + sum (a_i*r_i)*P_i - sum (a_i*s_i)*R_i = 0
+ * in the order P_0, R_0, P_1, R_1, ... The scalar of G is computed upfront. */
+static int secp256k1_ecdsa_verify_batch_ecmult_callback(secp256k1_scalar *sc, secp256k1_ge *pt, size_t idx, void *cbdata) {
+    secp256k1_ecdsa_verify_batch_data *data = (secp256k1_ecdsa_verify_batch_data *)cbdata;
+    size_t i = idx / 2;
+    secp256k1_scalar r, s;
+
+    if (data->randomizer_idx != i - i % 8) {
+        data->randomizer_idx = i - i % 8;
+        secp256k1_batch_randomizers(data->randomizer, data->seed, data->randomizer_idx, data->n_sigs);
+    }
+    secp256k1_ecdsa_signature_load(data->ctx, &r, &s, data->sig[i]);
+
+    if (idx % 2 == 0) {
+        if (!secp256k1_pubkey_load(data->ctx, pt, data->pubkey[i])) {
+            return 0;
+        }
+        secp256k1_scalar_mul(sc, &r, &data->randomizer[i % 8]);
+    } else {
+        if (!secp256k1_ecdsa_sig_lift_r(pt, &r, data->recid[i])) {
+            return 0;
+        }
+        secp256k1_scalar_mul(sc, &s, &data->randomizer[i % 8]);
+        secp256k1_scalar_negate(sc, sc);
+    }
+    return 1;
+}
+
+int secp256k1_ecdsa_verify_batch(const secp256k1_context* ctx, secp256k1_scratch_space *scratch, const secp256k1_ecdsa_signature * const *sig, const unsigned char * const *msghash32, const secp256k1_pubkey * const *pubkey, const int *recid, size_t n_sigs) {
+    secp256k1_ecdsa_verify_batch_data data;
+    secp256k1_sha256 sha;
+    secp256k1_scalar r, s, m, g_sc;
+    secp256k1_ge q;
+    secp256k1_gej rj;
+    size_t i;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(sig != NULL || n_sigs == 0);
+    ARG_CHECK(msghash32 != NULL || n_sigs == 0);
+    ARG_CHECK(pubkey != NULL || n_sigs == 0);
+    /* The ecmult_multi callback addresses 2*n_sigs points. */
+    ARG_CHECK(n_sigs <= SIZE_MAX / 2);
+
+    /* Reject everything that secp256k1_ecdsa_verify rejects without doing any
+     * group operations, and commit to all inputs before deriving the
+     * randomizers. */
+    secp256k1_batch_sha256_tagged(&sha);
+    for (i = 0; i < n_sigs; i++) {
+        ARG_CHECK(sig[i] != NULL);
+        ARG_CHECK(msghash32[i] != NULL);
+        ARG_CHECK(pubkey[i] != NULL);
+        if (recid != NULL) {
+            unsigned char recid_byte;
+            ARG_CHECK(recid[i] >= 0 && recid[i] <= 3);
+            recid_byte = recid[i];
+            secp256k1_sha256_write(&sha, &recid_byte, 1);
+        }
+        secp256k1_ecdsa_signature_load(ctx, &r, &s, sig[i]);
+        if (secp256k1_scalar_is_zero(&r) || secp256k1_scalar_is_zero(&s) || secp256k1_scalar_is_high(&s)) {
+            return 0;
+        }
+        if (!secp256k1_pubkey_load(ctx, &q, pubkey[i])) {
+            return 0;
+        }
+        secp256k1_sha256_write(&sha, sig[i]->data, sizeof(sig[i]->data));
+        secp256k1_sha256_write(&sha, msghash32[i], 32);
+        secp256k1_sha256_write(&sha, pubkey[i]->data, sizeof(pubkey[i]->data));
+    }
+
+    if (recid != NULL) {
+        secp256k1_sha256_finalize(&sha, data.seed);
+        secp256k1_scalar_clear(&g_sc);
+        for (i = 0; i < n_sigs; i++) {
+            if (i % 8 == 0) {
+                secp256k1_batch_randomizers(data.randomizer, data.seed, i, n_sigs);
+            }
+            secp256k1_scalar_set_b32(&m, msghash32[i], NULL);
+            secp256k1_scalar_mul(&m, &m, &data.randomizer[i % 8]);
+            secp256k1_scalar_add(&g_sc, &g_sc, &m);
+        }
+
+        data.ctx = ctx;
+        data.sig = sig;
+        data.pubkey = pubkey;
+        data.recid = recid;
+        data.n_sigs = n_sigs;
+        data.randomizer_idx = SIZE_MAX;
+        if (secp256k1_ecmult_multi_var(&ctx->error_callback, scratch, &rj, &g_sc, secp256k1_ecdsa_verify_batch_ecmult_callback, (void *)&data, 2 * n_sigs)
+            && secp256k1_gej_is_infinity(&rj)) {
+            return 1;
+        }
+    }
+
+    /* Either there are no hints or the batch failed. */
+    for (i = 0; i < n_sigs; i++) {
+        secp256k1_ecdsa_signature_load(ctx, &r, &s, sig[i]);
+        secp256k1_scalar_set_b32(&m, msghash32[i], NULL);
+        secp256k1_pubkey_load(ctx, &q, pubkey[i]);
+        if (!secp256k1_ecdsa_sig_verify(&ctx->ecmult_g, &r, &s, &q, &m)) {
+            return 0;
+        }
+    }
+    return 1;
 }
 
 static SECP256K1_INLINE void buffer_append(unsigned char *buf, unsigned int *offset, const void *data, unsigned int len) {
@@ -480,7 +846,9 @@ static SECP256K1_INLINE void buffer_append(unsigned char *buf, unsigned int *off
     *offset += len;
 }
 
-static int nonce_function_rfc6979(unsigned char *nonce32, const unsigned char *msg32, const unsigned char *key32, const unsigned char *algo16, void *data, unsigned int counter) {
+/* If key_hmac is not NULL, it must be the output of
+ * secp256k1_rfc6979_hmac_sha256_prefix for key32. */
+static int nonce_function_rfc6979_impl(unsigned char *nonce32, const unsigned char *msg32, const unsigned char *key32, const unsigned char *algo16, void *data, unsigned int counter, const secp256k1_hmac_sha256 *key_hmac) {
    unsigned char keydata[112];
    unsigned int offset = 0;
    secp256k1_rfc6979_hmac_sha256 rng;
@@ -505,7 +873,11 @@ static int nonce_function_rfc6979(unsigned char *nonce32, const unsigned char *m
    if (algo16 != NULL) {
        buffer_append(keydata, &offset, algo16, 16);
    }
-   secp256k1_rfc6979_hmac_sha256_initialize(&rng, keydata, offset);
+   if (key_hmac != NULL) {
+       secp256k1_rfc6979_hmac_sha256_initialize_prefixed(&rng, key_hmac, key32, keydata + 32, offset - 32);
+   } else {
+       secp256k1_rfc6979_hmac_sha256_initialize(&rng, keydata, offset);
+   }
    memset(keydata, 0, sizeof(keydata));
    for (i = 0; i <= counter; i++) {
        secp256k1_rfc6979_hmac_sha256_generate(&rng, nonce32, 32);
@@ -514,10 +886,157 @@ static int nonce_function_rfc6979(unsigned char *nonce32, const unsigned char *m
    return 1;
 }
 
+static int nonce_function_rfc6979(unsigned char *nonce32, const unsigned char *msg32, const unsigned char *key32, const unsigned char *algo16, void *data, unsigned int counter) {
+    return nonce_function_rfc6979_impl(nonce32, msg32, key32, algo16, data, counter, NULL);
+}
+
 const secp256k1_nonce_function secp256k1_nonce_function_rfc6979 = nonce_function_rfc6979;
 const secp256k1_nonce_function secp256k1_nonce_function_default = nonce_function_rfc6979;
 
-static int secp256k1_ecdsa_sign_inner(const secp256k1_context* ctx, secp256k1_scalar* r, secp256k1_scalar* s, int* recid, const unsigned char *msg32, const unsigned char *seckey, secp256k1_nonce_function noncefp, const void* noncedata) {
+/* Number of points that share one inversion in secp256k1_ec_pubkey_create_batch
+ * and the functions below that compute many multiples of G. */
+#define SECP256K1_PUBKEY_CREATE_BATCH_SIZE 32
+
+struct secp256k1_sign_pool_struct {
+    /* Generates the nonces; reseeded on every fill. */
+    secp256k1_rfc6979_hmac_sha256 rng;
+    size_t capacity;
+    size_t count;
+    /* nonces[i] and points[i] = nonces[i]*G for i < count. */
+    secp256k1_scalar *nonces;
+    secp256k1_ge_storage *points;
+};
+
+secp256k1_sign_pool *secp256k1_sign_pool_create(const secp256k1_context* ctx, size_t capacity) {
+    const size_t base_size = ROUND_TO_ALIGN(sizeof(secp256k1_sign_pool));
+    const size_t entry_size = sizeof(secp256k1_scalar) + sizeof(secp256k1_ge_storage);
+    static const unsigned char zero_key[32] = { 0 };
+    secp256k1_sign_pool *pool;
+    unsigned char *mem;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(capacity > 0);
+    ARG_CHECK(capacity <= (SIZE_MAX - base_size) / entry_size);
+
+    mem = (unsigned char *)checked_malloc(&ctx->error_callback, base_size + capacity * entry_size);
+    if (mem == NULL) {
+        return NULL;
+    }
+    pool = (secp256k1_sign_pool *)(void *)mem;
+    secp256k1_rfc6979_hmac_sha256_initialize(&pool->rng, zero_key, sizeof(zero_key));
+    pool->capacity = capacity;
+    pool->count = 0;
+    pool->points = (secp256k1_ge_storage *)(void *)(mem + base_size);
+    pool->nonces = (secp256k1_scalar *)(void *)(mem + base_size + capacity * sizeof(secp256k1_ge_storage));
+    return pool;
+}
+
+void secp256k1_sign_pool_destroy(const secp256k1_context* ctx, secp256k1_sign_pool *pool) {
+    VERIFY_CHECK(ctx != NULL);
+    (void)ctx;
+    if (pool != NULL) {
+        memset(pool, 0, ROUND_TO_ALIGN(sizeof(secp256k1_sign_pool)) + pool->capacity * (sizeof(secp256k1_scalar) + sizeof(secp256k1_ge_storage)));
+        free(pool);
+    }
+}
+
+size_t secp256k1_sign_pool_size(const secp256k1_context* ctx, const secp256k1_sign_pool *pool) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pool != NULL);
+    return pool->count;
+}
+
+/* Add the nonces in non[0..n-1] (which must be valid) and their points to the pool. */
+static void secp256k1_sign_pool_push(const secp256k1_context* ctx, secp256k1_sign_pool *pool, const secp256k1_scalar *non, size_t n) {
+    secp256k1_gej pj[SECP256K1_PUBKEY_CREATE_BATCH_SIZE];
+    secp256k1_ge p[SECP256K1_PUBKEY_CREATE_BATCH_SIZE];
+    size_t i;
+
+    VERIFY_CHECK(n <= SECP256K1_PUBKEY_CREATE_BATCH_SIZE);
+    VERIFY_CHECK(pool->count + n <= pool->capacity);
+    for (i = 0; i < n; i++) {
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pj[i], &non[i]);
+    }
+    secp256k1_ge_set_all_gej(p, pj, n);
+    for (i = 0; i < n; i++) {
+        pool->nonces[pool->count] = non[i];
+        secp256k1_ge_to_storage(&pool->points[pool->count], &p[i]);
+        pool->count++;
+    }
+    memset(pj, 0, sizeof(pj));
+    memset(p, 0, sizeof(p));
+}
+
+int secp256k1_sign_pool_fill(const secp256k1_context* ctx, secp256k1_sign_pool *pool, const unsigned char *seed32) {
+    secp256k1_scalar non[SECP256K1_PUBKEY_CREATE_BATCH_SIZE];
+    unsigned char key[64];
+    size_t i, n;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(pool != NULL);
+    ARG_CHECK(seed32 != NULL);
+
+    /* Reseed with both the previous state and the seed, so that the nonces
+     * never repeat even if a seed does. */
+    secp256k1_rfc6979_hmac_sha256_generate(&pool->rng, key, 32);
+    memcpy(key + 32, seed32, 32);
+    secp256k1_rfc6979_hmac_sha256_initialize(&pool->rng, key, sizeof(key));
+    while (pool->count < pool->capacity) {
+        n = pool->capacity - pool->count < SECP256K1_PUBKEY_CREATE_BATCH_SIZE ? pool->capacity - pool->count : SECP256K1_PUBKEY_CREATE_BATCH_SIZE;
+        for (i = 0; i < n; i++) {
+            int is_nonce_valid;
+            do {
+                secp256k1_rfc6979_hmac_sha256_generate(&pool->rng, key, 32);
+                is_nonce_valid = secp256k1_scalar_set_b32_seckey(&non[i], key);
+                /* The nonce is still secret here, but it being invalid is less likely than 1:2^255. */
+                secp256k1_declassify(ctx, &is_nonce_valid, sizeof(is_nonce_valid));
+            } while (!is_nonce_valid);
+        }
+        secp256k1_sign_pool_push(ctx, pool, non, n);
+    }
+    memset(key, 0, sizeof(key));
+    memset(non, 0, sizeof(non));
+    return 1;
+}
+
+int secp256k1_sign_pool_add_nonce(const secp256k1_context* ctx, secp256k1_sign_pool *pool, const unsigned char *nonce32) {
+    secp256k1_scalar non;
+    int ret;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(pool != NULL);
+    ARG_CHECK(nonce32 != NULL);
+
+    ret = secp256k1_scalar_set_b32_seckey(&non, nonce32);
+    secp256k1_declassify(ctx, &ret, sizeof(ret));
+    if (!ret || pool->count == pool->capacity) {
+        secp256k1_scalar_clear(&non);
+        return 0;
+    }
+    secp256k1_sign_pool_push(ctx, pool, &non, 1);
+    secp256k1_scalar_clear(&non);
+    return 1;
+}
+
+/* Remove the last nonce and its point from the pool, clearing the entry.
+ * Returns 0 if the pool is empty. */
+static int secp256k1_sign_pool_take(secp256k1_sign_pool *pool, secp256k1_scalar *non, secp256k1_ge *rp) {
+    if (pool->count == 0) {
+        return 0;
+    }
+    pool->count--;
+    *non = pool->nonces[pool->count];
+    secp256k1_ge_from_storage(rp, &pool->points[pool->count]);
+    secp256k1_scalar_clear(&pool->nonces[pool->count]);
+    memset(&pool->points[pool->count], 0, sizeof(pool->points[pool->count]));
+    return 1;
+}
+
+/* Sign with a nonce from the pool if it is not NULL, and otherwise with nonces
+ * from noncefp. */
+static int secp256k1_ecdsa_sign_inner(const secp256k1_context* ctx, secp256k1_scalar* r, secp256k1_scalar* s, int* recid, const unsigned char *msg32, const unsigned char *seckey, secp256k1_nonce_function noncefp, const void* noncedata, secp256k1_sign_pool *pool) {
     secp256k1_scalar sec, non, msg;
     int ret = 0;
     int is_sec_valid;
@@ -539,6 +1058,20 @@ static int secp256k1_ecdsa_sign_inner(const secp256k1_context* ctx, secp256k1_sc
     secp256k1_scalar_set_b32(&msg, msg32, NULL);
     while (1) {
         int is_nonce_valid;
+        if (pool != NULL) {
+            secp256k1_ge rp;
+            ret = secp256k1_sign_pool_take(pool, &non, &rp);
+            if (!ret) {
+                break;
+            }
+            ret = secp256k1_ecdsa_sig_sign_point(r, s, &sec, &msg, &non, &rp, recid);
+            secp256k1_ge_clear(&rp);
+            secp256k1_declassify(ctx, &ret, sizeof(ret));
+            if (ret) {
+                break;
+            }
+            continue;
+        }
         ret = !!noncefp(nonce32, msg32, seckey, NULL, (void*)noncedata, count);
         if (!ret) {
             break;
@@ -582,7 +1115,21 @@ int secp256k1_ecdsa_sign(const secp256k1_context* ctx, secp256k1_ecdsa_signature
     ARG_CHECK(signature != NULL);
     ARG_CHECK(seckey != NULL);
 
-    ret = secp256k1_ecdsa_sign_inner(ctx, &r, &s, NULL, msghash32, seckey, noncefp, noncedata);
+    ret = secp256k1_ecdsa_sign_inner(ctx, &r, &s, NULL, msghash32, seckey, noncefp, noncedata, NULL);
+    secp256k1_ecdsa_signature_save(signature, &r, &s);
+    return ret;
+}
+
+int secp256k1_ecdsa_sign_pool(const secp256k1_context* ctx, secp256k1_ecdsa_signature *signature, const unsigned char *msghash32, const unsigned char *seckey, secp256k1_sign_pool *pool) {
+    secp256k1_scalar r, s;
+    int ret;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(msghash32 != NULL);
+    ARG_CHECK(signature != NULL);
+    ARG_CHECK(seckey != NULL);
+    ARG_CHECK(pool != NULL);
+
+    ret = secp256k1_ecdsa_sign_inner(ctx, &r, &s, NULL, msghash32, seckey, NULL, NULL, pool);
     secp256k1_ecdsa_signature_save(signature, &r, &s);
     return ret;
 }
@@ -628,6 +1175,191 @@ int secp256k1_ec_pubkey_create(const secp256k1_context* ctx, secp256k1_pubkey *p
     return ret;
 }
 
+int secp256k1_ec_pubkey_create_batch(const secp256k1_context* ctx, secp256k1_pubkey *pubkeys, const unsigned char * const *seckeys, size_t n_keys) {
+    secp256k1_gej pj[SECP256K1_PUBKEY_CREATE_BATCH_SIZE];
+    secp256k1_ge p[SECP256K1_PUBKEY_CREATE_BATCH_SIZE];
+    int valid[SECP256K1_PUBKEY_CREATE_BATCH_SIZE];
+    secp256k1_scalar seckey_scalars[4];
+    size_t i, j, k, n;
+    int ret = 1;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(n_keys == 0 || pubkeys != NULL);
+    if (n_keys > 0) {
+        memset(pubkeys, 0, n_keys * sizeof(*pubkeys));
+    }
+    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(n_keys == 0 || seckeys != NULL);
+    for (i = 0; i < n_keys; i++) {
+        ARG_CHECK(seckeys[i] != NULL);
+    }
+
+    for (i = 0; i < n_keys; i += n) {
+        n = n_keys - i < SECP256K1_PUBKEY_CREATE_BATCH_SIZE ? n_keys - i : SECP256K1_PUBKEY_CREATE_BATCH_SIZE;
+        j = 0;
+#ifdef SECP256K1_FE_X4
+        for (; j + 4 <= n; j += 4) {
+            for (k = 0; k < 4; k++) {
+                valid[j + k] = secp256k1_scalar_set_b32_seckey(&seckey_scalars[k], seckeys[i + j + k]);
+                secp256k1_scalar_cmov(&seckey_scalars[k], &secp256k1_scalar_one, !valid[j + k]);
+            }
+            secp256k1_ecmult_gen_x4(&ctx->ecmult_gen_ctx, &pj[j], seckey_scalars);
+        }
+#endif
+        for (; j < n; j++) {
+            valid[j] = secp256k1_scalar_set_b32_seckey(&seckey_scalars[0], seckeys[i + j]);
+            secp256k1_scalar_cmov(&seckey_scalars[0], &secp256k1_scalar_one, !valid[j]);
+            secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pj[j], &seckey_scalars[0]);
+        }
+        secp256k1_ge_set_all_gej(p, pj, n);
+        for (j = 0; j < n; j++) {
+            secp256k1_pubkey_save(&pubkeys[i + j], &p[j]);
+            secp256k1_memczero(&pubkeys[i + j], sizeof(pubkeys[i + j]), !valid[j]);
+            ret &= valid[j];
+        }
+    }
+
+    for (k = 0; k < 4; k++) {
+        secp256k1_scalar_clear(&seckey_scalars[k]);
+    }
+    return ret;
+}
+
+int secp256k1_ec_pubkey_create_sequence(const secp256k1_context* ctx, secp256k1_pubkey *pubkeys, const unsigned char *seckey, const unsigned char *step32, size_t n_keys) {
+    secp256k1_gej pj[SECP256K1_PUBKEY_CREATE_BATCH_SIZE];
+    secp256k1_ge p[SECP256K1_PUBKEY_CREATE_BATCH_SIZE];
+    int valid[SECP256K1_PUBKEY_CREATE_BATCH_SIZE];
+    secp256k1_scalar k, step;
+    secp256k1_gej acc, gj;
+    secp256k1_ge step_ge;
+    size_t i, j, n;
+    int ret, all_valid = 1;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(n_keys == 0 || pubkeys != NULL);
+    if (n_keys > 0) {
+        memset(pubkeys, 0, n_keys * sizeof(*pubkeys));
+    }
+    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(seckey != NULL);
+
+    ret = secp256k1_scalar_set_b32_seckey(&k, seckey);
+    secp256k1_scalar_cmov(&k, &secp256k1_scalar_one, !ret);
+    step = secp256k1_scalar_one;
+    if (step32 != NULL) {
+        int step_valid = secp256k1_scalar_set_b32_seckey(&step, step32);
+        secp256k1_scalar_cmov(&step, &secp256k1_scalar_one, !step_valid);
+        ret &= step_valid;
+    }
+    secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &gj, &step);
+    secp256k1_ge_set_gej(&step_ge, &gj);
+    secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &acc, &k);
+    /* gj is substituted for the (infinite) points of zero keys, which have no
+     * affine coordinates. */
+    secp256k1_gej_set_ge(&gj, &secp256k1_ge_const_g);
+
+    for (i = 0; i < n_keys; i += n) {
+        n = n_keys - i < SECP256K1_PUBKEY_CREATE_BATCH_SIZE ? n_keys - i : SECP256K1_PUBKEY_CREATE_BATCH_SIZE;
+        for (j = 0; j < n; j++) {
+            /* Here acc = k*G. */
+            valid[j] = ret & !secp256k1_scalar_is_zero(&k);
+            pj[j] = acc;
+            secp256k1_gej_cmov(&pj[j], &gj, !valid[j]);
+            secp256k1_gej_add_ge(&acc, &acc, &step_ge);
+            secp256k1_scalar_add(&k, &k, &step);
+        }
+        secp256k1_ge_set_all_gej(p, pj, n);
+        for (j = 0; j < n; j++) {
+            secp256k1_pubkey_save(&pubkeys[i + j], &p[j]);
+            secp256k1_memczero(&pubkeys[i + j], sizeof(pubkeys[i + j]), !valid[j]);
+            all_valid &= valid[j];
+        }
+    }
+
+    secp256k1_scalar_clear(&k);
+    secp256k1_scalar_clear(&step);
+    secp256k1_gej_clear(&acc);
+    return ret & all_valid;
+}
+
+struct secp256k1_signer_struct {
+    unsigned char seckey[32];
+    /* The state of the first HMAC of the RFC6979 nonce derivation after seckey. */
+    secp256k1_hmac_sha256 rfc6979_key_hmac;
+    /* For Schnorr signatures: the secret key, negated if its public key has an
+     * odd Y coordinate, its serialization, and the x-only public key. */
+    secp256k1_scalar sk_even;
+    unsigned char seckey_even[32];
+    unsigned char xonly_pk[32];
+};
+
+typedef struct {
+    const secp256k1_signer *signer;
+    const unsigned char *ndata32;
+} secp256k1_signer_nonce_data;
+
+static int secp256k1_signer_nonce_function(unsigned char *nonce32, const unsigned char *msg32, const unsigned char *key32, const unsigned char *algo16, void *data, unsigned int counter) {
+    const secp256k1_signer_nonce_data *nd = (const secp256k1_signer_nonce_data *)data;
+    return nonce_function_rfc6979_impl(nonce32, msg32, key32, algo16, (void *)nd->ndata32, counter, &nd->signer->rfc6979_key_hmac);
+}
+
+secp256k1_signer *secp256k1_signer_create(const secp256k1_context* ctx, const unsigned char *seckey) {
+    secp256k1_signer *signer;
+    secp256k1_scalar sec;
+    secp256k1_ge p;
+    int ret;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(seckey != NULL);
+
+    ret = secp256k1_ec_pubkey_create_helper(&ctx->ecmult_gen_ctx, &sec, &p, seckey);
+    secp256k1_declassify(ctx, &ret, sizeof(ret));
+    if (!ret) {
+        secp256k1_scalar_clear(&sec);
+        return NULL;
+    }
+    signer = (secp256k1_signer *)checked_malloc(&ctx->error_callback, sizeof(*signer));
+    if (signer == NULL) {
+        secp256k1_scalar_clear(&sec);
+        return NULL;
+    }
+    memcpy(signer->seckey, seckey, 32);
+    secp256k1_rfc6979_hmac_sha256_prefix(&signer->rfc6979_key_hmac, seckey);
+    secp256k1_fe_normalize(&p.x);
+    secp256k1_fe_normalize(&p.y);
+    secp256k1_scalar_cond_negate(&sec, secp256k1_fe_is_odd(&p.y));
+    signer->sk_even = sec;
+    secp256k1_scalar_get_b32(signer->seckey_even, &sec);
+    secp256k1_fe_get_b32(signer->xonly_pk, &p.x);
+    secp256k1_scalar_clear(&sec);
+    return signer;
+}
+
+void secp256k1_signer_destroy(const secp256k1_context* ctx, secp256k1_signer *signer) {
+    VERIFY_CHECK(ctx != NULL);
+    (void)ctx;
+    if (signer != NULL) {
+        memset(signer, 0, sizeof(*signer));
+        free(signer);
+    }
+}
+
+int secp256k1_ecdsa_sign_signer(const secp256k1_context* ctx, secp256k1_ecdsa_signature *signature, const unsigned char *msghash32, const secp256k1_signer *signer, const unsigned char *ndata32) {
+    secp256k1_scalar r, s;
+    secp256k1_signer_nonce_data nd;
+    int ret;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+    ARG_CHECK(msghash32 != NULL);
+    ARG_CHECK(signature != NULL);
+    ARG_CHECK(signer != NULL);
+
+    nd.signer = signer;
+    nd.ndata32 = ndata32;
+    ret = secp256k1_ecdsa_sign_inner(ctx, &r, &s, NULL, msghash32, signer->seckey, secp256k1_signer_nonce_function, &nd, NULL);
+    secp256k1_ecdsa_signature_save(signature, &r, &s);
+    return ret;
+}
+
 int secp256k1_ec_seckey_negate(const secp256k1_context* ctx, unsigned char *seckey) {
     secp256k1_scalar sec;
     int ret = 0;
@@ -801,6 +1533,258 @@ int secp256k1_ec_pubkey_combine(const secp256k1_context* ctx, secp256k1_pubkey *
     return 1;
 }
 
+typedef struct {
+    const secp256k1_context *ctx;
+    secp256k1_ecmult_multi_pubkey_callback callback;
+    void *data;
+} secp256k1_ecmult_multi_data;
+
+static int secp256k1_ecmult_multi_pubkey_ecmult_callback(secp256k1_scalar *sc, secp256k1_ge *pt, size_t idx, void *cbdata) {
+    const secp256k1_ecmult_multi_data *data = (const secp256k1_ecmult_multi_data *)cbdata;
+    unsigned char scalar32[32];
+    secp256k1_pubkey pubkey;
+    int overflow;
+
+    if (!data->callback(scalar32, &pubkey, idx, data->data)) {
+        return 0;
+    }
+    secp256k1_scalar_set_b32(sc, scalar32, &overflow);
+    if (overflow) {
+        return 0;
+    }
+    return secp256k1_pubkey_load(data->ctx, pt, &pubkey);
+}
+
+int secp256k1_ecmult_multi(const secp256k1_context* ctx, secp256k1_scratch_space *scratch, secp256k1_pubkey *pubkey, const unsigned char *g_scalar32, secp256k1_ecmult_multi_pubkey_callback callback, void *data, size_t n) {
+    secp256k1_ecmult_multi_data cbdata;
+    secp256k1_scalar g_sc;
+    secp256k1_gej rj;
+    secp256k1_ge r;
+    int overflow = 0;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(pubkey != NULL);
+    memset(pubkey, 0, sizeof(*pubkey));
+    ARG_CHECK(callback != NULL || n == 0);
+
+    if (g_scalar32 != NULL) {
+        secp256k1_scalar_set_b32(&g_sc, g_scalar32, &overflow);
+        if (overflow) {
+            return 0;
+        }
+    }
+    cbdata.ctx = ctx;
+    cbdata.callback = callback;
+    cbdata.data = data;
+    if (!secp256k1_ecmult_multi_var(&ctx->error_callback, scratch, &rj, g_scalar32 != NULL ? &g_sc : NULL, secp256k1_ecmult_multi_pubkey_ecmult_callback, (void *)&cbdata, n)) {
+        return 0;
+    }
+    if (secp256k1_gej_is_infinity(&rj)) {
+        return 0;
+    }
+    secp256k1_ge_set_gej_var(&r, &rj);
+    secp256k1_pubkey_save(pubkey, &r);
+    return 1;
+}
+
+void secp256k1_ecmult_multi_tuning_default(const secp256k1_context* ctx, secp256k1_ecmult_multi_tuning *tuning) {
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK_VOID(tuning != NULL);
+    secp256k1_ecmult_multi_tuning_init(tuning);
+}
+
+/* Number of timing measurements of which the fastest is used. */
+#define SECP256K1_CALIBRATE_REPS 3
+/* The threshold search stops after Pippenger's algorithm was faster for this
+ * many consecutive batch sizes. */
+#define SECP256K1_CALIBRATE_PIPPENGER_WINS 3
+
+typedef struct {
+    const secp256k1_context *ctx;
+    secp256k1_scratch *scratch;
+    secp256k1_scalar g_sc;
+    secp256k1_scalar *sc;
+    secp256k1_ge *pt;
+    /* Minimum number of points multiplied per measurement, which keeps
+     * measurements of small batches from being dominated by timer noise. */
+    size_t min_points;
+    secp256k1_timer_function timer;
+    void *timer_data;
+} secp256k1_ecmult_multi_calibrate_data;
+
+static int secp256k1_ecmult_multi_calibrate_callback(secp256k1_scalar *sc, secp256k1_ge *pt, size_t idx, void *cbdata) {
+    const secp256k1_ecmult_multi_calibrate_data *data = (const secp256k1_ecmult_multi_calibrate_data *)cbdata;
+    *sc = data->sc[idx];
+    *pt = data->pt[idx];
+    return 1;
+}
+
+/* Returns the time taken by f for n points. */
+static double secp256k1_ecmult_multi_calibrate_time(secp256k1_ecmult_multi_calibrate_data *data, secp256k1_ecmult_multi_func f, size_t n) {
+    size_t iters = 1 + data->min_points / n;
+    double best = 0;
+    int rep;
+
+    for (rep = 0; rep < SECP256K1_CALIBRATE_REPS; rep++) {
+        double begin = data->timer(data->timer_data);
+        double t;
+        size_t i;
+
+        for (i = 0; i < iters; i++) {
+            secp256k1_gej r;
+            int ret = f(&data->ctx->error_callback, data->scratch, &r, &data->g_sc, secp256k1_ecmult_multi_calibrate_callback, data, n);
+            (void)ret;
+            VERIFY_CHECK(ret);
+        }
+        t = (data->timer(data->timer_data) - begin) / (double)iters;
+        if (rep == 0 || t < best) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+/* Sets the tuning of the scratch space such that Pippenger's algorithm uses
+ * the given bucket window for any number of points. */
+static void secp256k1_ecmult_multi_calibrate_force_window(secp256k1_ecmult_multi_calibrate_data *data, int bucket_window) {
+    secp256k1_ecmult_multi_tuning tuning;
+    int i;
+
+    secp256k1_ecmult_multi_tuning_init(&tuning);
+    for (i = 1; i < PIPPENGER_MAX_BUCKET_WINDOW; i++) {
+        tuning.bucket_window_max_points[i - 1] = i < bucket_window ? 0 : SIZE_MAX;
+    }
+    secp256k1_scratch_set_tuning(&data->ctx->error_callback, data->scratch, &tuning);
+}
+
+int secp256k1_ecmult_multi_calibrate(const secp256k1_context* ctx, secp256k1_ecmult_multi_tuning *tuning, size_t max_points, secp256k1_timer_function timer, void *timer_data) {
+    secp256k1_ecmult_multi_calibrate_data data;
+    /* Batch sizes to measure, growing by a factor of about 1.5 (which takes
+     * fewer than 64 steps up to ECMULT_MAX_POINTS_PER_BATCH). */
+    size_t grid[64];
+    int best_window[64];
+    size_t n_grid = 0;
+    size_t scratch_size;
+    size_t i;
+    int bucket_window;
+    int pippenger_wins;
+    secp256k1_gej *ptj;
+    secp256k1_gej base;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(tuning != NULL);
+    secp256k1_ecmult_multi_tuning_init(tuning);
+    ARG_CHECK(max_points >= 1 && max_points <= ECMULT_MAX_POINTS_PER_BATCH);
+    ARG_CHECK(timer != NULL);
+
+    for (i = 1; i < max_points; i += (i + 1)/2) {
+        grid[n_grid++] = i;
+    }
+    grid[n_grid++] = max_points;
+
+    /* Use pseudorandom scalars and distinct points. */
+    data.ctx = ctx;
+    data.min_points = max_points / 4;
+    data.timer = timer;
+    data.timer_data = timer_data;
+    data.sc = (secp256k1_scalar *)checked_malloc(&ctx->error_callback, max_points * sizeof(*data.sc));
+    data.pt = (secp256k1_ge *)checked_malloc(&ctx->error_callback, max_points * sizeof(*data.pt));
+    ptj = (secp256k1_gej *)checked_malloc(&ctx->error_callback, max_points * sizeof(*ptj));
+    scratch_size = secp256k1_strauss_scratch_size(max_points) + STRAUSS_SCRATCH_OBJECTS*ALIGNMENT;
+    for (bucket_window = 1; bucket_window <= PIPPENGER_MAX_BUCKET_WINDOW; bucket_window++) {
+        size_t size = secp256k1_pippenger_scratch_size(max_points, bucket_window, 1) + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT;
+        scratch_size = size > scratch_size ? size : scratch_size;
+    }
+    data.scratch = secp256k1_scratch_create(&ctx->error_callback, scratch_size);
+    if (data.sc == NULL || data.pt == NULL || ptj == NULL || data.scratch == NULL) {
+        free(data.sc);
+        free(data.pt);
+        free(ptj);
+        secp256k1_scratch_destroy(&ctx->error_callback, data.scratch);
+        return 0;
+    }
+    secp256k1_scalar_set_int(&data.g_sc, 1);
+    secp256k1_gej_set_ge(&base, &secp256k1_ge_const_g);
+    for (i = 0; i < max_points; i++) {
+        secp256k1_sha256 sha;
+        unsigned char buf[32];
+
+        secp256k1_sha256_initialize(&sha);
+        secp256k1_write_be64(buf, i);
+        secp256k1_sha256_write(&sha, buf, 8);
+        secp256k1_sha256_finalize(&sha, buf);
+        secp256k1_scalar_set_b32(&data.sc[i], buf, NULL);
+        secp256k1_gej_double_var(&base, &base, NULL);
+        secp256k1_gej_add_ge_var(&ptj[i], &base, &secp256k1_ge_const_g, NULL);
+    }
+    secp256k1_ge_set_all_gej_var(data.pt, ptj, max_points);
+    free(ptj);
+
+    /* Find the fastest bucket window around the default for every batch
+     * size. The windows must not decrease with the batch size. */
+    for (i = 0; i < n_grid; i++) {
+        int default_window = secp256k1_pippenger_bucket_window(grid[i]);
+        double best = 0;
+
+        best_window[i] = 0;
+        for (bucket_window = default_window - 2; bucket_window <= default_window + 2; bucket_window++) {
+            double t;
+            if (bucket_window < 1 || bucket_window > PIPPENGER_MAX_BUCKET_WINDOW) {
+                continue;
+            }
+            secp256k1_ecmult_multi_calibrate_force_window(&data, bucket_window);
+            t = secp256k1_ecmult_multi_calibrate_time(&data, secp256k1_ecmult_pippenger_batch_single, grid[i]);
+            if (best_window[i] == 0 || t < best) {
+                best = t;
+                best_window[i] = bucket_window;
+            }
+        }
+        if (i > 0 && best_window[i] < best_window[i - 1]) {
+            best_window[i] = best_window[i - 1];
+        }
+    }
+    for (bucket_window = 1; bucket_window < PIPPENGER_MAX_BUCKET_WINDOW; bucket_window++) {
+        size_t *max = &tuning->bucket_window_max_points[bucket_window - 1];
+        if (best_window[n_grid - 1] <= bucket_window) {
+            /* Beyond the measured batch sizes, keep the default. */
+            *max = *max > max_points ? *max : max_points;
+        } else {
+            *max = 0;
+            for (i = 0; i < n_grid && best_window[i] <= bucket_window; i++) {
+                *max = grid[i];
+            }
+        }
+    }
+    VERIFY_CHECK(secp256k1_ecmult_multi_tuning_is_valid(tuning));
+
+    /* Find the smallest batch size from which on Pippenger's algorithm (with
+     * the bucket windows found above) is faster than Strauss' algorithm. */
+    secp256k1_scratch_set_tuning(&ctx->error_callback, data.scratch, tuning);
+    tuning->pippenger_threshold = 0;
+    pippenger_wins = 0;
+    for (i = 0; i < n_grid && pippenger_wins < SECP256K1_CALIBRATE_PIPPENGER_WINS; i++) {
+        double t_pippenger = secp256k1_ecmult_multi_calibrate_time(&data, secp256k1_ecmult_pippenger_batch_single, grid[i]);
+        double t_strauss = secp256k1_ecmult_multi_calibrate_time(&data, secp256k1_ecmult_strauss_batch_single, grid[i]);
+        if (t_pippenger < t_strauss) {
+            if (pippenger_wins == 0) {
+                tuning->pippenger_threshold = grid[i];
+            }
+            pippenger_wins++;
+        } else {
+            pippenger_wins = 0;
+        }
+    }
+    if (pippenger_wins == 0) {
+        /* Strauss' algorithm was faster for the largest measured batch size. */
+        tuning->pippenger_threshold = ECMULT_PIPPENGER_THRESHOLD > max_points ? ECMULT_PIPPENGER_THRESHOLD : max_points + 1;
+    }
+
+    secp256k1_scratch_destroy(&ctx->error_callback, data.scratch);
+    free(data.sc);
+    free(data.pt);
+    return 1;
+}
+
 int secp256k1_tagged_sha256(const secp256k1_context* ctx, unsigned char *hash32, const unsigned char *tag, size_t taglen, const unsigned char *msg, size_t msglen) {
     secp256k1_sha256 sha;
     VERIFY_CHECK(ctx != NULL);
@@ -814,6 +1798,38 @@ int secp256k1_tagged_sha256(const secp256k1_context* ctx, unsigned char *hash32,
     return 1;
 }
 
+int secp256k1_tagged_hasher_create(const secp256k1_context* ctx, secp256k1_tagged_hasher *hasher, const unsigned char *tag, size_t taglen) {
+    secp256k1_sha256 sha;
+    int i;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(hasher != NULL);
+    ARG_CHECK(tag != NULL);
+
+    secp256k1_sha256_initialize_tagged(&sha, tag, taglen);
+    VERIFY_CHECK(sha.bytes == 64);
+    for (i = 0; i < 8; i++) {
+        secp256k1_write_be32(&hasher->data[4*i], sha.s[i]);
+    }
+    return 1;
+}
+
+int secp256k1_tagged_hasher_sha256(const secp256k1_context* ctx, unsigned char *hash32, const secp256k1_tagged_hasher *hasher, const unsigned char *msg, size_t msglen) {
+    secp256k1_sha256 sha;
+    int i;
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(hash32 != NULL);
+    ARG_CHECK(hasher != NULL);
+    ARG_CHECK(msg != NULL);
+
+    for (i = 0; i < 8; i++) {
+        sha.s[i] = secp256k1_read_be32(&hasher->data[4*i]);
+    }
+    sha.bytes = 64;
+    secp256k1_sha256_write(&sha, msg, msglen);
+    secp256k1_sha256_finalize(&sha, hash32);
+    return 1;
+}
+
 #ifdef ENABLE_MODULE_ECDH
 # include "modules/ecdh/main_impl.h"
 #endif
@@ -833,3 +1849,7 @@ int secp256k1_tagged_sha256(const secp256k1_context* ctx, unsigned char *hash32,
 #ifdef ENABLE_MODULE_ELLSWIFT
 # include "modules/ellswift/main_impl.h"
 #endif
+
+#ifdef ENABLE_MODULE_BATCH
+# include "modules/batch/main_impl.h"
+#endif
@@ -11,6 +11,24 @@
 
 #include <string.h>
 
+/* Check a SHA-256 transform function on the two padded blocks of input63. */
+static int secp256k1_selftest_sha256_transform(void (*transform)(uint32_t *s, const unsigned char *buf), const char *input63, const unsigned char *output32) {
+    unsigned char blocks[128] = {0};
+    unsigned char out[32];
+    secp256k1_sha256 hasher;
+    int i;
+    memcpy(blocks, input63, 63);
+    blocks[63] = 0x80;
+    secp256k1_write_be32(&blocks[124], 63 * 8);
+    secp256k1_sha256_initialize(&hasher);
+    transform(hasher.s, &blocks[0]);
+    transform(hasher.s, &blocks[64]);
+    for (i = 0; i < 8; i++) {
+        secp256k1_write_be32(&out[4*i], hasher.s[i]);
+    }
+    return secp256k1_memcmp_var(out, output32, 32) == 0;
+}
+
 static int secp256k1_selftest_sha256(void) {
     static const char *input63 = "For this sample, this 63-byte string will be used as input data";
     static const unsigned char output32[32] = {
@@ -19,10 +37,17 @@ static int secp256k1_selftest_sha256(void) {
     };
     unsigned char out[32];
     secp256k1_sha256 hasher;
+    int ret;
     secp256k1_sha256_initialize(&hasher);
     secp256k1_sha256_write(&hasher, (const unsigned char*)input63, 63);
     secp256k1_sha256_finalize(&hasher, out);
-    return secp256k1_memcmp_var(out, output32, 32) == 0;
+    ret = secp256k1_memcmp_var(out, output32, 32) == 0;
+    /* Check every compiled transform, also those the hasher does not use. */
+    ret &= secp256k1_selftest_sha256_transform(secp256k1_sha256_transform_portable, input63, output32);
+#ifdef SECP256K1_SHA256_SHANI
+    ret &= secp256k1_selftest_sha256_transform(secp256k1_sha256_transform_shani, input63, output32);
+#endif
+    return ret;
 }
 
 static int secp256k1_selftest_passes(void) {
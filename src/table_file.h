@@ -0,0 +1,67 @@
+/***********************************************************************
+ * Distributed under the MIT software license, see the accompanying    *
+ * file COPYING or https://www.opensource.org/licenses/mit-license.php.*
+ ***********************************************************************/
+
+#ifndef SECP256K1_TABLE_FILE_H
+#define SECP256K1_TABLE_FILE_H
+
+#include <stddef.h>
+
+#include "group.h"
+#include "ecmult.h"
+
+/* Format of files with precomputed tables, as written by precompute_ecmult and
+ * used by secp256k1_context_set_ecmult_tables.
+ *
+ * A file is a header of SECP256K1_TABLE_FILE_HEADER_SIZE bytes followed by the
+ * payload. Integers are in native byte order and table entries are in the
+ * in-memory representation of secp256k1_ge_storage, so that a file can be used
+ * in place from a read-only mmap. The header consists of (offsets in bytes):
+ *
+ *    0  magic "SECPTBLS"
+ *    8  uint32_t format version (SECP256K1_TABLE_FILE_VERSION)
+ *   12  uint32_t byte order mark 0x01020304
+ *   16  uint32_t sizeof(secp256k1_ge_storage)
+ *   20  uint32_t number of bits per limb of secp256k1_fe_storage
+ *   24  uint32_t window size of the G tables (0 if there are none)
+ *   28  uint32_t number of comb blocks (0 if there is no comb table)
+ *   32  uint32_t number of comb teeth (0 if there is no comb table)
+ *   36  uint32_t zero
+ *   40  uint64_t payload length in bytes
+ *   48  SHA256 of the payload
+ *   80  16 zero bytes
+ *   96  SHA256 of bytes 0 to 95 (the header hash)
+ *
+ * The payload consists of the odd multiples of G and of 2^128*G in the layout
+ * of secp256k1_pre_g and secp256k1_pre_g_128, followed by the comb table in
+ * the layout of secp256k1_ecmult_gen_prec_table.
+ */
+#define SECP256K1_TABLE_FILE_HEADER_SIZE 128
+#define SECP256K1_TABLE_FILE_VERSION 1
+
+typedef struct {
+    /* window_g is 0 if there are no G tables. */
+    secp256k1_ecmult_g_tables g;
+    /* NULL if there is no comb table. */
+    const secp256k1_ge_storage *comb;
+    int comb_blocks;
+    int comb_teeth;
+} secp256k1_table_file;
+
+/** Return the payload length of a file with the given tables. */
+static size_t secp256k1_table_file_payload_len(int window_g, int comb_blocks, int comb_teeth);
+
+/** Write the header of a file with the given tables and payload. */
+static void secp256k1_table_file_write_header(unsigned char *header, int window_g, int comb_blocks, int comb_teeth, const unsigned char *payload, size_t payload_len);
+
+/** Check the header of a file of len bytes and point tf at its tables. Only
+ *  the header (including the header hash) is read; the payload is not. Returns
+ *  0 if the header is invalid or the file was not written for this build. */
+static int secp256k1_table_file_load(secp256k1_table_file *tf, const unsigned char *data, size_t len);
+
+/** Check the payload hash of a file whose header was accepted by
+ *  secp256k1_table_file_load. Reads the entire payload. */
+static int secp256k1_table_file_check_payload(const unsigned char *data, size_t len);
+
+#endif /* SECP256K1_TABLE_FILE_H */
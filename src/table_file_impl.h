@@ -0,0 +1,131 @@
+/***********************************************************************
+ * Distributed under the MIT software license, see the accompanying    *
+ * file COPYING or https://www.opensource.org/licenses/mit-license.php.*
+ ***********************************************************************/
+
+#ifndef SECP256K1_TABLE_FILE_IMPL_H
+#define SECP256K1_TABLE_FILE_IMPL_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "table_file.h"
+#include "ecmult.h"
+#include "ecmult_gen.h"
+#include "ecmult_gen_compute_table_impl.h"
+#include "field.h"
+#include "hash_impl.h"
+#include "util.h"
+
+static const unsigned char secp256k1_table_file_magic[8] = { 'S', 'E', 'C', 'P', 'T', 'B', 'L', 'S' };
+
+static size_t secp256k1_table_file_payload_len(int window_g, int comb_blocks, int comb_teeth) {
+    size_t n = 0;
+    if (window_g > 0) {
+        n += 2 * ECMULT_TABLE_SIZE(window_g);
+    }
+    if (comb_blocks > 0) {
+        n += (size_t)comb_blocks << (comb_teeth - 1);
+    }
+    return n * sizeof(secp256k1_ge_storage);
+}
+
+static void secp256k1_table_file_header_fields(uint32_t *fields, int window_g, int comb_blocks, int comb_teeth) {
+    fields[0] = SECP256K1_TABLE_FILE_VERSION;
+    fields[1] = 0x01020304;
+    fields[2] = sizeof(secp256k1_ge_storage);
+    fields[3] = 8 * sizeof(((secp256k1_fe_storage *)NULL)->n[0]);
+    fields[4] = window_g;
+    fields[5] = comb_blocks;
+    fields[6] = comb_teeth;
+    fields[7] = 0;
+}
+
+static void secp256k1_table_file_header_hash(unsigned char *hash32, const unsigned char *header) {
+    secp256k1_sha256 sha;
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, header, 96);
+    secp256k1_sha256_finalize(&sha, hash32);
+}
+
+static void secp256k1_table_file_write_header(unsigned char *header, int window_g, int comb_blocks, int comb_teeth, const unsigned char *payload, size_t payload_len) {
+    uint32_t fields[8];
+    uint64_t len64 = payload_len;
+    secp256k1_sha256 sha;
+
+    VERIFY_CHECK(payload_len == secp256k1_table_file_payload_len(window_g, comb_blocks, comb_teeth));
+    memset(header, 0, SECP256K1_TABLE_FILE_HEADER_SIZE);
+    memcpy(header, secp256k1_table_file_magic, sizeof(secp256k1_table_file_magic));
+    secp256k1_table_file_header_fields(fields, window_g, comb_blocks, comb_teeth);
+    memcpy(header + 8, fields, sizeof(fields));
+    memcpy(header + 40, &len64, sizeof(len64));
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, payload, payload_len);
+    secp256k1_sha256_finalize(&sha, header + 48);
+    secp256k1_table_file_header_hash(header + 96, header);
+}
+
+static int secp256k1_table_file_load(secp256k1_table_file *tf, const unsigned char *data, size_t len) {
+    uint32_t fields[8], expected[8];
+    uint64_t len64;
+    unsigned char hash[32];
+    const secp256k1_ge_storage *tables;
+    int window_g, comb_blocks, comb_teeth;
+    size_t n_g;
+
+    if (len < SECP256K1_TABLE_FILE_HEADER_SIZE
+        || secp256k1_memcmp_var(data, secp256k1_table_file_magic, sizeof(secp256k1_table_file_magic)) != 0) {
+        return 0;
+    }
+    secp256k1_table_file_header_hash(hash, data);
+    if (secp256k1_memcmp_var(hash, data + 96, sizeof(hash)) != 0) {
+        return 0;
+    }
+
+    memcpy(fields, data + 8, sizeof(fields));
+    memcpy(&len64, data + 40, sizeof(len64));
+    window_g = fields[4];
+    comb_blocks = fields[5];
+    comb_teeth = fields[6];
+    if (fields[4] != 0 && (fields[4] < 2 || fields[4] > 24)) {
+        return 0;
+    }
+    if (fields[5] != 0 && (fields[5] > 256 || fields[6] > 8 || !secp256k1_ecmult_gen_comb_params_valid(comb_blocks, comb_teeth))) {
+        return 0;
+    }
+    if ((fields[4] == 0 && fields[5] == 0) || (fields[5] == 0 && fields[6] != 0)) {
+        return 0;
+    }
+    /* Check the version, byte order, and representation of the entries. */
+    secp256k1_table_file_header_fields(expected, window_g, comb_blocks, comb_teeth);
+    if (secp256k1_memcmp_var(fields, expected, sizeof(fields)) != 0) {
+        return 0;
+    }
+    if (len64 != len - SECP256K1_TABLE_FILE_HEADER_SIZE
+        || len64 != secp256k1_table_file_payload_len(window_g, comb_blocks, comb_teeth)) {
+        return 0;
+    }
+
+    tables = (const secp256k1_ge_storage *)(const void *)(data + SECP256K1_TABLE_FILE_HEADER_SIZE);
+    n_g = window_g > 0 ? ECMULT_TABLE_SIZE(window_g) : 0;
+    tf->g.pre_g = window_g > 0 ? tables : NULL;
+    tf->g.pre_g_128 = window_g > 0 ? tables + n_g : NULL;
+    tf->g.window_g = window_g;
+    tf->comb = comb_blocks > 0 ? tables + 2 * n_g : NULL;
+    tf->comb_blocks = comb_blocks;
+    tf->comb_teeth = comb_teeth;
+    return 1;
+}
+
+static int secp256k1_table_file_check_payload(const unsigned char *data, size_t len) {
+    secp256k1_sha256 sha;
+    unsigned char hash[32];
+
+    VERIFY_CHECK(len >= SECP256K1_TABLE_FILE_HEADER_SIZE);
+    secp256k1_sha256_initialize(&sha);
+    secp256k1_sha256_write(&sha, data + SECP256K1_TABLE_FILE_HEADER_SIZE, len - SECP256K1_TABLE_FILE_HEADER_SIZE);
+    secp256k1_sha256_finalize(&sha, hash);
+    return secp256k1_memcmp_var(hash, data + 48, sizeof(hash)) == 0;
+}
+
+#endif /* SECP256K1_TABLE_FILE_IMPL_H */
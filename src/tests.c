@@ -26,6 +26,8 @@
 #include "testutil.h"
 #include "util.h"
 
+#include "ecmult_compute_table_impl.h"
+
 #include "../contrib/lax_der_parsing.c"
 #include "../contrib/lax_der_privatekey_parsing.c"
 
@@ -248,6 +250,10 @@ static void run_selftest_tests(void) {
 
 static int ecmult_gen_context_eq(const secp256k1_ecmult_gen_context *a, const secp256k1_ecmult_gen_context *b) {
     return a->built == b->built
+            && a->prec == b->prec
+            && a->blocks == b->blocks
+            && a->teeth == b->teeth
+            && a->spacing == b->spacing
             && secp256k1_scalar_eq(&a->scalar_offset, &b->scalar_offset)
             && secp256k1_ge_eq_var(&a->ge_offset, &b->ge_offset)
             && secp256k1_fe_equal(&a->proj_blind, &b->proj_blind);
@@ -255,7 +261,11 @@ static int ecmult_gen_context_eq(const secp256k1_ecmult_gen_context *a, const se
 
 static int context_eq(const secp256k1_context *a, const secp256k1_context *b) {
     return a->declassify == b->declassify
+            && a->ecmult_gen_flags == b->ecmult_gen_flags
             && ecmult_gen_context_eq(&a->ecmult_gen_ctx, &b->ecmult_gen_ctx)
+            && a->ecmult_g.pre_g == b->ecmult_g.pre_g
+            && a->ecmult_g.pre_g_128 == b->ecmult_g.pre_g_128
+            && a->ecmult_g.window_g == b->ecmult_g.window_g
             && a->illegal_callback.fn == b->illegal_callback.fn
             && a->illegal_callback.data == b->illegal_callback.data
             && a->error_callback.fn == b->error_callback.fn
@@ -280,6 +290,200 @@ static void run_deprecated_context_flags_test(void) {
     secp256k1_context_destroy(none_ctx);
 }
 
+/* Allocates a table file with G tables for the given window (if window_g > 0)
+ * and a comb table with the given parameters (if comb_blocks > 0). */
+static unsigned char *create_table_file(size_t *len, int window_g, int comb_blocks, int comb_teeth) {
+    size_t payload_len = secp256k1_table_file_payload_len(window_g, comb_blocks, comb_teeth);
+    unsigned char *file = (unsigned char *)malloc(SECP256K1_TABLE_FILE_HEADER_SIZE + payload_len);
+    secp256k1_ge_storage *tables;
+
+    CHECK(file != NULL);
+    tables = (secp256k1_ge_storage *)(void *)(file + SECP256K1_TABLE_FILE_HEADER_SIZE);
+    if (window_g > 0) {
+        secp256k1_ecmult_compute_two_tables(tables, tables + ECMULT_TABLE_SIZE(window_g), window_g, &secp256k1_ge_const_g);
+        tables += 2 * ECMULT_TABLE_SIZE(window_g);
+    }
+    if (comb_blocks > 0) {
+        secp256k1_ecmult_gen_compute_table(tables, &secp256k1_ge_const_g, comb_blocks, comb_teeth, CEIL_DIV(COMB_RANGE, comb_blocks * comb_teeth));
+    }
+    secp256k1_table_file_write_header(file, window_g, comb_blocks, comb_teeth, file + SECP256K1_TABLE_FILE_HEADER_SIZE, payload_len);
+    *len = SECP256K1_TABLE_FILE_HEADER_SIZE + payload_len;
+    return file;
+}
+
+static void run_context_ecmult_tables_tests(void) {
+    int window = 3 + secp256k1_testrand_int(10);
+    int comb = secp256k1_testrand_bits(1);
+    size_t len, pos;
+    unsigned char *file = create_table_file(&len, window, comb ? COMB_BLOCKS : 0, comb ? COMB_TEETH : 0);
+    unsigned char flip;
+    secp256k1_context *ctx, *ctx_clone;
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey pubkey, pubkey2;
+    unsigned char sk[32], msg[32];
+    int i;
+
+    ctx = secp256k1_context_clone(CTX);
+    CHECK_ILLEGAL(STATIC_CTX, secp256k1_context_set_ecmult_tables(STATIC_CTX, file, len));
+    CHECK_ILLEGAL(CTX, secp256k1_ecmult_tables_check(CTX, NULL, len));
+    CHECK(secp256k1_ecmult_tables_check(CTX, file, len) == 1);
+    CHECK(secp256k1_context_set_ecmult_tables(ctx, file, len - 1) == 0);
+    CHECK(secp256k1_context_set_ecmult_tables(ctx, file, SECP256K1_TABLE_FILE_HEADER_SIZE - 1) == 0);
+    CHECK(secp256k1_ecmult_tables_check(CTX, file, len - 1) == 0);
+
+    /* A corrupted header is rejected by both functions. */
+    pos = secp256k1_testrand_int(SECP256K1_TABLE_FILE_HEADER_SIZE);
+    flip = 1 << secp256k1_testrand_int(8);
+    file[pos] ^= flip;
+    CHECK(secp256k1_context_set_ecmult_tables(ctx, file, len) == 0);
+    CHECK(secp256k1_ecmult_tables_check(CTX, file, len) == 0);
+    CHECK(context_eq(ctx, CTX));
+    file[pos] ^= flip;
+
+    /* A corrupted payload is only detected by the full check. */
+    pos = SECP256K1_TABLE_FILE_HEADER_SIZE + secp256k1_testrand_int(len - SECP256K1_TABLE_FILE_HEADER_SIZE);
+    file[pos] ^= flip;
+    CHECK(secp256k1_ecmult_tables_check(CTX, file, len) == 0);
+    file[pos] ^= flip;
+
+    CHECK(secp256k1_context_set_ecmult_tables(ctx, file, len) == 1);
+    CHECK(ctx->ecmult_g.window_g == window);
+    CHECK(ctx->ecmult_g.pre_g == (const secp256k1_ge_storage *)(void *)(file + SECP256K1_TABLE_FILE_HEADER_SIZE));
+    CHECK((ctx->ecmult_gen_ctx.prec == &secp256k1_ecmult_gen_prec_table[0][0]) == !comb);
+
+    /* The tables are used for signing and verification, also by clones. */
+    ctx_clone = secp256k1_context_clone(ctx);
+    CHECK(context_eq(ctx, ctx_clone));
+    for (i = 0; i < COUNT; i++) {
+        secp256k1_gej a, r1, r2;
+        secp256k1_scalar na, ng;
+
+        random_gej_test(&a);
+        random_scalar_order_test(&na);
+        random_scalar_order_test(&ng);
+        secp256k1_ecmult(&r1, &a, &na, &ng);
+        secp256k1_ecmult_tables(&ctx_clone->ecmult_g, &r2, &a, &na, &ng);
+        CHECK(secp256k1_gej_eq_var(&r1, &r2));
+
+        secp256k1_testrand256(sk);
+        secp256k1_testrand256(msg);
+        if (!secp256k1_ec_pubkey_create(CTX, &pubkey, sk)) {
+            continue;
+        }
+        CHECK(secp256k1_ec_pubkey_create(ctx_clone, &pubkey2, sk) == 1);
+        CHECK(secp256k1_ec_pubkey_cmp(CTX, &pubkey, &pubkey2) == 0);
+        CHECK(secp256k1_ecdsa_sign(ctx_clone, &sig, msg, sk, NULL, NULL) == 1);
+        CHECK(secp256k1_ecdsa_verify(ctx_clone, &sig, msg, &pubkey) == 1);
+        msg[secp256k1_testrand_int(32)] ^= 1 + secp256k1_testrand_int(255);
+        CHECK(secp256k1_ecdsa_verify(ctx_clone, &sig, msg, &pubkey) == 0);
+    }
+    secp256k1_context_destroy(ctx_clone);
+
+    /* NULL restores the built-in tables. */
+    CHECK(secp256k1_context_set_ecmult_tables(ctx, NULL, 0) == 1);
+    CHECK(context_eq(ctx, CTX));
+    free(file);
+
+    /* A file with only a comb table resets the G tables. */
+    file = create_table_file(&len, window, 0, 0);
+    CHECK(secp256k1_context_set_ecmult_tables(ctx, file, len) == 1);
+    CHECK(!context_eq(ctx, CTX));
+    free(file);
+    file = create_table_file(&len, 0, COMB_BLOCKS, COMB_TEETH);
+    CHECK(secp256k1_context_set_ecmult_tables(ctx, file, len) == 1);
+    CHECK(ctx->ecmult_g.pre_g == secp256k1_pre_g);
+    CHECK(secp256k1_ecmult_tables_check(CTX, file, len) == 1);
+    free(file);
+
+    secp256k1_context_destroy(ctx);
+}
+
+static void test_context_ecmult_gen_matches(const secp256k1_context *ctx) {
+    int i;
+    for (i = 0; i < 4; i++) {
+        secp256k1_scalar x;
+        secp256k1_gej r1, r2;
+        secp256k1_pubkey pubkey1, pubkey2;
+        secp256k1_ecdsa_signature sig1, sig2;
+        unsigned char sk[32], msg[32];
+
+        random_scalar_order_test(&x);
+        secp256k1_ecmult_gen(&CTX->ecmult_gen_ctx, &r1, &x);
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &r2, &x);
+        CHECK(secp256k1_gej_eq_var(&r1, &r2));
+
+        secp256k1_scalar_get_b32(sk, &x);
+        secp256k1_testrand256(msg);
+        CHECK(secp256k1_ec_pubkey_create(CTX, &pubkey1, sk) == 1);
+        CHECK(secp256k1_ec_pubkey_create(ctx, &pubkey2, sk) == 1);
+        CHECK(secp256k1_ec_pubkey_cmp(CTX, &pubkey1, &pubkey2) == 0);
+        CHECK(secp256k1_ecdsa_sign(CTX, &sig1, msg, sk, NULL, NULL) == 1);
+        CHECK(secp256k1_ecdsa_sign(ctx, &sig2, msg, sk, NULL, NULL) == 1);
+        CHECK(secp256k1_memcmp_var(&sig1, &sig2, sizeof(sig1)) == 0);
+    }
+}
+
+static void run_context_ecmult_gen_flags_tests(void) {
+    static const unsigned int flags[] = { SECP256K1_CONTEXT_ECMULT_GEN_KB_2, SECP256K1_CONTEXT_ECMULT_GEN_KB_22, SECP256K1_CONTEXT_ECMULT_GEN_KB_86 };
+    int i;
+
+    for (i = 0; i < (int)(sizeof(flags) / sizeof(flags[0])); i++) {
+        secp256k1_context *ctx, *ctx_clone, saved;
+        void *prealloc;
+        unsigned char seed[32];
+        unsigned char *file;
+        size_t size, len;
+        int blocks, teeth;
+
+        size = secp256k1_context_preallocated_size(flags[i]);
+        CHECK(size >= secp256k1_context_preallocated_size(SECP256K1_CONTEXT_NONE));
+        ctx = secp256k1_context_create(flags[i]);
+        CHECK(secp256k1_context_preallocated_clone_size(ctx) == size);
+        secp256k1_context_comb_params(&blocks, &teeth, flags[i] & SECP256K1_FLAGS_MASK_CONTEXT_ECMULT_GEN);
+        CHECK(ctx->ecmult_gen_ctx.blocks == blocks);
+        CHECK(ctx->ecmult_gen_ctx.teeth == teeth);
+        CHECK((ctx->ecmult_gen_ctx.prec == &secp256k1_ecmult_gen_prec_table[0][0]) == (blocks == COMB_BLOCKS && teeth == COMB_TEETH));
+        test_context_ecmult_gen_matches(ctx);
+        secp256k1_testrand256(seed);
+        CHECK(secp256k1_context_randomize(ctx, seed) == 1);
+        test_context_ecmult_gen_matches(ctx);
+
+        /* A clone uses its own copy of the table. */
+        ctx_clone = secp256k1_context_clone(ctx);
+        CHECK(ctx_clone->ecmult_gen_ctx.blocks == blocks);
+        CHECK((ctx_clone->ecmult_gen_ctx.prec == ctx->ecmult_gen_ctx.prec) == (blocks == COMB_BLOCKS && teeth == COMB_TEETH));
+        secp256k1_context_destroy(ctx);
+        test_context_ecmult_gen_matches(ctx_clone);
+
+        /* Tables from a file with random parameters are used until restored. */
+        do {
+            blocks = 1 + secp256k1_testrand_int(64);
+            teeth = 1 + secp256k1_testrand_int(8);
+        } while (!secp256k1_ecmult_gen_comb_params_valid(blocks, teeth));
+        file = create_table_file(&len, 0, blocks, teeth);
+        saved = *ctx_clone;
+        CHECK(secp256k1_context_set_ecmult_tables(ctx_clone, file, len) == 1);
+        CHECK(ctx_clone->ecmult_gen_ctx.blocks == blocks);
+        CHECK(ctx_clone->ecmult_gen_ctx.teeth == teeth);
+        test_context_ecmult_gen_matches(ctx_clone);
+        CHECK(secp256k1_context_randomize(ctx_clone, seed) == 1);
+        test_context_ecmult_gen_matches(ctx_clone);
+        CHECK(secp256k1_context_randomize(ctx_clone, NULL) == 1);
+        CHECK(secp256k1_context_set_ecmult_tables(ctx_clone, NULL, 0) == 1);
+        CHECK(secp256k1_context_randomize(ctx_clone, seed) == 1);
+        CHECK(context_eq(ctx_clone, &saved));
+        secp256k1_context_destroy(ctx_clone);
+        free(file);
+
+        prealloc = malloc(size);
+        CHECK(prealloc != NULL);
+        ctx = secp256k1_context_preallocated_create(prealloc, flags[i]);
+        test_context_ecmult_gen_matches(ctx);
+        secp256k1_context_preallocated_destroy(ctx);
+        free(prealloc);
+    }
+}
+
 static void run_ec_illegal_argument_tests(void) {
     secp256k1_pubkey pubkey;
     secp256k1_pubkey zero_pubkey;
@@ -458,7 +662,7 @@ static void run_proper_context_tests(int use_prealloc) {
     CHECK(secp256k1_ecdsa_sig_sign(&my_ctx->ecmult_gen_ctx, &sigr, &sigs, &key, &msg, &nonce, NULL));
 
     /* try verifying */
-    CHECK(secp256k1_ecdsa_sig_verify(&sigr, &sigs, &pub, &msg));
+    CHECK(secp256k1_ecdsa_sig_verify(&my_ctx->ecmult_g, &sigr, &sigs, &pub, &msg));
 
     /* cleanup */
     if (use_prealloc) {
@@ -724,6 +928,62 @@ static void run_sha256_counter_tests(void) {
     }
 }
 
+static void run_sha256_transform_tests(void) {
+    int i, j;
+    for (i = 0; i < COUNT; i++) {
+        uint32_t s1[8], s2[8];
+        unsigned char buf[64];
+        for (j = 0; j < 8; j++) {
+            s1[j] = s2[j] = secp256k1_testrand32();
+        }
+        secp256k1_testrand_bytes_test(buf, sizeof(buf));
+        /* The transform used by the hasher must agree with the portable one. */
+        secp256k1_sha256_transform(s1, buf);
+        secp256k1_sha256_transform_portable(s2, buf);
+        CHECK(secp256k1_memcmp_var(s1, s2, sizeof(s1)) == 0);
+    }
+}
+
+static void run_sha256_x8_tests(void) {
+    int i, j;
+    for (i = 0; i < COUNT; i++) {
+        unsigned char prefix[128];
+        unsigned char msgs[8][150];
+        const unsigned char *data[8];
+        unsigned char out[8 * 32], out1[32];
+        size_t prefix_len = 64 * secp256k1_testrand_int(3);
+        size_t len = secp256k1_testrand_int(sizeof(msgs[0]) + 1);
+        size_t split = secp256k1_testrand_int(len + 1);
+        secp256k1_sha256 sha, sha1;
+        secp256k1_sha256_x8 sha_x8;
+
+        secp256k1_testrand_bytes_test(prefix, sizeof(prefix));
+        for (j = 0; j < 8; j++) {
+            secp256k1_testrand_bytes_test(msgs[j], sizeof(msgs[j]));
+        }
+        /* Hash the same prefix followed by eight messages of equal length,
+         * written in two parts. */
+        secp256k1_sha256_initialize(&sha);
+        secp256k1_sha256_write(&sha, prefix, prefix_len);
+        secp256k1_sha256_x8_initialize(&sha_x8, &sha);
+        for (j = 0; j < 8; j++) {
+            data[j] = msgs[j];
+        }
+        secp256k1_sha256_x8_write(&sha_x8, data, split);
+        for (j = 0; j < 8; j++) {
+            data[j] = msgs[j] + split;
+        }
+        secp256k1_sha256_x8_write(&sha_x8, data, len - split);
+        secp256k1_sha256_x8_finalize(&sha_x8, out);
+        for (j = 0; j < 8; j++) {
+            sha1 = sha;
+            secp256k1_sha256_write(&sha1, msgs[j], len);
+            secp256k1_sha256_finalize(&sha1, out1);
+            CHECK(secp256k1_memcmp_var(&out[32 * j], out1, 32) == 0);
+        }
+    }
+}
+
 /* Tests for the equality of two sha256 structs. This function only produces a
  * correct result if an integer multiple of 64 many bytes have been written
  * into the hash functions. This function is used by some module tests. */
@@ -795,6 +1055,7 @@ static void run_rfc6979_hmac_sha256_tests(void) {
     };
 
     secp256k1_rfc6979_hmac_sha256 rng;
+    secp256k1_hmac_sha256 prefix_hmac;
     unsigned char out[32];
     int i;
 
@@ -805,6 +1066,14 @@ static void run_rfc6979_hmac_sha256_tests(void) {
     }
     secp256k1_rfc6979_hmac_sha256_finalize(&rng);
 
+    secp256k1_rfc6979_hmac_sha256_prefix(&prefix_hmac, key1);
+    secp256k1_rfc6979_hmac_sha256_initialize_prefixed(&rng, &prefix_hmac, key1, key1 + 32, 32);
+    for (i = 0; i < 3; i++) {
+        secp256k1_rfc6979_hmac_sha256_generate(&rng, out, 32);
+        CHECK(secp256k1_memcmp_var(out, out1[i], 32) == 0);
+    }
+    secp256k1_rfc6979_hmac_sha256_finalize(&rng);
+
     secp256k1_rfc6979_hmac_sha256_initialize(&rng, key1, 65);
     for (i = 0; i < 3; i++) {
         secp256k1_rfc6979_hmac_sha256_generate(&rng, out, 32);
@@ -844,6 +1113,60 @@ static void run_tagged_sha256_tests(void) {
     CHECK(secp256k1_memcmp_var(hash32, hash_expected, sizeof(hash32)) == 0);
 }
 
+static void run_tagged_hasher_tests(void) {
+    secp256k1_tagged_hasher hasher, hasher2;
+    secp256k1_sha256 sha, sha2;
+    unsigned char tag[100];
+    unsigned char msg[200];
+    unsigned char hash32[32], hash32_expected[32];
+    unsigned char hash_expected[32] = {
+        0x04, 0x7A, 0x5E, 0x17, 0xB5, 0x86, 0x47, 0xC1,
+        0x3C, 0xC6, 0xEB, 0xC0, 0xAA, 0x58, 0x3B, 0x62,
+        0xFB, 0x16, 0x43, 0x32, 0x68, 0x77, 0x40, 0x6C,
+        0xE2, 0x76, 0x55, 0x9A, 0x3B, 0xDE, 0x55, 0xB3
+    };
+    int i, j;
+
+    /* API test */
+    memcpy(tag, "tag", 3);
+    memcpy(msg, "msg", 3);
+    CHECK(secp256k1_tagged_hasher_create(CTX, &hasher, tag, 3) == 1);
+    CHECK_ILLEGAL(CTX, secp256k1_tagged_hasher_create(CTX, NULL, tag, 3));
+    CHECK_ILLEGAL(CTX, secp256k1_tagged_hasher_create(CTX, &hasher, NULL, 0));
+    CHECK(secp256k1_tagged_hasher_sha256(CTX, hash32, &hasher, msg, 3) == 1);
+    CHECK_ILLEGAL(CTX, secp256k1_tagged_hasher_sha256(CTX, NULL, &hasher, msg, 3));
+    CHECK_ILLEGAL(CTX, secp256k1_tagged_hasher_sha256(CTX, hash32, NULL, msg, 3));
+    CHECK_ILLEGAL(CTX, secp256k1_tagged_hasher_sha256(CTX, hash32, &hasher, NULL, 0));
+
+    /* Static test vector (the same as in run_tagged_sha256_tests) */
+    CHECK(secp256k1_tagged_hasher_sha256(CTX, hash32, &hasher, msg, 3) == 1);
+    CHECK(secp256k1_memcmp_var(hash32, hash_expected, sizeof(hash32)) == 0);
+
+    /* The hasher holds the state of secp256k1_sha256_initialize_tagged. */
+    secp256k1_sha256_initialize_tagged(&sha, tag, 3);
+    for (i = 0; i < 8; i++) {
+        sha2.s[i] = secp256k1_read_be32(&hasher.data[4*i]);
+    }
+    sha2.bytes = 64;
+    test_sha256_eq(&sha, &sha2);
+
+    /* Random tags and messages give the same hashes as secp256k1_tagged_sha256,
+     * and a hasher can be reused and copied. */
+    for (i = 0; i < COUNT; i++) {
+        size_t taglen = secp256k1_testrand_int(sizeof(tag) + 1);
+        secp256k1_testrand_bytes_test(tag, taglen);
+        CHECK(secp256k1_tagged_hasher_create(CTX, &hasher, tag, taglen) == 1);
+        hasher2 = hasher;
+        for (j = 0; j < 4; j++) {
+            size_t msglen = secp256k1_testrand_int(sizeof(msg) + 1);
+            secp256k1_testrand_bytes_test(msg, msglen);
+            CHECK(secp256k1_tagged_sha256(CTX, hash32_expected, tag, taglen, msg, msglen) == 1);
+            CHECK(secp256k1_tagged_hasher_sha256(CTX, hash32, (j & 1) ? &hasher2 : &hasher, msg, msglen) == 1);
+            CHECK(secp256k1_memcmp_var(hash32, hash32_expected, sizeof(hash32)) == 0);
+        }
+    }
+}
+
 /***** MODINV TESTS *****/
 
 /* Compute the modular inverse of (odd) x mod 2^64. */
@@ -2258,6 +2581,22 @@ static void scalar_test(void) {
         CHECK(secp256k1_scalar_eq(&r1, &s1));
     }
 
+    {
+        /* Test mul against double-and-add, which does not use the (possibly
+         * assembly) multiplication and 512-bit reduction code. */
+        secp256k1_scalar r1, r2;
+        int i;
+        secp256k1_scalar_mul(&r1, &s1, &s2);
+        secp256k1_scalar_set_int(&r2, 0);
+        for (i = 255; i >= 0; i--) {
+            secp256k1_scalar_add(&r2, &r2, &r2);
+            if (secp256k1_scalar_get_bits_var(&s2, i, 1)) {
+                secp256k1_scalar_add(&r2, &r2, &s1);
+            }
+        }
+        CHECK(secp256k1_scalar_eq(&r1, &r2));
+    }
+
     {
         /* Test additive identity. */
         secp256k1_scalar r1;
@@ -3314,6 +3653,118 @@ static void run_sqr(void) {
     }
 }
 
+#ifdef SECP256K1_FE_X4
+static void fe_x4_set_lanes(secp256k1_fe_x4 *r, const secp256k1_fe *a) {
+    secp256k1_fe_storage s[4];
+    const secp256k1_fe_storage *p[4];
+    int j;
+    for (j = 0; j < 4; j++) {
+        secp256k1_fe t = a[j];
+        secp256k1_fe_normalize(&t);
+        secp256k1_fe_to_storage(&s[j], &t);
+        p[j] = &s[j];
+    }
+    secp256k1_fe_x4_set_storage(r, p);
+}
+
+static void fe_x4_check_lanes(const secp256k1_fe_x4 *a, const secp256k1_fe *expected) {
+    secp256k1_fe_x4 t = *a;
+    secp256k1_fe_storage s[4];
+    secp256k1_fe f;
+    int j;
+    secp256k1_fe_x4_normalize(&t);
+    secp256k1_fe_x4_get_storage(s, &t);
+    for (j = 0; j < 4; j++) {
+        secp256k1_fe_from_storage(&f, &s[j]);
+        CHECK(fe_equal(&f, &expected[j]));
+    }
+}
+
+static void run_fe_x4(void) {
+    int i, j;
+    for (i = 0; i < 10 * COUNT; i++) {
+        secp256k1_fe a[4], b[4], r[4];
+        secp256k1_fe_x4 ax, bx, rx;
+        uint64_t mask[4];
+        int m = 1 + secp256k1_testrand_int(8);
+
+        for (j = 0; j < 4; j++) {
+            random_fe_test(&a[j]);
+            random_fe_test(&b[j]);
+            if (secp256k1_testrand_bits(3) == 0) {
+                secp256k1_fe_clear(&a[j]);
+            }
+        }
+        fe_x4_set_lanes(&ax, a);
+        fe_x4_set_lanes(&bx, b);
+        fe_x4_check_lanes(&ax, a);
+
+        /* Raise the magnitude of a to m. */
+        secp256k1_fe_x4_mul_int(&ax, m);
+        for (j = 0; j < 4; j++) {
+            secp256k1_fe_mul_int_unchecked(&a[j], m);
+        }
+        fe_x4_check_lanes(&ax, a);
+
+        secp256k1_fe_x4_mul(&rx, &ax, &bx);
+        for (j = 0; j < 4; j++) {
+            secp256k1_fe_mul(&r[j], &a[j], &b[j]);
+        }
+        fe_x4_check_lanes(&rx, r);
+
+        secp256k1_fe_x4_mul(&bx, &ax, &bx);
+        fe_x4_check_lanes(&bx, r);
+
+        secp256k1_fe_x4_sqr(&rx, &ax);
+        for (j = 0; j < 4; j++) {
+            secp256k1_fe_sqr(&r[j], &a[j]);
+        }
+        fe_x4_check_lanes(&rx, r);
+
+        secp256k1_fe_x4_negate(&rx, &ax, m);
+        for (j = 0; j < 4; j++) {
+            secp256k1_fe_negate_unchecked(&r[j], &a[j], m);
+        }
+        fe_x4_check_lanes(&rx, r);
+
+        /* Sum of a and -a, which normalizes to zero, except in the lanes selected by mask. */
+        for (j = 0; j < 4; j++) {
+            mask[j] = -(uint64_t)secp256k1_testrand_bits(1);
+            if (mask[j]) {
+                secp256k1_fe_add_int(&r[j], 1);
+            }
+        }
+        fe_x4_set_lanes(&bx, r);
+        secp256k1_fe_x4_cmov(&rx, &bx, _mm256_loadu_si256((const __m256i *)(const void *)mask));
+        fe_x4_check_lanes(&rx, r);
+        secp256k1_fe_x4_add(&rx, &ax);
+        for (j = 0; j < 4; j++) {
+            secp256k1_fe_add(&r[j], &a[j]);
+        }
+        fe_x4_check_lanes(&rx, r);
+        _mm256_storeu_si256((__m256i *)(void *)mask, secp256k1_fe_x4_normalizes_to_zero(&rx));
+        for (j = 0; j < 4; j++) {
+            CHECK((mask[j] != 0) == secp256k1_fe_normalizes_to_zero(&r[j]));
+            CHECK(mask[j] == 0 || mask[j] == (uint64_t)-1);
+        }
+
+        secp256k1_fe_x4_half(&rx);
+        for (j = 0; j < 4; j++) {
+            secp256k1_fe_half(&r[j]);
+        }
+        fe_x4_check_lanes(&rx, r);
+
+        secp256k1_fe_x4_normalize_weak(&rx);
+        secp256k1_fe_x4_mul(&rx, &rx, &rx);
+        for (j = 0; j < 4; j++) {
+            secp256k1_fe_normalize_weak(&r[j]);
+            secp256k1_fe_sqr(&r[j], &r[j]);
+        }
+        fe_x4_check_lanes(&rx, r);
+    }
+}
+#endif
+
 static void test_sqrt(const secp256k1_fe *a, const secp256k1_fe *k) {
     secp256k1_fe r1, r2;
     int v = secp256k1_fe_sqrt(&r1, a);
@@ -3949,6 +4400,16 @@ static void test_ge(void) {
         free(ge_set_all);
     }
 
+    /* Test the constant-time batch conversion, which does not allow infinity. */
+    {
+        secp256k1_ge *ge_set_all = (secp256k1_ge *)checked_malloc(&CTX->error_callback, (4 * runs) * sizeof(secp256k1_ge));
+        secp256k1_ge_set_all_gej(ge_set_all, &gej[1], 4 * runs);
+        for (i = 1; i < 4 * runs + 1; i++) {
+            CHECK(secp256k1_gej_eq_ge_var(&gej[i], &ge_set_all[i - 1]));
+        }
+        free(ge_set_all);
+    }
+
     /* Test that all elements have X coordinates on the curve. */
     for (i = 1; i < 4 * runs + 1; i++) {
         secp256k1_fe n;
@@ -4098,11 +4559,28 @@ static void test_add_neg_y_diff_x(void) {
     CHECK(secp256k1_gej_eq_ge_var(&sumj, &res));
 }
 
+static void test_ge_storage_table_lookup(void) {
+    secp256k1_ge_storage table[33], r;
+    uint32_t n, i;
+
+    /* The lookup copies bits, so the entries need not be valid points. */
+    secp256k1_testrand_bytes_test((unsigned char *)table, sizeof(table));
+    for (n = 1; n <= 33; n++) {
+        for (i = 0; i < n; i++) {
+            secp256k1_ge_storage_table_lookup(&r, table, n, i);
+            CHECK(secp256k1_memcmp_var(&r, &table[i], sizeof(r)) == 0);
+        }
+    }
+}
+
 static void run_ge(void) {
     int i;
     for (i = 0; i < COUNT * 32; i++) {
         test_ge();
     }
+    for (i = 0; i < COUNT; i++) {
+        test_ge_storage_table_lookup();
+    }
     test_add_neg_y_diff_x();
     test_intialized_inf();
 }
@@ -4151,6 +4629,116 @@ static void run_gej(void) {
     }
 }
 
+#ifdef SECP256K1_FE_X4
+static void gej_x4_set_lanes(secp256k1_gej_x4 *r, const secp256k1_gej *a) {
+    secp256k1_fe x[4], y[4], z[4];
+    uint64_t infinity[4];
+    int j;
+    for (j = 0; j < 4; j++) {
+        x[j] = a[j].x;
+        y[j] = a[j].y;
+        z[j] = a[j].z;
+        infinity[j] = -(uint64_t)a[j].infinity;
+    }
+    fe_x4_set_lanes(&r->x, x);
+    fe_x4_set_lanes(&r->y, y);
+    fe_x4_set_lanes(&r->z, z);
+    r->infinity = _mm256_loadu_si256((const __m256i *)(const void *)infinity);
+}
+
+static void gej_x4_check_lanes(const secp256k1_gej_x4 *a, const secp256k1_gej *expected) {
+    secp256k1_gej r[4];
+    int j;
+    secp256k1_gej_x4_get_gej(r, a);
+    for (j = 0; j < 4; j++) {
+        CHECK(r[j].infinity == expected[j].infinity);
+        CHECK(secp256k1_gej_eq_var(&r[j], &expected[j]));
+    }
+}
+
+static void run_gej_x4(void) {
+    int i, j;
+    for (i = 0; i < COUNT; i++) {
+        secp256k1_gej a[4], r[4];
+        secp256k1_ge b[4];
+        secp256k1_ge_storage bs[4];
+        const secp256k1_ge_storage *bp[4];
+        secp256k1_scalar k[4];
+        secp256k1_fe s;
+        secp256k1_gej_x4 ax, rx;
+        secp256k1_ge_x4 bx;
+        uint64_t mask[4];
+
+        for (j = 0; j < 4; j++) {
+            random_gej_test(&a[j]);
+            random_group_element_test(&b[j]);
+        }
+        /* Lane 0 is infinity, and lanes 1, 2 and 3 hit the doubling, the
+         * cancelling and the degenerate (y1 = -y2, x1 != x2) case of the addition. */
+        secp256k1_gej_set_infinity(&a[0]);
+        secp256k1_ge_set_gej_var(&b[1], &a[1]);
+        secp256k1_ge_set_gej_var(&b[2], &a[2]);
+        secp256k1_ge_neg(&b[2], &b[2]);
+        secp256k1_ge_set_gej_var(&b[3], &a[3]);
+        secp256k1_ge_mul_lambda(&b[3], &b[3]);
+        secp256k1_ge_neg(&b[3], &b[3]);
+        for (j = 0; j < 4; j++) {
+            secp256k1_fe_normalize(&b[j].y);
+            secp256k1_ge_to_storage(&bs[j], &b[j]);
+            bp[j] = &bs[j];
+        }
+        gej_x4_set_lanes(&ax, a);
+        secp256k1_ge_x4_set_storage(&bx, bp);
+
+        secp256k1_gej_x4_add_ge(&rx, &ax, &bx);
+        for (j = 0; j < 4; j++) {
+            secp256k1_gej_add_ge(&r[j], &a[j], &b[j]);
+        }
+        gej_x4_check_lanes(&rx, r);
+
+        secp256k1_gej_x4_double(&rx, &rx);
+        for (j = 0; j < 4; j++) {
+            secp256k1_gej_double(&r[j], &r[j]);
+        }
+        gej_x4_check_lanes(&rx, r);
+
+        random_fe_non_zero_test(&s);
+        secp256k1_fe_x4_set_fe(&rx.z, &s);
+        secp256k1_gej_x4_rescale(&ax, &rx.z);
+        for (j = 0; j < 4; j++) {
+            secp256k1_gej_rescale(&a[j], &s);
+        }
+        gej_x4_check_lanes(&ax, a);
+
+        for (j = 0; j < 4; j++) {
+            mask[j] = -(uint64_t)secp256k1_testrand_bits(1);
+            if (mask[j]) {
+                secp256k1_ge_neg(&b[j], &b[j]);
+            }
+        }
+        secp256k1_ge_x4_cond_negate(&bx, _mm256_loadu_si256((const __m256i *)(const void *)mask));
+        secp256k1_gej_x4_set_ge(&rx, &bx);
+        for (j = 0; j < 4; j++) {
+            secp256k1_gej_set_ge(&r[j], &b[j]);
+        }
+        gej_x4_check_lanes(&rx, r);
+
+        for (j = 0; j < 4; j++) {
+            random_scalar_order_test(&k[j]);
+        }
+        k[secp256k1_testrand_int(4)] = secp256k1_scalar_zero;
+        secp256k1_ecmult_gen_x4(&CTX->ecmult_gen_ctx, r, k);
+        for (j = 0; j < 4; j++) {
+            secp256k1_ecmult_gen(&CTX->ecmult_gen_ctx, &a[j], &k[j]);
+        }
+        for (j = 0; j < 4; j++) {
+            CHECK(r[j].infinity == a[j].infinity);
+            CHECK(secp256k1_gej_eq_var(&r[j], &a[j]));
+        }
+    }
+}
+#endif
+
 static void test_ec_combine(void) {
     secp256k1_scalar sum = secp256k1_scalar_zero;
     secp256k1_pubkey data[6];
@@ -4425,7 +5013,7 @@ static const secp256k1_scalar scalars_near_split_bounds[20] = {
 };
 
 static void test_ecmult_target(const secp256k1_scalar* target, int mode) {
-    /* Mode: 0=ecmult_gen, 1=ecmult, 2=ecmult_const */
+    /* Mode: 0=ecmult_gen, 1=ecmult, 2=ecmult_const, 3=ecmult_prepared */
     secp256k1_scalar n1, n2;
     secp256k1_ge p;
     secp256k1_gej pj, p1j, p2j, ptj;
@@ -4450,10 +5038,16 @@ static void test_ecmult_target(const secp256k1_scalar* target, int mode) {
         secp256k1_ecmult(&p1j, &pj, &n1, &secp256k1_scalar_zero);
         secp256k1_ecmult(&p2j, &pj, &n2, &secp256k1_scalar_zero);
         secp256k1_ecmult(&ptj, &pj, target, &secp256k1_scalar_zero);
-    } else {
+    } else if (mode == 2) {
         secp256k1_ecmult_const(&p1j, &p, &n1);
         secp256k1_ecmult_const(&p2j, &p, &n2);
         secp256k1_ecmult_const(&ptj, &p, target);
+    } else {
+        secp256k1_ecmult_prepared_table pre;
+        secp256k1_ecmult_prepared_table_build(&pre, &p);
+        secp256k1_ecmult_prepared(&CTX->ecmult_g, &p1j, &pre, &n1, NULL);
+        secp256k1_ecmult_prepared(&CTX->ecmult_g, &p2j, &pre, &n2, &secp256k1_scalar_zero);
+        secp256k1_ecmult_prepared(&CTX->ecmult_g, &ptj, &pre, target, NULL);
     }
 
     /* Add them all up: n1*P + n2*P + target*P = (n1+n2+target)*P = (n1+n1-n1-n2)*P = 0. */
@@ -4470,7 +5064,41 @@ static void run_ecmult_near_split_bound(void) {
             test_ecmult_target(&scalars_near_split_bounds[j], 0);
             test_ecmult_target(&scalars_near_split_bounds[j], 1);
             test_ecmult_target(&scalars_near_split_bounds[j], 2);
+            test_ecmult_target(&scalars_near_split_bounds[j], 3);
+        }
+    }
+}
+
+/* Compares secp256k1_ecmult_prepared against secp256k1_ecmult. */
+static void run_ecmult_prepared_tests(void) {
+    int i;
+    for (i = 0; i < 4*COUNT; i++) {
+        secp256k1_ecmult_prepared_table pre;
+        secp256k1_scalar na, ng;
+        secp256k1_ge a;
+        secp256k1_gej aj, expected, computed;
+
+        random_group_element_test(&a);
+        secp256k1_gej_set_ge(&aj, &a);
+        secp256k1_ecmult_prepared_table_build(&pre, &a);
+        random_scalar_order_test(&na);
+        random_scalar_order_test(&ng);
+        switch (secp256k1_testrand_int(4)) {
+        case 0: na = secp256k1_scalar_zero; break;
+        case 1: secp256k1_scalar_negate(&na, &ng); break;
+        default: break;
         }
+        secp256k1_ecmult(&expected, &aj, &na, &ng);
+        secp256k1_ecmult_prepared(&CTX->ecmult_g, &computed, &pre, &na, &ng);
+        CHECK(secp256k1_gej_eq_var(&computed, &expected));
+        secp256k1_ecmult(&expected, &aj, &na, NULL);
+        secp256k1_ecmult_prepared(&CTX->ecmult_g, &computed, &pre, &na, NULL);
+        CHECK(secp256k1_gej_eq_var(&computed, &expected));
+        /* The prepared point is the generator. */
+        secp256k1_ecmult_prepared_table_build(&pre, &secp256k1_ge_const_g);
+        secp256k1_scalar_negate(&na, &ng);
+        secp256k1_ecmult_prepared(&CTX->ecmult_g, &computed, &pre, &na, &ng);
+        CHECK(secp256k1_gej_is_infinity(&computed));
     }
 }
 
@@ -5151,7 +5779,7 @@ static void test_secp256k1_pippenger_bucket_window_inv(void) {
  */
 static void test_ecmult_multi_pippenger_max_points(void) {
     size_t scratch_size = secp256k1_testrand_bits(8);
-    size_t max_size = secp256k1_pippenger_scratch_size(secp256k1_pippenger_bucket_window_inv(PIPPENGER_MAX_BUCKET_WINDOW-1)+512, 12);
+    size_t max_size = secp256k1_pippenger_scratch_size(secp256k1_pippenger_bucket_window_inv(PIPPENGER_MAX_BUCKET_WINDOW-1)+512, 12, 1);
     secp256k1_scratch *scratch;
     size_t n_points_supported;
     int bucket_window = 0;
@@ -5170,7 +5798,7 @@ static void test_ecmult_multi_pippenger_max_points(void) {
         }
         bucket_window = secp256k1_pippenger_bucket_window(n_points_supported);
         /* allocate `total_alloc` bytes over `PIPPENGER_SCRATCH_OBJECTS` many allocations */
-        total_alloc = secp256k1_pippenger_scratch_size(n_points_supported, bucket_window);
+        total_alloc = secp256k1_pippenger_scratch_size(n_points_supported, bucket_window, 1);
         for (i = 0; i < PIPPENGER_SCRATCH_OBJECTS - 1; i++) {
             CHECK(secp256k1_scratch_alloc(&CTX->error_callback, scratch, 1));
             total_alloc--;
@@ -5271,7 +5899,7 @@ static void test_ecmult_multi_batching(void) {
     /* Test with space for 1 point in pippenger. That's not enough because
      * ecmult_multi selects strauss which requires more memory. It should
      * therefore select the simple algorithm. */
-    scratch = secp256k1_scratch_create(&CTX->error_callback, secp256k1_pippenger_scratch_size(1, 1) + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT);
+    scratch = secp256k1_scratch_create(&CTX->error_callback, secp256k1_pippenger_scratch_size(1, 1, 1) + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT);
     CHECK(secp256k1_ecmult_multi_var(&CTX->error_callback, scratch, &r, &scG, ecmult_multi_callback, &data, n_points));
     secp256k1_gej_add_var(&r, &r, &r2, NULL);
     CHECK(secp256k1_gej_is_infinity(&r));
@@ -5280,7 +5908,7 @@ static void test_ecmult_multi_batching(void) {
     for(i = 1; i <= n_points; i++) {
         if (i > ECMULT_PIPPENGER_THRESHOLD) {
             int bucket_window = secp256k1_pippenger_bucket_window(i);
-            size_t scratch_size = secp256k1_pippenger_scratch_size(i, bucket_window);
+            size_t scratch_size = secp256k1_pippenger_scratch_size(i, bucket_window, 1);
             scratch = secp256k1_scratch_create(&CTX->error_callback, scratch_size + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT);
         } else {
             size_t scratch_size = secp256k1_strauss_scratch_size(i);
@@ -5295,9 +5923,276 @@ static void test_ecmult_multi_batching(void) {
     free(pt);
 }
 
+typedef struct {
+    size_t n_calls;
+    size_t n_tasks;
+} ecmult_multi_executor_data;
+
+/* Runs the tasks on the calling thread in reverse order. */
+static void ecmult_multi_test_executor(secp256k1_task_function task, void *task_data, size_t n_tasks, void *executor_data) {
+    ecmult_multi_executor_data *data = (ecmult_multi_executor_data *)executor_data;
+    size_t i;
+    data->n_calls++;
+    data->n_tasks += n_tasks;
+    for (i = n_tasks; i > 0; i--) {
+        task(i - 1, task_data);
+    }
+}
+
+/* Checks that splitting Pippenger's algorithm into tasks run by an executor
+ * does not change the result. */
+static void test_ecmult_multi_executor(void) {
+    enum { N_POINTS = 300 };
+    secp256k1_scratch *scratch;
+    ecmult_multi_executor_data executor_data = {0, 0};
+    secp256k1_scalar sc[N_POINTS];
+    secp256k1_ge pt[N_POINTS];
+    secp256k1_scalar g_sc;
+    secp256k1_gej expected, computed;
+    ecmult_multi_data data;
+    size_t n_tasks = 2 + secp256k1_testrand_int(8);
+    size_t max_points;
+    int i;
+
+    data.sc = sc;
+    data.pt = pt;
+    random_scalar_order(&g_sc);
+    for (i = 0; i < N_POINTS; i++) {
+        random_scalar_order(&sc[i]);
+        random_group_element_test(&pt[i]);
+    }
+    CHECK(secp256k1_ecmult_multi_simple_var(&expected, &g_sc, ecmult_multi_callback, &data, N_POINTS));
+
+    scratch = secp256k1_scratch_create(&CTX->error_callback, secp256k1_pippenger_scratch_size(N_POINTS, secp256k1_pippenger_bucket_window(N_POINTS), n_tasks) + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT);
+    max_points = secp256k1_pippenger_max_points(&CTX->error_callback, scratch);
+    secp256k1_scratch_set_executor(&CTX->error_callback, scratch, ecmult_multi_test_executor, &executor_data, n_tasks);
+    /* Every task needs its own buckets, so fewer points fit. */
+    CHECK(secp256k1_pippenger_max_points(&CTX->error_callback, scratch) <= max_points);
+    CHECK(secp256k1_pippenger_max_points(&CTX->error_callback, scratch) >= N_POINTS);
+
+    CHECK(secp256k1_ecmult_pippenger_batch_single(&CTX->error_callback, scratch, &computed, &g_sc, ecmult_multi_callback, &data, N_POINTS));
+    CHECK(secp256k1_gej_eq_var(&computed, &expected));
+    CHECK(executor_data.n_calls == 1);
+    CHECK(executor_data.n_tasks == n_tasks);
+
+    CHECK(secp256k1_ecmult_multi_var(&CTX->error_callback, scratch, &computed, &g_sc, ecmult_multi_callback, &data, N_POINTS));
+    CHECK(secp256k1_gej_eq_var(&computed, &expected));
+
+    /* Disabling the executor runs everything on the calling thread. */
+    secp256k1_scratch_set_executor(&CTX->error_callback, scratch, ecmult_multi_test_executor, &executor_data, 1);
+    CHECK(secp256k1_pippenger_max_points(&CTX->error_callback, scratch) == max_points);
+    executor_data.n_calls = 0;
+    CHECK(secp256k1_ecmult_pippenger_batch_single(&CTX->error_callback, scratch, &computed, &g_sc, ecmult_multi_callback, &data, N_POINTS));
+    CHECK(secp256k1_gej_eq_var(&computed, &expected));
+    CHECK(executor_data.n_calls == 0);
+
+    secp256k1_scratch_destroy(&CTX->error_callback, scratch);
+}
+
+/* Checks Pippenger's algorithm with enough points to accumulate the buckets in
+ * affine coordinates. If degenerate is set, many points repeat (possibly
+ * negated), which exercises the doubling, cancellation and Jacobian fallback
+ * cases. */
+static void test_ecmult_multi_affine_buckets(int degenerate) {
+    size_t n_points = secp256k1_pippenger_bucket_window_inv(ECMULT_PIPPENGER_AFFINE_MIN_WINDOW - 1) + 1 + secp256k1_testrand_int(64);
+    int bucket_window = secp256k1_pippenger_bucket_window(n_points);
+    size_t n_tasks = 1 + secp256k1_testrand_int(4);
+    ecmult_multi_executor_data executor_data = {0, 0};
+    secp256k1_scalar *sc = (secp256k1_scalar *)checked_malloc(&CTX->error_callback, sizeof(secp256k1_scalar) * n_points);
+    secp256k1_ge *pt = (secp256k1_ge *)checked_malloc(&CTX->error_callback, sizeof(secp256k1_ge) * n_points);
+    secp256k1_scratch *scratch;
+    secp256k1_scalar g_sc;
+    secp256k1_gej expected, computed;
+    ecmult_multi_data data;
+    size_t i;
+
+    CHECK(secp256k1_pippenger_affine_buckets(bucket_window));
+    data.sc = sc;
+    data.pt = pt;
+    random_scalar_order(&g_sc);
+    for (i = 0; i < n_points; i++) {
+        if (degenerate && i > 0 && secp256k1_testrand_int(4) != 0) {
+            size_t j = secp256k1_testrand_int(i < 4 ? i : 4);
+            pt[i] = pt[j];
+            sc[i] = sc[j];
+            if (secp256k1_testrand_bits(1)) {
+                secp256k1_ge_neg(&pt[i], &pt[i]);
+            }
+            if (secp256k1_testrand_bits(1)) {
+                random_scalar_order(&sc[i]);
+            }
+        } else {
+            random_scalar_order(&sc[i]);
+            random_group_element_test(&pt[i]);
+        }
+    }
+    CHECK(secp256k1_ecmult_multi_simple_var(&expected, &g_sc, ecmult_multi_callback, &data, n_points));
+
+    scratch = secp256k1_scratch_create(&CTX->error_callback, secp256k1_pippenger_scratch_size(n_points, bucket_window, n_tasks) + PIPPENGER_SCRATCH_OBJECTS*ALIGNMENT);
+    secp256k1_scratch_set_executor(&CTX->error_callback, scratch, ecmult_multi_test_executor, &executor_data, n_tasks);
+    CHECK(secp256k1_pippenger_max_points(&CTX->error_callback, scratch) >= n_points);
+    CHECK(secp256k1_ecmult_pippenger_batch_single(&CTX->error_callback, scratch, &computed, &g_sc, ecmult_multi_callback, &data, n_points));
+    CHECK(secp256k1_gej_eq_var(&computed, &expected));
+    CHECK(executor_data.n_tasks == (n_tasks == 1 ? 0 : n_tasks));
+
+    secp256k1_scratch_destroy(&CTX->error_callback, scratch);
+    free(sc);
+    free(pt);
+}
+
+/* A timer for which every call takes a random amount of time. */
+static double ecmult_multi_test_timer(void *data) {
+    double *t = (double *)data;
+    *t += 1 + secp256k1_testrand_int(100);
+    return *t;
+}
+
+static void test_ecmult_multi_tuning(void) {
+    secp256k1_scratch_space *scratch = secp256k1_scratch_space_create(CTX, 819200);
+    secp256k1_ecmult_multi_tuning tuning, tuning2;
+    size_t max_points = secp256k1_pippenger_max_points(&CTX->error_callback, scratch);
+    size_t n;
+    double t = 0;
+    int64_t todo;
+    int i;
+
+    /* The default tuning matches the built-in tables. */
+    secp256k1_ecmult_multi_tuning_default(CTX, &tuning);
+    CHECK(tuning.pippenger_threshold == ECMULT_PIPPENGER_THRESHOLD);
+    CHECK(secp256k1_scratch_space_set_tuning(CTX, scratch, &tuning) == 1);
+    CHECK(scratch->has_tuning);
+    for (n = 0; n < 20000; n += 1 + n/8) {
+        CHECK(secp256k1_pippenger_scratch_bucket_window(scratch, n) == secp256k1_pippenger_bucket_window(n));
+    }
+    for (i = 1; i <= PIPPENGER_MAX_BUCKET_WINDOW; i++) {
+        CHECK(secp256k1_pippenger_scratch_bucket_window_inv(scratch, i) == secp256k1_pippenger_bucket_window_inv(i));
+    }
+    CHECK(secp256k1_pippenger_max_points(&CTX->error_callback, scratch) == max_points);
+
+    /* Invalid tunings are rejected and leave the scratch space unchanged. */
+    tuning2 = tuning;
+    tuning2.bucket_window_max_points[3] = tuning2.bucket_window_max_points[2] - 1;
+    CHECK(secp256k1_scratch_space_set_tuning(CTX, scratch, &tuning2) == 0);
+    CHECK(memcmp(&scratch->tuning, &tuning, sizeof(tuning)) == 0);
+    CHECK_ILLEGAL(CTX, secp256k1_scratch_space_set_tuning(CTX, NULL, &tuning));
+    CHECK_ILLEGAL_VOID(CTX, secp256k1_ecmult_multi_tuning_default(CTX, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_ecmult_multi_calibrate(CTX, NULL, 16, ecmult_multi_test_timer, &t));
+    CHECK_ILLEGAL(CTX, secp256k1_ecmult_multi_calibrate(CTX, &tuning2, 0, ecmult_multi_test_timer, &t));
+    CHECK_ILLEGAL(CTX, secp256k1_ecmult_multi_calibrate(CTX, &tuning2, ECMULT_MAX_POINTS_PER_BATCH + 1, ecmult_multi_test_timer, &t));
+    CHECK_ILLEGAL(CTX, secp256k1_ecmult_multi_calibrate(CTX, &tuning2, 16, NULL, &t));
+
+    /* Calibrating with a random timer results in a valid tuning. */
+    CHECK(secp256k1_ecmult_multi_calibrate(CTX, &tuning2, 1 + secp256k1_testrand_int(64), ecmult_multi_test_timer, &t) == 1);
+    CHECK(secp256k1_scratch_space_set_tuning(CTX, scratch, &tuning2) == 1);
+    test_ecmult_multi(scratch, secp256k1_ecmult_multi_var);
+
+    /* Any valid tuning gives correct results. */
+    tuning2.pippenger_threshold = secp256k1_testrand_int(200);
+    n = 0;
+    for (i = 0; i < PIPPENGER_MAX_BUCKET_WINDOW - 1; i++) {
+        n += secp256k1_testrand_int(64);
+        tuning2.bucket_window_max_points[i] = n;
+    }
+    CHECK(secp256k1_scratch_space_set_tuning(CTX, scratch, &tuning2) == 1);
+    test_ecmult_multi(scratch, secp256k1_ecmult_multi_var);
+    test_ecmult_multi(scratch, secp256k1_ecmult_pippenger_batch_single);
+    todo = (int64_t)40 * COUNT;
+    while (todo > 0) {
+        todo -= test_ecmult_multi_random(scratch);
+    }
+
+    /* A NULL tuning restores the defaults. */
+    CHECK(secp256k1_scratch_space_set_tuning(CTX, scratch, NULL) == 1);
+    CHECK(!scratch->has_tuning);
+    CHECK(secp256k1_pippenger_max_points(&CTX->error_callback, scratch) == max_points);
+
+    secp256k1_scratch_space_destroy(CTX, scratch);
+}
+
+/* Checks that coalescing repeated points does not change the result. */
+static void test_ecmult_multi_dedup(void) {
+    enum { N_POINTS = 200 };
+    secp256k1_scratch *scratch = secp256k1_scratch_create(&CTX->error_callback, secp256k1_testrand_int(1 << 17));
+    secp256k1_scalar sc[N_POINTS], dedup_sc[N_POINTS];
+    secp256k1_ge pt[N_POINTS], dedup_pt[N_POINTS];
+    size_t table[2];
+    secp256k1_scalar g_sc;
+    secp256k1_gej expected, computed;
+    ecmult_multi_data data;
+    size_t n_distinct = 0;
+    size_t n = secp256k1_testrand_int(N_POINTS + 1);
+    size_t n_unique = 1 + secp256k1_testrand_int(8);
+    size_t i;
+
+    data.sc = sc;
+    data.pt = pt;
+    random_scalar_order(&g_sc);
+    for (i = 0; i < n; i++) {
+        random_scalar_order(&sc[i]);
+        if (i >= n_unique && secp256k1_testrand_int(8) != 0) {
+            pt[i] = pt[secp256k1_testrand_int(n_unique)];
+            if (secp256k1_testrand_bits(1)) {
+                secp256k1_ge_neg(&pt[i], &pt[i]);
+            }
+            if (secp256k1_testrand_int(4) == 0) {
+                /* Make some terms cancel out. */
+                secp256k1_scalar_negate(&sc[i], &sc[i - 1]);
+                pt[i] = pt[i - 1];
+            }
+        } else {
+            random_group_element_test(&pt[i]);
+        }
+    }
+    CHECK(secp256k1_ecmult_multi_simple_var(&expected, &g_sc, ecmult_multi_callback, &data, n));
+
+    secp256k1_scratch_set_dedup(&CTX->error_callback, scratch, 1);
+    CHECK(scratch->dedup == 1);
+    CHECK(secp256k1_ecmult_multi_var(&CTX->error_callback, scratch, &computed, &g_sc, ecmult_multi_callback, &data, n));
+    CHECK(secp256k1_gej_eq_var(&computed, &expected));
+    CHECK(secp256k1_scratch_checkpoint(&CTX->error_callback, scratch) == 0);
+    test_ecmult_multi(scratch, secp256k1_ecmult_multi_var);
+
+    /* Repeated points are coalesced into one term each. */
+    CHECK(secp256k1_ecmult_multi_dedup(dedup_sc, dedup_pt, &n_distinct, table, 1, ecmult_multi_callback, &data, 0, 0));
+    CHECK(n_distinct == 0);
+    for (i = 0; i < n_unique && i < n; i++) {
+        pt[i + n_unique] = pt[i];
+        secp256k1_ge_neg(&pt[i + 2*n_unique], &pt[i]);
+    }
+    if (n >= 3*n_unique) {
+        size_t *big_table = (size_t *)checked_malloc(&CTX->error_callback, secp256k1_ecmult_multi_dedup_slots(n) * sizeof(size_t));
+        CHECK(secp256k1_ecmult_multi_dedup(dedup_sc, dedup_pt, &n_distinct, big_table, secp256k1_ecmult_multi_dedup_slots(n), ecmult_multi_callback, &data, 3*n_unique, 0));
+        CHECK(n_distinct <= n_unique);
+        free(big_table);
+    }
+
+    /* With a hash table that is too small, points that are not found within
+     * the probe limit are kept as separate terms. */
+    CHECK(secp256k1_ecmult_multi_simple_var(&expected, &g_sc, ecmult_multi_callback, &data, n));
+    CHECK(secp256k1_ecmult_multi_dedup(dedup_sc, dedup_pt, &n_distinct, table, 2, ecmult_multi_callback, &data, n, 0));
+    data.sc = dedup_sc;
+    data.pt = dedup_pt;
+    CHECK(secp256k1_ecmult_multi_simple_var(&computed, &g_sc, ecmult_multi_callback, &data, n_distinct));
+    CHECK(secp256k1_gej_eq_var(&computed, &expected));
+
+    /* A failing callback makes the multiplication fail. */
+    data.sc = sc;
+    data.pt = pt;
+    if (n > 1) {
+        CHECK(!secp256k1_ecmult_multi_var(&CTX->error_callback, scratch, &computed, &g_sc, ecmult_multi_false_callback, &data, n));
+        CHECK(secp256k1_scratch_checkpoint(&CTX->error_callback, scratch) == 0);
+    }
+
+    secp256k1_scratch_set_dedup(&CTX->error_callback, scratch, 0);
+    CHECK(scratch->dedup == 0);
+    secp256k1_scratch_destroy(&CTX->error_callback, scratch);
+}
+
 static void run_ecmult_multi_tests(void) {
     secp256k1_scratch *scratch;
+    ecmult_multi_executor_data executor_data = {0, 0};
     int64_t todo = (int64_t)320 * COUNT;
+    int i;
 
     test_secp256k1_pippenger_bucket_window_inv();
     test_ecmult_multi_pippenger_max_points();
@@ -5311,7 +6206,23 @@ static void run_ecmult_multi_tests(void) {
     while (todo > 0) {
         todo -= test_ecmult_multi_random(scratch);
     }
+
+    /* Repeat with the work split into tasks. */
+    secp256k1_scratch_set_executor(&CTX->error_callback, scratch, ecmult_multi_test_executor, &executor_data, 2 + secp256k1_testrand_int(7));
+    test_ecmult_multi(scratch, secp256k1_ecmult_multi_var);
+    test_ecmult_multi(scratch, secp256k1_ecmult_pippenger_batch_single);
+    todo = (int64_t)80 * COUNT;
+    while (todo > 0) {
+        todo -= test_ecmult_multi_random(scratch);
+    }
     secp256k1_scratch_destroy(&CTX->error_callback, scratch);
+    test_ecmult_multi_executor();
+    test_ecmult_multi_affine_buckets(0);
+    test_ecmult_multi_affine_buckets(1);
+    test_ecmult_multi_tuning();
+    for (i = 0; i < COUNT; i++) {
+        test_ecmult_multi_dedup();
+    }
 
     /* Run test_ecmult_multi with space for exactly one point */
     scratch = secp256k1_scratch_create(&CTX->error_callback, secp256k1_strauss_scratch_size(1) + STRAUSS_SCRATCH_OBJECTS*ALIGNMENT);
@@ -5322,6 +6233,120 @@ static void run_ecmult_multi_tests(void) {
     test_ecmult_multi_batching();
 }
 
+typedef struct {
+    unsigned char (*scalar32)[32];
+    secp256k1_pubkey *pubkey;
+    size_t fail_idx;
+} ecmult_multi_pubkey_data;
+
+static int ecmult_multi_pubkey_callback(unsigned char *scalar32, secp256k1_pubkey *pubkey, size_t idx, void *cbdata) {
+    ecmult_multi_pubkey_data *data = (ecmult_multi_pubkey_data *)cbdata;
+    if (idx == data->fail_idx) {
+        return 0;
+    }
+    memcpy(scalar32, data->scalar32[idx], 32);
+    *pubkey = data->pubkey[idx];
+    return 1;
+}
+
+/* Compares secp256k1_ecmult_multi against tweak_mul and combine. */
+static void test_ecmult_multi_pubkey(void) {
+    enum { N_MAX = 64 };
+    unsigned char scalar32[N_MAX + 1][32];
+    secp256k1_pubkey pubkey[N_MAX + 1];
+    secp256k1_pubkey result, expected, tmp;
+    ecmult_multi_pubkey_data data;
+    secp256k1_scratch_space *scratch;
+    unsigned char overflow32[32];
+    const unsigned char zeros[sizeof(secp256k1_pubkey)] = {0};
+    ecmult_multi_executor_data executor_data = {0, 0};
+    size_t n = secp256k1_testrand_int(N_MAX + 1);
+    size_t i;
+
+    data.scalar32 = scalar32;
+    data.pubkey = pubkey;
+    data.fail_idx = n;
+    for (i = 0; i <= n; i++) {
+        secp256k1_scalar sc;
+        secp256k1_ge pt;
+        random_scalar_order_test(&sc);
+        secp256k1_scalar_get_b32(scalar32[i], &sc);
+        random_group_element_test(&pt);
+        secp256k1_pubkey_save(&pubkey[i], &pt);
+    }
+    /* The generator scalar is scalar32[n]. */
+    CHECK(secp256k1_ec_pubkey_create(CTX, &expected, scalar32[n]) == 1);
+    for (i = 0; i < n; i++) {
+        const secp256k1_pubkey *ins[2];
+        secp256k1_pubkey sum;
+        tmp = pubkey[i];
+        CHECK(secp256k1_ec_pubkey_tweak_mul(CTX, &tmp, scalar32[i]) == 1);
+        ins[0] = &expected;
+        ins[1] = &tmp;
+        /* Fails only with negligible probability. */
+        CHECK(secp256k1_ec_pubkey_combine(CTX, &sum, ins, 2) == 1);
+        expected = sum;
+    }
+
+    scratch = secp256k1_scratch_space_create(CTX, secp256k1_testrand_int(1 << 16));
+    if (secp256k1_testrand_bits(1)) {
+        secp256k1_scratch_space_set_executor(CTX, scratch, ecmult_multi_test_executor, &executor_data, secp256k1_testrand_int(8));
+    }
+    CHECK(secp256k1_ecmult_multi(CTX, scratch, &result, scalar32[n], ecmult_multi_pubkey_callback, &data, n) == 1);
+    CHECK(secp256k1_memcmp_var(&result, &expected, sizeof(result)) == 0);
+    CHECK(secp256k1_ecmult_multi(CTX, NULL, &result, scalar32[n], ecmult_multi_pubkey_callback, &data, n) == 1);
+    CHECK(secp256k1_memcmp_var(&result, &expected, sizeof(result)) == 0);
+
+    if (n > 0) {
+        /* A failing callback or an overflowing scalar makes the call fail. */
+        data.fail_idx = secp256k1_testrand_int(n);
+        CHECK(secp256k1_ecmult_multi(CTX, scratch, &result, scalar32[n], ecmult_multi_pubkey_callback, &data, n) == 0);
+        CHECK(secp256k1_memcmp_var(&result, zeros, sizeof(result)) == 0);
+        data.fail_idx = n;
+        i = secp256k1_testrand_int(n);
+        memset(scalar32[i], 0xFF, 32);
+        CHECK(secp256k1_ecmult_multi(CTX, scratch, &result, scalar32[n], ecmult_multi_pubkey_callback, &data, n) == 0);
+    }
+    memset(overflow32, 0xFF, 32);
+    CHECK(secp256k1_ecmult_multi(CTX, scratch, &result, overflow32, ecmult_multi_pubkey_callback, &data, 0) == 0);
+
+    secp256k1_scratch_space_destroy(CTX, scratch);
+}
+
+static void run_ecmult_multi_pubkey_tests(void) {
+    secp256k1_pubkey result, pubkeys[2];
+    secp256k1_scalar sc;
+    unsigned char scalar32[2][32];
+    ecmult_multi_pubkey_data data;
+    int i;
+
+    /* Zero terms and no generator scalar give the point at infinity. */
+    CHECK(secp256k1_ecmult_multi(CTX, NULL, &result, NULL, NULL, NULL, 0) == 0);
+    CHECK_ILLEGAL(CTX, secp256k1_ecmult_multi(CTX, NULL, NULL, NULL, NULL, NULL, 0));
+    CHECK_ILLEGAL(CTX, secp256k1_ecmult_multi(CTX, NULL, &result, NULL, NULL, NULL, 1));
+    CHECK_ILLEGAL_VOID(CTX, secp256k1_scratch_space_set_executor(CTX, NULL, NULL, NULL, 0));
+    CHECK_ILLEGAL_VOID(CTX, secp256k1_scratch_space_set_dedup(CTX, NULL, 1));
+
+    /* x*P + (-x)*P is infinity. */
+    random_scalar_order_test(&sc);
+    secp256k1_scalar_get_b32(scalar32[0], &sc);
+    secp256k1_scalar_negate(&sc, &sc);
+    secp256k1_scalar_get_b32(scalar32[1], &sc);
+    CHECK(secp256k1_ec_pubkey_create(CTX, &pubkeys[0], scalar32[0]) == 1);
+    pubkeys[1] = pubkeys[0];
+    data.scalar32 = scalar32;
+    data.pubkey = pubkeys;
+    data.fail_idx = 2;
+    CHECK(secp256k1_ecmult_multi(CTX, NULL, &result, NULL, ecmult_multi_pubkey_callback, &data, 2) == 0);
+    /* An invalid public key is an illegal argument. */
+    memset(&pubkeys[1], 0, sizeof(pubkeys[1]));
+    CHECK_ILLEGAL(CTX, secp256k1_ecmult_multi(CTX, NULL, &result, NULL, ecmult_multi_pubkey_callback, &data, 2));
+
+    for (i = 0; i < COUNT; i++) {
+        test_ecmult_multi_pubkey();
+    }
+}
+
 static void test_wnaf(const secp256k1_scalar *number, int w) {
     secp256k1_scalar x, two, t;
     int wnaf[256];
@@ -6323,6 +7348,106 @@ static void run_eckey_edge_case_test(void) {
     CHECK(secp256k1_memcmp_var(&pubkey, zeros, sizeof(secp256k1_pubkey)) > 0);
 }
 
+static void run_ec_pubkey_create_sequence_test(void) {
+    unsigned char seckey[32], step32[32], key[32];
+    secp256k1_pubkey pubkeys[70], pubkey;
+    const unsigned char zeros[sizeof(secp256k1_pubkey)] = {0};
+    secp256k1_scalar k, step;
+    size_t n = 1 + secp256k1_testrand_int(70);
+    size_t i, zero_pos;
+
+    random_scalar_order(&k);
+    random_scalar_order(&step);
+    secp256k1_scalar_get_b32(seckey, &k);
+    secp256k1_scalar_get_b32(step32, &step);
+    CHECK(secp256k1_ec_pubkey_create_sequence(CTX, pubkeys, seckey, step32, n) == 1);
+    for (i = 0; i < n; i++) {
+        secp256k1_scalar_get_b32(key, &k);
+        CHECK(secp256k1_ec_pubkey_create(CTX, &pubkey, key) == 1);
+        CHECK(secp256k1_memcmp_var(&pubkey, &pubkeys[i], sizeof(pubkey)) == 0);
+        secp256k1_scalar_add(&k, &k, &step);
+    }
+
+    /* A NULL step is a step of 1. The sequence wraps around the group order
+     * and the public key for the zero secret key is zeroed out. */
+    zero_pos = secp256k1_testrand_int(n);
+    secp256k1_scalar_set_int(&k, zero_pos);
+    secp256k1_scalar_negate(&k, &k);
+    if (zero_pos == 0) {
+        secp256k1_scalar_set_int(&k, 1);
+        zero_pos = n;
+    }
+    secp256k1_scalar_get_b32(seckey, &k);
+    CHECK(secp256k1_ec_pubkey_create_sequence(CTX, pubkeys, seckey, NULL, n) == (zero_pos == n));
+    for (i = 0; i < n; i++) {
+        if (i == zero_pos) {
+            CHECK(secp256k1_memcmp_var(&pubkeys[i], zeros, sizeof(pubkeys[i])) == 0);
+        } else {
+            secp256k1_scalar_get_b32(key, &k);
+            CHECK(secp256k1_ec_pubkey_create(CTX, &pubkey, key) == 1);
+            CHECK(secp256k1_memcmp_var(&pubkey, &pubkeys[i], sizeof(pubkey)) == 0);
+        }
+        secp256k1_scalar_add(&k, &k, &secp256k1_scalar_one);
+    }
+
+    /* An invalid first secret key or step zeroes out all public keys. */
+    memset(step32, secp256k1_testrand_bits(1) ? 0 : 0xff, 32);
+    CHECK(secp256k1_ec_pubkey_create_sequence(CTX, pubkeys, seckey, step32, n) == 0);
+    for (i = 0; i < n; i++) {
+        CHECK(secp256k1_memcmp_var(&pubkeys[i], zeros, sizeof(pubkeys[i])) == 0);
+    }
+    CHECK(secp256k1_ec_pubkey_create_sequence(CTX, pubkeys, step32, NULL, n) == 0);
+    CHECK(secp256k1_memcmp_var(&pubkeys[n - 1], zeros, sizeof(pubkeys[n - 1])) == 0);
+    CHECK(secp256k1_ec_pubkey_create_sequence(CTX, NULL, step32, NULL, 0) == 0);
+    CHECK(secp256k1_ec_pubkey_create_sequence(CTX, NULL, seckey, NULL, 0) == 1);
+
+    /* Illegal arguments. */
+    CHECK_ILLEGAL(STATIC_CTX, secp256k1_ec_pubkey_create_sequence(STATIC_CTX, pubkeys, seckey, NULL, n));
+    CHECK_ILLEGAL(CTX, secp256k1_ec_pubkey_create_sequence(CTX, NULL, seckey, NULL, n));
+    CHECK_ILLEGAL(CTX, secp256k1_ec_pubkey_create_sequence(CTX, pubkeys, NULL, NULL, n));
+}
+
+static void run_ec_pubkey_create_batch_test(void) {
+    unsigned char seckeys[70][32];
+    const unsigned char *seckey_ptrs[70];
+    secp256k1_pubkey pubkeys[70], pubkey;
+    const unsigned char zeros[sizeof(secp256k1_pubkey)] = {0};
+    size_t n = 1 + secp256k1_testrand_int(70);
+    size_t i, invalid;
+
+    for (i = 0; i < 70; i++) {
+        random_scalar_order_b32(seckeys[i]);
+        seckey_ptrs[i] = seckeys[i];
+    }
+    CHECK(secp256k1_ec_pubkey_create_batch(CTX, pubkeys, seckey_ptrs, n) == 1);
+    for (i = 0; i < n; i++) {
+        CHECK(secp256k1_ec_pubkey_create(CTX, &pubkey, seckeys[i]) == 1);
+        CHECK(secp256k1_memcmp_var(&pubkey, &pubkeys[i], sizeof(pubkey)) == 0);
+    }
+    CHECK(secp256k1_ec_pubkey_create_batch(CTX, NULL, NULL, 0) == 1);
+
+    /* An invalid secret key only zeroes its own public key. */
+    invalid = secp256k1_testrand_int(n);
+    memset(seckeys[invalid], secp256k1_testrand_bits(1) ? 0 : 0xff, 32);
+    CHECK(secp256k1_ec_pubkey_create_batch(CTX, pubkeys, seckey_ptrs, n) == 0);
+    for (i = 0; i < n; i++) {
+        if (i == invalid) {
+            CHECK(secp256k1_memcmp_var(&pubkeys[i], zeros, sizeof(pubkeys[i])) == 0);
+        } else {
+            CHECK(secp256k1_ec_pubkey_create(CTX, &pubkey, seckeys[i]) == 1);
+            CHECK(secp256k1_memcmp_var(&pubkey, &pubkeys[i], sizeof(pubkey)) == 0);
+        }
+    }
+
+    /* Illegal arguments. */
+    CHECK_ILLEGAL(STATIC_CTX, secp256k1_ec_pubkey_create_batch(STATIC_CTX, pubkeys, seckey_ptrs, n));
+    CHECK_ILLEGAL(CTX, secp256k1_ec_pubkey_create_batch(CTX, NULL, seckey_ptrs, n));
+    CHECK_ILLEGAL(CTX, secp256k1_ec_pubkey_create_batch(CTX, pubkeys, NULL, n));
+    seckey_ptrs[secp256k1_testrand_int(n)] = NULL;
+    CHECK_ILLEGAL(CTX, secp256k1_ec_pubkey_create_batch(CTX, pubkeys, seckey_ptrs, n));
+    CHECK(secp256k1_memcmp_var(&pubkeys[0], zeros, sizeof(pubkeys[0])) == 0);
+}
+
 static void run_eckey_negate_test(void) {
     unsigned char seckey[32];
     unsigned char seckey_tmp[32];
@@ -6386,10 +7511,10 @@ static void test_ecdsa_sign_verify(void) {
     } else {
         random_sign(&sigr, &sigs, &key, &msg, NULL);
     }
-    CHECK(secp256k1_ecdsa_sig_verify(&sigr, &sigs, &pub, &msg));
+    CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sigr, &sigs, &pub, &msg));
     secp256k1_scalar_set_int(&one, 1);
     secp256k1_scalar_add(&msg, &msg, &one);
-    CHECK(!secp256k1_ecdsa_sig_verify(&sigr, &sigs, &pub, &msg));
+    CHECK(!secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sigr, &sigs, &pub, &msg));
 }
 
 static void run_ecdsa_sign_verify(void) {
@@ -6399,6 +7524,159 @@ static void run_ecdsa_sign_verify(void) {
     }
 }
 
+static void test_ecdsa_verify_batch_api(void) {
+    secp256k1_scalar key, msg, sigr, sigs;
+    secp256k1_gej pubj;
+    secp256k1_ge pub;
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey pubkey, zero_pubkey;
+    unsigned char msg32[32];
+    int recid, bad_recid = 4;
+    const secp256k1_ecdsa_signature *sig_ptr = &sig;
+    const secp256k1_ecdsa_signature *null_sig_ptr = NULL;
+    const unsigned char *msg_ptr = msg32;
+    const unsigned char *null_msg_ptr = NULL;
+    const secp256k1_pubkey *pubkey_ptr = &pubkey;
+    const secp256k1_pubkey *zero_pubkey_ptr = &zero_pubkey;
+
+    random_scalar_order_test(&key);
+    secp256k1_testrand256(msg32);
+    secp256k1_scalar_set_b32(&msg, msg32, NULL);
+    random_sign(&sigr, &sigs, &key, &msg, &recid);
+    secp256k1_ecdsa_signature_save(&sig, &sigr, &sigs);
+    secp256k1_ecmult_gen(&CTX->ecmult_gen_ctx, &pubj, &key);
+    secp256k1_ge_set_gej(&pub, &pubj);
+    secp256k1_pubkey_save(&pubkey, &pub);
+    memset(&zero_pubkey, 0, sizeof(zero_pubkey));
+
+    CHECK(secp256k1_ecdsa_verify_batch(CTX, NULL, &sig_ptr, &msg_ptr, &pubkey_ptr, &recid, 1) == 1);
+    CHECK(secp256k1_ecdsa_verify_batch(CTX, NULL, &sig_ptr, &msg_ptr, &pubkey_ptr, NULL, 1) == 1);
+    CHECK(secp256k1_ecdsa_verify_batch(CTX, NULL, NULL, NULL, NULL, NULL, 0) == 1);
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_verify_batch(CTX, NULL, NULL, &msg_ptr, &pubkey_ptr, &recid, 1));
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_verify_batch(CTX, NULL, &sig_ptr, NULL, &pubkey_ptr, &recid, 1));
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_verify_batch(CTX, NULL, &sig_ptr, &msg_ptr, NULL, &recid, 1));
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_verify_batch(CTX, NULL, &null_sig_ptr, &msg_ptr, &pubkey_ptr, &recid, 1));
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_verify_batch(CTX, NULL, &sig_ptr, &null_msg_ptr, &pubkey_ptr, &recid, 1));
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_verify_batch(CTX, NULL, &sig_ptr, &msg_ptr, &zero_pubkey_ptr, &recid, 1));
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_verify_batch(CTX, NULL, &sig_ptr, &msg_ptr, &pubkey_ptr, &bad_recid, 1));
+}
+
+/* Checks that ecdsa_verify_batch agrees with ecdsa_verify on batches of random
+ * sizes with at most one invalid signature or wrong recovery id, for various
+ * scratch space sizes. */
+static void test_ecdsa_verify_batch(void) {
+    enum { N_MAX = 40 };
+    secp256k1_ecdsa_signature sig[N_MAX];
+    unsigned char msg[N_MAX][32];
+    secp256k1_pubkey pubkey[N_MAX];
+    int recid[N_MAX];
+    const secp256k1_ecdsa_signature *sig_ptr[N_MAX];
+    const unsigned char *msg_ptr[N_MAX];
+    const secp256k1_pubkey *pubkey_ptr[N_MAX];
+    secp256k1_scratch_space *scratch;
+    secp256k1_scalar sigr, sigs;
+    size_t n = 1 + secp256k1_testrand_int(N_MAX);
+    size_t i, bad;
+    int expected;
+
+    for (i = 0; i < n; i++) {
+        secp256k1_scalar key, m;
+        secp256k1_gej pubj;
+        secp256k1_ge pub;
+        random_scalar_order_test(&key);
+        secp256k1_testrand256(msg[i]);
+        secp256k1_scalar_set_b32(&m, msg[i], NULL);
+        random_sign(&sigr, &sigs, &key, &m, &recid[i]);
+        secp256k1_ecdsa_signature_save(&sig[i], &sigr, &sigs);
+        secp256k1_ecmult_gen(&CTX->ecmult_gen_ctx, &pubj, &key);
+        secp256k1_ge_set_gej(&pub, &pubj);
+        secp256k1_pubkey_save(&pubkey[i], &pub);
+        sig_ptr[i] = &sig[i];
+        msg_ptr[i] = msg[i];
+        pubkey_ptr[i] = &pubkey[i];
+    }
+    scratch = secp256k1_scratch_space_create(CTX, secp256k1_testrand_int(1 << 16));
+
+    bad = secp256k1_testrand_int(n);
+    expected = 0;
+    switch (secp256k1_testrand_int(6)) {
+        case 0:
+            msg[bad][secp256k1_testrand_int(32)] ^= 1 + secp256k1_testrand_int(255);
+            break;
+        case 1:
+            /* s is not in lower-S form */
+            secp256k1_ecdsa_signature_load(CTX, &sigr, &sigs, &sig[bad]);
+            secp256k1_scalar_negate(&sigs, &sigs);
+            secp256k1_ecdsa_signature_save(&sig[bad], &sigr, &sigs);
+            break;
+        case 2:
+            /* A wrong hint does not affect the result. */
+            recid[bad] ^= 1 + secp256k1_testrand_int(3);
+            expected = 1;
+            break;
+        case 3:
+            /* Signature of a different key. */
+            pubkey_ptr[bad] = &pubkey[(bad + 1) % n];
+            expected = (n == 1);
+            break;
+        default:
+            expected = 1;
+    }
+    CHECK(secp256k1_ecdsa_verify_batch(CTX, scratch, sig_ptr, msg_ptr, pubkey_ptr, recid, n) == expected);
+    CHECK(secp256k1_ecdsa_verify_batch(CTX, NULL, sig_ptr, msg_ptr, pubkey_ptr, recid, n) == expected);
+    CHECK(secp256k1_ecdsa_verify_batch(CTX, scratch, sig_ptr, msg_ptr, pubkey_ptr, NULL, n) == expected);
+    for (i = 0; i < n; i++) {
+        CHECK(secp256k1_ecdsa_verify(CTX, sig_ptr[i], msg_ptr[i], pubkey_ptr[i]) == (expected || i != bad));
+    }
+
+    secp256k1_scratch_space_destroy(CTX, scratch);
+}
+
+static void run_ecdsa_verify_prepared(void) {
+    secp256k1_scalar key, msg, sigr, sigs;
+    secp256k1_gej pubj;
+    secp256k1_ge pub;
+    secp256k1_ecdsa_signature sig;
+    secp256k1_pubkey pubkey, zero_pubkey;
+    secp256k1_pubkey_prepared *prepared;
+    unsigned char msg32[32];
+
+    random_scalar_order_test(&key);
+    secp256k1_testrand256(msg32);
+    secp256k1_scalar_set_b32(&msg, msg32, NULL);
+    random_sign(&sigr, &sigs, &key, &msg, NULL);
+    secp256k1_ecdsa_signature_save(&sig, &sigr, &sigs);
+    secp256k1_ecmult_gen(&CTX->ecmult_gen_ctx, &pubj, &key);
+    secp256k1_ge_set_gej(&pub, &pubj);
+    secp256k1_pubkey_save(&pubkey, &pub);
+    memset(&zero_pubkey, 0, sizeof(zero_pubkey));
+
+    CHECK_ILLEGAL(CTX, secp256k1_pubkey_prepared_create(CTX, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_pubkey_prepared_create(CTX, &zero_pubkey));
+    prepared = secp256k1_pubkey_prepared_create(CTX, &pubkey);
+    CHECK(prepared != NULL);
+    CHECK(secp256k1_ecdsa_verify_prepared(CTX, &sig, msg32, prepared) == 1);
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_verify_prepared(CTX, NULL, msg32, prepared));
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_verify_prepared(CTX, &sig, NULL, prepared));
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_verify_prepared(CTX, &sig, msg32, NULL));
+
+    /* Signatures in high-S form are rejected. */
+    secp256k1_scalar_negate(&sigs, &sigs);
+    secp256k1_ecdsa_signature_save(&sig, &sigr, &sigs);
+    CHECK(secp256k1_ecdsa_verify_prepared(CTX, &sig, msg32, prepared) == 0);
+
+    secp256k1_pubkey_prepared_destroy(CTX, prepared);
+    secp256k1_pubkey_prepared_destroy(CTX, NULL);
+}
+
+static void run_ecdsa_verify_batch(void) {
+    int i;
+    test_ecdsa_verify_batch_api();
+    for (i = 0; i < COUNT; i++) {
+        test_ecdsa_verify_batch();
+    }
+}
+
 /** Dummy nonce generation function that just uses a precomputed nonce, and fails if it is not accepted. Use only for testing. */
 static int precomputed_nonce_function(unsigned char *nonce32, const unsigned char *msg32, const unsigned char *key32, const unsigned char *algo16, void *data, unsigned int counter) {
     (void)msg32;
@@ -6408,6 +7686,112 @@ static int precomputed_nonce_function(unsigned char *nonce32, const unsigned cha
     return (counter == 0);
 }
 
+static void run_ecdsa_sign_pool(void) {
+    unsigned char seed[32], key[32], msg[32], nonce[32];
+    secp256k1_ecdsa_signature sig, sig2;
+    secp256k1_pubkey pubkey;
+    secp256k1_sign_pool *pool;
+    secp256k1_scalar r, r2, s;
+    size_t capacity = 1 + secp256k1_testrand_int(40);
+    size_t i;
+
+    CHECK_ILLEGAL(CTX, secp256k1_sign_pool_create(CTX, 0));
+    pool = secp256k1_sign_pool_create(CTX, capacity);
+    CHECK(pool != NULL);
+    CHECK(secp256k1_sign_pool_size(CTX, pool) == 0);
+    secp256k1_testrand256(seed);
+    CHECK_ILLEGAL(STATIC_CTX, secp256k1_sign_pool_fill(STATIC_CTX, pool, seed));
+    CHECK(secp256k1_sign_pool_fill(CTX, pool, seed) == 1);
+    CHECK(secp256k1_sign_pool_size(CTX, pool) == capacity);
+
+    /* Every nonce is used once. Signing with an empty pool fails. */
+    random_scalar_order_b32(key);
+    CHECK(secp256k1_ec_pubkey_create(CTX, &pubkey, key) == 1);
+    secp256k1_scalar_clear(&r2);
+    for (i = 0; i < capacity; i++) {
+        secp256k1_testrand256(msg);
+        CHECK(secp256k1_ecdsa_sign_pool(CTX, &sig, msg, key, pool) == 1);
+        CHECK(secp256k1_ecdsa_verify(CTX, &sig, msg, &pubkey) == 1);
+        CHECK(secp256k1_sign_pool_size(CTX, pool) == capacity - i - 1);
+        secp256k1_ecdsa_signature_load(CTX, &r, &s, &sig);
+        CHECK(!secp256k1_scalar_eq(&r, &r2));
+        r2 = r;
+    }
+    CHECK(secp256k1_ecdsa_sign_pool(CTX, &sig, msg, key, pool) == 0);
+
+    /* Filling again with the same seed gives different nonces. */
+    CHECK(secp256k1_sign_pool_fill(CTX, pool, seed) == 1);
+    CHECK(secp256k1_ecdsa_sign_pool(CTX, &sig, msg, key, pool) == 1);
+    secp256k1_ecdsa_signature_load(CTX, &r, &s, &sig);
+    CHECK(!secp256k1_scalar_eq(&r, &r2));
+    CHECK(secp256k1_sign_pool_fill(CTX, pool, seed) == 1);
+    random_scalar_order_b32(nonce);
+    CHECK(secp256k1_sign_pool_add_nonce(CTX, pool, nonce) == 0);
+
+    /* An external nonce gives the same signature as a nonce function that
+     * returns it. */
+    while (secp256k1_sign_pool_size(CTX, pool) > 0) {
+        CHECK(secp256k1_ecdsa_sign_pool(CTX, &sig, msg, key, pool) == 1);
+    }
+    memset(nonce, 0, sizeof(nonce));
+    CHECK(secp256k1_sign_pool_add_nonce(CTX, pool, nonce) == 0);
+    memset(nonce, 0xff, sizeof(nonce));
+    CHECK(secp256k1_sign_pool_add_nonce(CTX, pool, nonce) == 0);
+    random_scalar_order_b32(nonce);
+    CHECK_ILLEGAL(STATIC_CTX, secp256k1_sign_pool_add_nonce(STATIC_CTX, pool, nonce));
+    CHECK(secp256k1_sign_pool_add_nonce(CTX, pool, nonce) == 1);
+    CHECK(secp256k1_sign_pool_size(CTX, pool) == 1);
+    CHECK(secp256k1_ecdsa_sign_pool(CTX, &sig, msg, key, pool) == 1);
+    CHECK(secp256k1_ecdsa_sign(CTX, &sig2, msg, key, precomputed_nonce_function, nonce) == 1);
+    CHECK(secp256k1_memcmp_var(&sig, &sig2, sizeof(sig)) == 0);
+
+    /* An invalid secret key uses up a nonce. */
+    CHECK(secp256k1_sign_pool_add_nonce(CTX, pool, nonce) == 1);
+    memset(key, 0, sizeof(key));
+    CHECK(secp256k1_ecdsa_sign_pool(CTX, &sig, msg, key, pool) == 0);
+    CHECK(secp256k1_sign_pool_size(CTX, pool) == 0);
+
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_sign_pool(CTX, &sig, msg, key, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_sign_pool_size(CTX, NULL));
+    secp256k1_sign_pool_destroy(CTX, pool);
+    secp256k1_sign_pool_destroy(CTX, NULL);
+}
+
+static void run_ecdsa_sign_signer(void) {
+    unsigned char key[32], msg[32], ndata[32];
+    secp256k1_ecdsa_signature sig, sig2;
+    secp256k1_signer *signer;
+    int i;
+
+    random_scalar_order_b32(key);
+    signer = secp256k1_signer_create(CTX, key);
+    CHECK(signer != NULL);
+    /* The signatures are the same as with the default nonce function. */
+    for (i = 0; i < COUNT; i++) {
+        secp256k1_testrand256(msg);
+        secp256k1_testrand256(ndata);
+        CHECK(secp256k1_ecdsa_sign_signer(CTX, &sig, msg, signer, NULL) == 1);
+        CHECK(secp256k1_ecdsa_sign(CTX, &sig2, msg, key, NULL, NULL) == 1);
+        CHECK(secp256k1_memcmp_var(&sig, &sig2, sizeof(sig)) == 0);
+        CHECK(secp256k1_ecdsa_sign_signer(CTX, &sig, msg, signer, ndata) == 1);
+        CHECK(secp256k1_ecdsa_sign(CTX, &sig2, msg, key, NULL, ndata) == 1);
+        CHECK(secp256k1_memcmp_var(&sig, &sig2, sizeof(sig)) == 0);
+    }
+
+    CHECK_ILLEGAL(STATIC_CTX, secp256k1_ecdsa_sign_signer(STATIC_CTX, &sig, msg, signer, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_sign_signer(CTX, &sig, msg, NULL, NULL));
+    CHECK_ILLEGAL(CTX, secp256k1_ecdsa_sign_signer(CTX, NULL, msg, signer, NULL));
+    secp256k1_signer_destroy(CTX, signer);
+    secp256k1_signer_destroy(CTX, NULL);
+
+    /* Invalid secret keys are rejected. */
+    CHECK_ILLEGAL(STATIC_CTX, secp256k1_signer_create(STATIC_CTX, key));
+    memset(key, 0, sizeof(key));
+    CHECK(secp256k1_signer_create(CTX, key) == NULL);
+    memset(key, 0xff, sizeof(key));
+    CHECK(secp256k1_signer_create(CTX, key) == NULL);
+}
+
 static int nonce_function_test_fail(unsigned char *nonce32, const unsigned char *msg32, const unsigned char *key32, const unsigned char *algo16, void *data, unsigned int counter) {
    /* Dummy nonce generator that has a fatal error on the first counter value. */
    if (counter == 0) {
@@ -6466,6 +7850,9 @@ static void test_ecdsa_end_to_end(void) {
     secp256k1_pubkey pubkey_tmp;
     unsigned char seckey[300];
     size_t seckeylen = 300;
+    secp256k1_pubkey_prepared *prepared;
+    unsigned char flip_byte;
+    int i, flip_idx;
 
     /* Generate a random key and message. */
     {
@@ -6566,6 +7953,18 @@ static void test_ecdsa_end_to_end(void) {
     CHECK(secp256k1_ecdsa_verify(CTX, &signature[1], message, &pubkey) == 1);
     CHECK(secp256k1_ecdsa_verify(CTX, &signature[2], message, &pubkey) == 1);
     CHECK(secp256k1_ecdsa_verify(CTX, &signature[3], message, &pubkey) == 1);
+    /* Verify with a prepared public key. */
+    prepared = secp256k1_pubkey_prepared_create(CTX, &pubkey);
+    CHECK(prepared != NULL);
+    for (i = 0; i < 4; i++) {
+        CHECK(secp256k1_ecdsa_verify_prepared(CTX, &signature[i], message, prepared) == 1);
+    }
+    flip_idx = secp256k1_testrand_int(32);
+    flip_byte = 1 + secp256k1_testrand_int(255);
+    message[flip_idx] ^= flip_byte;
+    CHECK(secp256k1_ecdsa_verify_prepared(CTX, &signature[0], message, prepared) == 0);
+    message[flip_idx] ^= flip_byte;
+    secp256k1_pubkey_prepared_destroy(CTX, prepared);
     /* Test lower-S form, malleate, verify and fail, test again, malleate again */
     CHECK(!secp256k1_ecdsa_signature_normalize(CTX, NULL, &signature[0]));
     secp256k1_ecdsa_signature_load(CTX, &r, &s, &signature[0]);
@@ -7164,7 +8563,7 @@ static void test_ecdsa_edge_cases(void) {
         secp256k1_ecmult_gen(&CTX->ecmult_gen_ctx, &keyj, &sr);
         secp256k1_ge_set_gej(&key, &keyj);
         msg = ss;
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 0);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 0);
     }
 
     /* Verify signature with r of zero fails. */
@@ -7183,7 +8582,7 @@ static void test_ecdsa_edge_cases(void) {
         secp256k1_scalar_set_int(&msg, 0);
         secp256k1_scalar_set_int(&sr, 0);
         CHECK(secp256k1_eckey_pubkey_parse(&key, pubkey_mods_zero, 33));
-        CHECK(secp256k1_ecdsa_sig_verify( &sr, &ss, &key, &msg) == 0);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 0);
     }
 
     /* Verify signature with s of zero fails. */
@@ -7202,7 +8601,7 @@ static void test_ecdsa_edge_cases(void) {
         secp256k1_scalar_set_int(&msg, 0);
         secp256k1_scalar_set_int(&sr, 1);
         CHECK(secp256k1_eckey_pubkey_parse(&key, pubkey, 33));
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 0);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 0);
     }
 
     /* Verify signature with message 0 passes. */
@@ -7230,14 +8629,14 @@ static void test_ecdsa_edge_cases(void) {
         secp256k1_scalar_set_int(&sr, 2);
         CHECK(secp256k1_eckey_pubkey_parse(&key, pubkey, 33));
         CHECK(secp256k1_eckey_pubkey_parse(&key2, pubkey2, 33));
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 1);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key2, &msg) == 1);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 1);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key2, &msg) == 1);
         secp256k1_scalar_negate(&ss, &ss);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 1);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key2, &msg) == 1);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 1);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key2, &msg) == 1);
         secp256k1_scalar_set_int(&ss, 1);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 0);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key2, &msg) == 0);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 0);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key2, &msg) == 0);
     }
 
     /* Verify signature with message 1 passes. */
@@ -7271,15 +8670,15 @@ static void test_ecdsa_edge_cases(void) {
         secp256k1_scalar_set_b32(&sr, csr, NULL);
         CHECK(secp256k1_eckey_pubkey_parse(&key, pubkey, 33));
         CHECK(secp256k1_eckey_pubkey_parse(&key2, pubkey2, 33));
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 1);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key2, &msg) == 1);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 1);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key2, &msg) == 1);
         secp256k1_scalar_negate(&ss, &ss);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 1);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key2, &msg) == 1);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 1);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key2, &msg) == 1);
         secp256k1_scalar_set_int(&ss, 2);
         secp256k1_scalar_inverse_var(&ss, &ss);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 0);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key2, &msg) == 0);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 0);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key2, &msg) == 0);
     }
 
     /* Verify signature with message -1 passes. */
@@ -7305,12 +8704,12 @@ static void test_ecdsa_edge_cases(void) {
         secp256k1_scalar_negate(&msg, &msg);
         secp256k1_scalar_set_b32(&sr, csr, NULL);
         CHECK(secp256k1_eckey_pubkey_parse(&key, pubkey, 33));
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 1);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 1);
         secp256k1_scalar_negate(&ss, &ss);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 1);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 1);
         secp256k1_scalar_set_int(&ss, 3);
         secp256k1_scalar_inverse_var(&ss, &ss);
-        CHECK(secp256k1_ecdsa_sig_verify(&sr, &ss, &key, &msg) == 0);
+        CHECK(secp256k1_ecdsa_sig_verify(&CTX->ecmult_g, &sr, &ss, &key, &msg) == 0);
     }
 
     /* Signature where s would be zero. */
@@ -7547,6 +8946,10 @@ static void run_ecdsa_wycheproof(void) {
 # include "modules/ellswift/tests_impl.h"
 #endif
 
+#ifdef ENABLE_MODULE_BATCH
+# include "modules/batch/tests_impl.h"
+#endif
+
 static void run_secp256k1_memczero_test(void) {
     unsigned char buf1[6] = {1, 2, 3, 4, 5, 6};
     unsigned char buf2[sizeof(buf1)];
@@ -7803,6 +9206,8 @@ int main(int argc, char **argv) {
     run_proper_context_tests(0); run_proper_context_tests(1);
     run_static_context_tests(0); run_static_context_tests(1);
     run_deprecated_context_flags_test();
+    run_context_ecmult_tables_tests();
+    run_context_ecmult_gen_flags_tests();
 
     /* scratch tests */
     run_scratch_tests();
@@ -7821,9 +9226,12 @@ int main(int argc, char **argv) {
     /* hash tests */
     run_sha256_known_output_tests();
     run_sha256_counter_tests();
+    run_sha256_transform_tests();
+    run_sha256_x8_tests();
     run_hmac_sha256_tests();
     run_rfc6979_hmac_sha256_tests();
     run_tagged_sha256_tests();
+    run_tagged_hasher_tests();
 
     /* scalar tests */
     run_scalar_tests();
@@ -7835,11 +9243,17 @@ int main(int argc, char **argv) {
     run_field_be32_overflow();
     run_fe_mul();
     run_sqr();
+#ifdef SECP256K1_FE_X4
+    run_fe_x4();
+#endif
     run_sqrt();
 
     /* group tests */
     run_ge();
     run_gej();
+#ifdef SECP256K1_FE_X4
+    run_gej_x4();
+#endif
     run_group_decompress();
 
     /* ecmult tests */
@@ -7847,11 +9261,13 @@ int main(int argc, char **argv) {
     run_wnaf();
     run_point_times_order();
     run_ecmult_near_split_bound();
+    run_ecmult_prepared_tests();
     run_ecmult_chain();
     run_ecmult_constants();
     run_ecmult_gen_blind();
     run_ecmult_const_tests();
     run_ecmult_multi_tests();
+    run_ecmult_multi_pubkey_tests();
     run_ec_combine();
 
     /* endomorphism tests */
@@ -7862,6 +9278,8 @@ int main(int argc, char **argv) {
 
     /* EC key edge cases */
     run_eckey_edge_case_test();
+    run_ec_pubkey_create_batch_test();
+    run_ec_pubkey_create_sequence_test();
 
     /* EC key arithmetic test */
     run_eckey_negate_test();
@@ -7878,6 +9296,10 @@ int main(int argc, char **argv) {
     run_random_pubkeys();
     run_ecdsa_der_parse();
     run_ecdsa_sign_verify();
+    run_ecdsa_verify_prepared();
+    run_ecdsa_verify_batch();
+    run_ecdsa_sign_pool();
+    run_ecdsa_sign_signer();
     run_ecdsa_end_to_end();
     run_ecdsa_edge_cases();
     run_ecdsa_wycheproof();
@@ -7899,6 +9321,10 @@ int main(int argc, char **argv) {
     run_ellswift_tests();
 #endif
 
+#ifdef ENABLE_MODULE_BATCH
+    run_batch_tests();
+#endif
+
     /* util tests */
     run_secp256k1_memczero_test();
     run_secp256k1_byteorder_tests();